@@ -313,9 +313,13 @@ void AdBlockServiceTest::SetSubscriptionIntervals() {
 }
 
 void AdBlockServiceTest::WaitForAdBlockServiceThreads() {
-  scoped_refptr<base::ThreadTestHelper> tr_helper(new base::ThreadTestHelper(
-      g_brave_browser_process->ad_block_service()->GetTaskRunner()));
-  ASSERT_TRUE(tr_helper->Run());
+  // Run the engine sequence twice, since tag and resource changes can post a
+  // snapshot rebuild to it.
+  for (int i = 0; i < 2; ++i) {
+    scoped_refptr<base::ThreadTestHelper> tr_helper(new base::ThreadTestHelper(
+        g_brave_browser_process->ad_block_service()->GetTaskRunner()));
+    ASSERT_TRUE(tr_helper->Run());
+  }
 }
 
 void AdBlockServiceTest::ShieldsDown(const GURL& url) {
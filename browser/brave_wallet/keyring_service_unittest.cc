@@ -15,6 +15,7 @@
 #include "base/test/bind.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/test/values_test_util.h"
+#include "base/time/time.h"
 #include "brave/browser/brave_wallet/json_rpc_service_factory.h"
 #include "brave/components/brave_wallet/browser/blockchain_registry.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
@@ -4444,6 +4445,7 @@ TEST_F(KeyringServiceUnitTest, DevWalletPassword) {
   {
     cmdline->AppendSwitchASCII(switches::kDevWalletPassword, "some_password");
     KeyringService service(json_rpc_service(), GetPrefs(), GetLocalState());
+    task_environment_.RunUntilIdle();
     EXPECT_FALSE(service.IsLocked(mojom::kDefaultKeyringId));
     cmdline->RemoveSwitch(switches::kDevWalletPassword);
   }
@@ -4452,6 +4454,7 @@ TEST_F(KeyringServiceUnitTest, DevWalletPassword) {
   {
     cmdline->AppendSwitchASCII(switches::kDevWalletPassword, "wrong_password");
     KeyringService service(json_rpc_service(), GetPrefs(), GetLocalState());
+    task_environment_.RunUntilIdle();
     EXPECT_TRUE(service.IsLocked(mojom::kDefaultKeyringId));
     cmdline->RemoveSwitch(switches::kDevWalletPassword);
   }
@@ -4512,4 +4515,87 @@ TEST_F(KeyringServiceUnitTest, BitcoinReceiveChangeAddresses) {
             absl::nullopt);
 }
 
+// Unlocking a restored wallet with many accounts across ETH, SOL and FIL
+// derives the accounts as they were before locking.
+TEST_F(KeyringServiceUnitTest, UnlockWithManyAccounts) {
+  constexpr size_t kAccounts = 50;
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitWithFeatures(
+      {features::kBraveWalletFilecoinFeature,
+       features::kBraveWalletSolanaFeature},
+      {});
+
+  KeyringService service(json_rpc_service(), GetPrefs(), GetLocalState());
+  ASSERT_TRUE(RestoreWallet(&service, kMnemonic1, "brave", false));
+  while (service.GetAccountInfosForKeyring(mojom::kDefaultKeyringId).size() <
+         kAccounts) {
+    ASSERT_TRUE(AddAccount(&service, "ETH", mojom::CoinType::ETH));
+  }
+  while (service.GetAccountInfosForKeyring(mojom::kSolanaKeyringId).size() <
+         kAccounts) {
+    ASSERT_TRUE(AddAccount(&service, "SOL", mojom::CoinType::SOL));
+  }
+  while (service.GetAccountInfosForKeyring(mojom::kFilecoinKeyringId).size() <
+         kAccounts) {
+    ASSERT_TRUE(AddFilecoinAccount(&service, "FIL", mojom::kFilecoinMainnet));
+  }
+
+  const std::vector<std::string> keyring_ids = {mojom::kDefaultKeyringId,
+                                                mojom::kSolanaKeyringId,
+                                                mojom::kFilecoinKeyringId};
+  std::vector<std::vector<std::string>> addresses;
+  for (const auto& keyring_id : keyring_ids) {
+    addresses.push_back(service.GetHDKeyringById(keyring_id)->GetAccounts());
+    EXPECT_EQ(addresses.back().size(), kAccounts);
+  }
+
+  service.Lock();
+  ASSERT_TRUE(service.IsLockedSync());
+  ASSERT_TRUE(Unlock(&service, "brave"));
+
+  for (size_t i = 0; i < keyring_ids.size(); ++i) {
+    EXPECT_EQ(service.GetHDKeyringById(keyring_ids[i])->GetAccounts(),
+              addresses[i]);
+  }
+}
+
+// A second unlock while keys are being derived is rejected, and locking in
+// the meantime drops the derived keys. Every callback runs.
+TEST_F(KeyringServiceUnitTest, ConcurrentUnlockAndLock) {
+  KeyringService service(json_rpc_service(), GetPrefs(), GetLocalState());
+  ASSERT_TRUE(RestoreWallet(&service, kMnemonic1, "brave", false));
+  service.Lock();
+  ASSERT_TRUE(service.IsLockedSync());
+
+  absl::optional<bool> first_result;
+  absl::optional<bool> second_result;
+  base::RunLoop run_loop;
+  service.Unlock("brave", base::BindLambdaForTesting([&](bool success) {
+                   first_result = success;
+                   run_loop.Quit();
+                 }));
+  service.Unlock("brave", base::BindLambdaForTesting(
+                              [&](bool success) { second_result = success; }));
+  EXPECT_EQ(second_result, false);
+  run_loop.Run();
+  EXPECT_EQ(first_result, true);
+  EXPECT_FALSE(service.IsLockedSync());
+
+  service.Lock();
+  first_result.reset();
+  base::RunLoop locked_run_loop;
+  service.Unlock("brave", base::BindLambdaForTesting([&](bool success) {
+                   first_result = success;
+                   locked_run_loop.Quit();
+                 }));
+  service.Lock();
+  locked_run_loop.Run();
+  EXPECT_EQ(first_result, false);
+  EXPECT_TRUE(service.IsLockedSync());
+
+  // Unlocking works again afterwards.
+  EXPECT_TRUE(Unlock(&service, "brave"));
+  EXPECT_FALSE(service.IsLockedSync());
+}
+
 }  // namespace brave_wallet
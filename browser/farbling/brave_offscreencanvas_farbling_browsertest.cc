@@ -4,10 +4,15 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <memory>
+#include <string>
+#include <utility>
 
+#include "base/json/json_reader.h"
 #include "base/path_service.h"
 #include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/thread_test_helper.h"
+#include "base/values.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "brave/browser/extensions/brave_base_local_data_files_browsertest.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
@@ -25,6 +30,7 @@
 #include "content/public/test/browser_test.h"
 #include "content/public/test/browser_test_utils.h"
 #include "net/dns/mock_host_resolver.h"
+#include "third_party/blink/public/common/features.h"
 
 using brave_shields::ControlType;
 
@@ -33,6 +39,7 @@ const char kTitleScript[] = "domAutomationController.send(document.title);";
 const char kExpectedImageDataHashFarblingBalanced[] = "204";
 const char kExpectedImageDataHashFarblingOff[] = "0";
 const char kExpectedImageDataHashFarblingMaximum[] = "204";
+const char kGetImageData4KScript[] = "readBack();";
 
 class BraveOffscreenCanvasFarblingBrowserTest : public InProcessBrowserTest {
  public:
@@ -98,6 +105,21 @@ class BraveOffscreenCanvasFarblingBrowserTest : public InProcessBrowserTest {
     return WaitForLoadStop(contents());
   }
 
+  // Reads back a 4K canvas twice with the current fingerprinting setting and
+  // returns its checksum and whether both reads were identical.
+  base::Value::Dict GetImageData4K() {
+    GURL url = embedded_test_server()->GetURL(
+        "a.com", "/offscreen-getimagedata-4k.html");
+    NavigateToURLUntilLoadStop(url);
+    const std::string result =
+        content::EvalJs(contents(), kGetImageData4KScript)
+            .ExtractString();
+    absl::optional<base::Value> value = base::JSONReader::Read(result);
+    EXPECT_TRUE(value && value->is_dict()) << result;
+    return value && value->is_dict() ? std::move(value->GetDict())
+                                     : base::Value::Dict();
+  }
+
  private:
   GURL top_level_page_url_;
   std::unique_ptr<ChromeContentClient> content_client_;
@@ -171,3 +193,43 @@ IN_PROC_BROWSER_TEST_F(BraveOffscreenCanvasFarblingBrowserTest,
   EXPECT_EQ(ExecScriptGetStr(kTitleScript, contents()),
             kExpectedImageDataHashFarblingOff);
 }
+
+// Farbling changes the pixels of large canvases, and does so the same way on
+// every read.
+IN_PROC_BROWSER_TEST_F(BraveOffscreenCanvasFarblingBrowserTest,
+                       GetImageData4K) {
+  AllowFingerprinting();
+  const base::Value::Dict off = GetImageData4K();
+  SetFingerprintingDefault();
+  const base::Value::Dict on = GetImageData4K();
+
+  EXPECT_EQ(true, on.FindBool("stable"));
+  EXPECT_EQ(true, off.FindBool("stable"));
+  ASSERT_TRUE(on.FindDouble("checksum") && off.FindDouble("checksum"));
+  EXPECT_NE(*on.FindDouble("checksum"), *off.FindDouble("checksum"));
+}
+
+class BraveOffscreenCanvasFastFarblingBrowserTest
+    : public BraveOffscreenCanvasFarblingBrowserTest {
+ public:
+  BraveOffscreenCanvasFastFarblingBrowserTest() {
+    feature_list_.InitAndEnableFeature(
+        blink::features::kBraveFastCanvasFarbling);
+  }
+
+ private:
+  base::test::ScopedFeatureList feature_list_;
+};
+
+// The same as above, but keying large canvases with a digest of their pixels.
+IN_PROC_BROWSER_TEST_F(BraveOffscreenCanvasFastFarblingBrowserTest,
+                       GetImageData4K) {
+  AllowFingerprinting();
+  const base::Value::Dict off = GetImageData4K();
+  SetFingerprintingDefault();
+  const base::Value::Dict on = GetImageData4K();
+
+  EXPECT_EQ(true, on.FindBool("stable"));
+  ASSERT_TRUE(on.FindDouble("checksum") && off.FindDouble("checksum"));
+  EXPECT_NE(*on.FindDouble("checksum"), *off.FindDouble("checksum"));
+}
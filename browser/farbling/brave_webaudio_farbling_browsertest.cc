@@ -4,10 +4,14 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <memory>
+#include <string>
+#include <utility>
 
+#include "base/json/json_reader.h"
 #include "base/path_service.h"
 #include "base/strings/stringprintf.h"
 #include "base/test/thread_test_helper.h"
+#include "base/values.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "brave/browser/extensions/brave_base_local_data_files_browsertest.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
@@ -30,6 +34,7 @@ using brave_shields::ControlType;
 
 const char kEmbeddedTestServerDirectory[] = "webaudio";
 const char kTitleScript[] = "domAutomationController.send(document.title);";
+const char kLongBufferScript[] = "readLongBuffer(5, 20);";
 
 class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
  public:
@@ -56,6 +61,8 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
     farbling_url_ = embedded_test_server()->GetURL("a.com", "/farbling.html");
     copy_from_channel_url_ =
         embedded_test_server()->GetURL("a.com", "/copyFromChannel.html");
+    long_buffer_url_ =
+        embedded_test_server()->GetURL("a.com", "/long-buffer.html");
   }
 
   void TearDown() override {
@@ -67,6 +74,19 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
 
   const GURL& farbling_url() { return farbling_url_; }
 
+  // Reads a five minute AudioBuffer repeatedly with the current
+  // fingerprinting setting and returns the results of long-buffer.html.
+  base::Value::Dict ReadLongBuffer() {
+    NavigateToURLUntilLoadStop(long_buffer_url_);
+    const std::string result =
+        content::EvalJs(contents(), kLongBufferScript)
+            .ExtractString();
+    absl::optional<base::Value> value = base::JSONReader::Read(result);
+    EXPECT_TRUE(value && value->is_dict()) << result;
+    return value && value->is_dict() ? std::move(value->GetDict())
+                                     : base::Value::Dict();
+  }
+
   HostContentSettingsMap* content_settings() {
     return HostContentSettingsMapFactory::GetForProfile(browser()->profile());
   }
@@ -105,6 +125,7 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
  private:
   GURL top_level_page_url_;
   GURL copy_from_channel_url_;
+  GURL long_buffer_url_;
   GURL farbling_url_;
   std::unique_ptr<ChromeContentClient> content_client_;
   std::unique_ptr<BraveContentBrowserClient> browser_content_client_;
@@ -142,3 +163,26 @@ IN_PROC_BROWSER_TEST_F(BraveWebAudioFarblingBrowserTest, FarbleWebAudio) {
   NavigateToURLUntilLoadStop(farbling_url());
   EXPECT_EQ(ExecScriptGetStr(kTitleScript, contents()), "8000");
 }
+
+// Checks that reading an AudioBuffer channel repeatedly farbles it once, and
+// that samples written to it afterwards are farbled too.
+IN_PROC_BROWSER_TEST_F(BraveWebAudioFarblingBrowserTest,
+                       FarbleLongBufferOnce) {
+  AllowFingerprinting();
+  const base::Value::Dict off = ReadLongBuffer();
+  EXPECT_EQ(0.5, off.FindDouble("value"));
+  EXPECT_EQ(0.25, off.FindDouble("rewritten"));
+
+  SetFingerprintingDefault();
+  const base::Value::Dict balanced = ReadLongBuffer();
+  EXPECT_NE(0.5, balanced.FindDouble("value"));
+  EXPECT_EQ(true, balanced.FindBool("stable"));
+  EXPECT_EQ(true, balanced.FindBool("copyMatches"));
+  EXPECT_NE(0.25, balanced.FindDouble("rewritten"));
+
+  BlockFingerprinting();
+  const base::Value::Dict maximum = ReadLongBuffer();
+  EXPECT_EQ(true, maximum.FindBool("stable"));
+  EXPECT_EQ(true, maximum.FindBool("copyMatches"));
+  EXPECT_NE(0.25, maximum.FindDouble("rewritten"));
+}
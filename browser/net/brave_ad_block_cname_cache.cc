@@ -0,0 +1,142 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+const void* const kAdBlockCnameCacheUserDataKey =
+    &kAdBlockCnameCacheUserDataKey;
+
+}  // namespace
+
+AdBlockCnameCache::AdBlockCnameCache()
+    : entries_(kMaxEntries), uncloaked_hosts_(kMaxSites) {}
+
+AdBlockCnameCache::~AdBlockCnameCache() = default;
+
+// static
+AdBlockCnameCache* AdBlockCnameCache::FromBrowserContext(
+    content::BrowserContext* browser_context) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto* cache = static_cast<AdBlockCnameCache*>(
+      browser_context->GetUserData(kAdBlockCnameCacheUserDataKey));
+  if (!cache) {
+    auto new_cache = std::make_unique<AdBlockCnameCache>();
+    cache = new_cache.get();
+    browser_context->SetUserData(kAdBlockCnameCacheUserDataKey,
+                                 std::move(new_cache));
+  }
+  return cache;
+}
+
+// static
+std::string AdBlockCnameCache::GetSite(const GURL& tab_url) {
+  std::string site = net::registry_controlled_domains::GetDomainAndRegistry(
+      tab_url, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  return site.empty() ? tab_url.host() : site;
+}
+
+AdBlockCnameCache::LookupResult AdBlockCnameCache::Lookup(
+    const std::string& site,
+    const std::string& host,
+    ResolveCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  Key key(site, host);
+  if (absl::optional<std::string> canonical_name = GetFresh(key)) {
+    hits_++;
+    std::move(callback).Run(std::move(canonical_name));
+    return LookupResult::kHit;
+  }
+
+  auto it = pending_.find(key);
+  if (it != pending_.end()) {
+    hits_++;
+    it->second.push_back(std::move(callback));
+    return LookupResult::kPending;
+  }
+
+  misses_++;
+  pending_[std::move(key)].push_back(std::move(callback));
+  return LookupResult::kMiss;
+}
+
+bool AdBlockCnameCache::StartSpeculativeResolution(const std::string& site,
+                                                   const std::string& host) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  Key key(site, host);
+  if (GetFresh(key) || pending_.count(key)) {
+    return false;
+  }
+  pending_[std::move(key)];
+  return true;
+}
+
+void AdBlockCnameCache::OnResolved(const std::string& site,
+                                   const std::string& host,
+                                   absl::optional<std::string> canonical_name) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  Key key(site, host);
+  if (canonical_name) {
+    const base::TimeTicks expiry = base::TimeTicks::Now() + kEntryLifetime;
+    entries_.Put(key, Entry{*canonical_name, expiry});
+  }
+
+  auto it = pending_.find(key);
+  if (it == pending_.end()) {
+    return;
+  }
+  std::vector<ResolveCallback> callbacks = std::move(it->second);
+  pending_.erase(it);
+  for (auto& callback : callbacks) {
+    std::move(callback).Run(canonical_name);
+  }
+}
+
+void AdBlockCnameCache::AddUncloakedHost(const std::string& site,
+                                         const std::string& host) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto it = uncloaked_hosts_.Get(site);
+  if (it == uncloaked_hosts_.end()) {
+    it = uncloaked_hosts_.Put(site, base::flat_set<std::string>());
+  }
+  if (it->second.size() < kMaxHostsPerSite) {
+    it->second.insert(host);
+  }
+}
+
+std::vector<std::string> AdBlockCnameCache::GetUncloakedHosts(
+    const std::string& site) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto it = uncloaked_hosts_.Get(site);
+  if (it == uncloaked_hosts_.end()) {
+    return {};
+  }
+  return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
+absl::optional<std::string> AdBlockCnameCache::GetFresh(const Key& key) {
+  auto it = entries_.Get(key);
+  if (it == entries_.end()) {
+    return absl::nullopt;
+  }
+  if (it->second.expiry <= base::TimeTicks::Now()) {
+    entries_.Erase(it);
+    return absl::nullopt;
+  }
+  return it->second.canonical_name;
+}
+
+}  // namespace brave
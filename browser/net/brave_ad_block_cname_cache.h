@@ -0,0 +1,126 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
+#define BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/containers/lru_cache.h"
+#include "base/functional/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/supports_user_data.h"
+#include "base/time/time.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+class GURL;
+
+namespace content {
+class BrowserContext;
+}  // namespace content
+
+namespace brave {
+
+// Per-profile cache of the canonical names that CNAME uncloaking resolved,
+// partitioned by the site of the tab that made the request. Concurrent
+// lookups of a host that is being resolved wait for that resolution instead
+// of starting their own. It also remembers the hosts each site needed
+// uncloaked, so that they can be resolved ahead of time when the site is
+// navigated to again. Lives on the UI thread.
+class AdBlockCnameCache : public base::SupportsUserData::Data {
+ public:
+  // Receives the canonical name of a host, which is empty if the host has no
+  // CNAME record, or absl::nullopt if the host could not be resolved.
+  using ResolveCallback =
+      base::OnceCallback<void(absl::optional<std::string> canonical_name)>;
+
+  // The host resolver does not report record TTLs, so resolutions are only
+  // reused for a short time. The network service's own host cache, which
+  // does honor TTLs, still answers the repeated queries.
+  static constexpr base::TimeDelta kEntryLifetime = base::Minutes(1);
+  static constexpr size_t kMaxEntries = 1000;
+  static constexpr size_t kMaxSites = 100;
+  static constexpr size_t kMaxHostsPerSite = 32;
+
+  // Recorded in Brave.ShieldsCNAMEBlocking.CacheLookup. Do not renumber.
+  enum class LookupResult {
+    kHit = 0,
+    kPending = 1,
+    kMiss = 2,
+    kMaxValue = kMiss,
+  };
+
+  AdBlockCnameCache();
+  AdBlockCnameCache(const AdBlockCnameCache&) = delete;
+  AdBlockCnameCache& operator=(const AdBlockCnameCache&) = delete;
+  ~AdBlockCnameCache() override;
+
+  static AdBlockCnameCache* FromBrowserContext(
+      content::BrowserContext* browser_context);
+
+  // Returns the site that |tab_url|'s lookups are partitioned by.
+  static std::string GetSite(const GURL& tab_url);
+
+  // Looks up |host| for |site|. On a hit |callback| is run right away with
+  // the cached canonical name. Otherwise it is run once the resolution in
+  // flight completes; on kMiss the caller must start that resolution and
+  // report it with OnResolved().
+  LookupResult Lookup(const std::string& site,
+                      const std::string& host,
+                      ResolveCallback callback);
+
+  // Returns true, and marks a resolution as in flight, if |host| is neither
+  // cached nor being resolved for |site|. The caller must then resolve it and
+  // report it with OnResolved().
+  bool StartSpeculativeResolution(const std::string& site,
+                                  const std::string& host);
+
+  // Caches |canonical_name| unless the resolution failed, and runs the
+  // callbacks waiting for it.
+  void OnResolved(const std::string& site,
+                  const std::string& host,
+                  absl::optional<std::string> canonical_name);
+
+  // Remembers that |host| was uncloaked on |site|.
+  void AddUncloakedHost(const std::string& site, const std::string& host);
+  std::vector<std::string> GetUncloakedHosts(const std::string& site);
+
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+  base::WeakPtr<AdBlockCnameCache> GetWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+ private:
+  using Key = std::pair<std::string, std::string>;
+
+  struct Entry {
+    std::string canonical_name;
+    base::TimeTicks expiry;
+  };
+
+  // Returns the cached canonical name for |key| if it has not expired.
+  absl::optional<std::string> GetFresh(const Key& key);
+
+  base::LRUCache<Key, Entry> entries_;
+  std::map<Key, std::vector<ResolveCallback>> pending_;
+  base::LRUCache<std::string, base::flat_set<std::string>> uncloaked_hosts_;
+
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+
+  base::WeakPtrFactory<AdBlockCnameCache> weak_factory_{this};
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
@@ -0,0 +1,131 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+using LookupResult = AdBlockCnameCache::LookupResult;
+
+AdBlockCnameCache::ResolveCallback Store(
+    std::vector<absl::optional<std::string>>* results) {
+  return base::BindOnce(
+      [](std::vector<absl::optional<std::string>>* results,
+         absl::optional<std::string> canonical_name) {
+        results->push_back(std::move(canonical_name));
+      },
+      results);
+}
+
+}  // namespace
+
+class AdBlockCnameCacheTest : public testing::Test {
+ protected:
+  content::BrowserTaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  AdBlockCnameCache cache_;
+};
+
+TEST_F(AdBlockCnameCacheTest, ConcurrentLookupsShareOneResolution) {
+  std::vector<absl::optional<std::string>> results;
+  EXPECT_EQ(LookupResult::kMiss,
+            cache_.Lookup("a.com", "t.a.com", Store(&results)));
+  EXPECT_EQ(LookupResult::kPending,
+            cache_.Lookup("a.com", "t.a.com", Store(&results)));
+  EXPECT_TRUE(results.empty());
+
+  cache_.OnResolved("a.com", "t.a.com", "tracker.net");
+  EXPECT_EQ(2u, results.size());
+  EXPECT_EQ("tracker.net", results[0]);
+  EXPECT_EQ("tracker.net", results[1]);
+
+  EXPECT_EQ(LookupResult::kHit,
+            cache_.Lookup("a.com", "t.a.com", Store(&results)));
+  EXPECT_EQ(3u, results.size());
+  EXPECT_EQ("tracker.net", results[2]);
+  EXPECT_EQ(2u, cache_.hits());
+  EXPECT_EQ(1u, cache_.misses());
+}
+
+TEST_F(AdBlockCnameCacheTest, EntriesExpire) {
+  std::vector<absl::optional<std::string>> results;
+  cache_.Lookup("a.com", "t.a.com", Store(&results));
+  cache_.OnResolved("a.com", "t.a.com", "");
+
+  task_environment_.FastForwardBy(AdBlockCnameCache::kEntryLifetime / 2);
+  EXPECT_EQ(LookupResult::kHit,
+            cache_.Lookup("a.com", "t.a.com", Store(&results)));
+  EXPECT_EQ("", results.back());
+
+  task_environment_.FastForwardBy(AdBlockCnameCache::kEntryLifetime / 2);
+  EXPECT_EQ(LookupResult::kMiss,
+            cache_.Lookup("a.com", "t.a.com", Store(&results)));
+}
+
+TEST_F(AdBlockCnameCacheTest, FailuresAreNotCached) {
+  std::vector<absl::optional<std::string>> results;
+  cache_.Lookup("a.com", "t.a.com", Store(&results));
+  cache_.OnResolved("a.com", "t.a.com", absl::nullopt);
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(absl::nullopt, results[0]);
+
+  EXPECT_EQ(LookupResult::kMiss,
+            cache_.Lookup("a.com", "t.a.com", Store(&results)));
+}
+
+TEST_F(AdBlockCnameCacheTest, PartitionedBySite) {
+  std::vector<absl::optional<std::string>> results;
+  cache_.Lookup("a.com", "t.c.com", Store(&results));
+  cache_.OnResolved("a.com", "t.c.com", "tracker.net");
+
+  EXPECT_EQ(LookupResult::kMiss,
+            cache_.Lookup("b.com", "t.c.com", Store(&results)));
+  EXPECT_EQ("a.com", AdBlockCnameCache::GetSite(GURL("https://www.a.com/x")));
+  EXPECT_EQ("127.0.0.1", AdBlockCnameCache::GetSite(GURL("http://127.0.0.1/")));
+}
+
+TEST_F(AdBlockCnameCacheTest, SpeculativeResolution) {
+  cache_.AddUncloakedHost("a.com", "t1.a.com");
+  cache_.AddUncloakedHost("a.com", "t2.a.com");
+  cache_.AddUncloakedHost("a.com", "t1.a.com");
+  EXPECT_EQ(std::vector<std::string>({"t1.a.com", "t2.a.com"}),
+            cache_.GetUncloakedHosts("a.com"));
+  EXPECT_TRUE(cache_.GetUncloakedHosts("b.com").empty());
+
+  EXPECT_TRUE(cache_.StartSpeculativeResolution("a.com", "t1.a.com"));
+  EXPECT_FALSE(cache_.StartSpeculativeResolution("a.com", "t1.a.com"));
+
+  // A request made while the speculative resolution is in flight waits for
+  // it.
+  std::vector<absl::optional<std::string>> results;
+  EXPECT_EQ(LookupResult::kPending,
+            cache_.Lookup("a.com", "t1.a.com", Store(&results)));
+  cache_.OnResolved("a.com", "t1.a.com", "tracker.net");
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ("tracker.net", results[0]);
+
+  EXPECT_FALSE(cache_.StartSpeculativeResolution("a.com", "t1.a.com"));
+}
+
+TEST_F(AdBlockCnameCacheTest, HostsPerSiteAreBounded) {
+  for (size_t i = 0; i < 2 * AdBlockCnameCache::kMaxHostsPerSite; ++i) {
+    cache_.AddUncloakedHost("a.com", "t" + std::to_string(i) + ".a.com");
+  }
+  EXPECT_EQ(AdBlockCnameCache::kMaxHostsPerSite,
+            cache_.GetUncloakedHosts("a.com").size());
+}
+
+}  // namespace brave
@@ -88,7 +88,7 @@ int OnHeadersReceived_AdBlockCspWork(
     (*override_response_headers)->RemoveHeader("Content-Security-Policy");
 
     g_brave_browser_process->ad_block_service()
-        ->GetTaskRunner()
+        ->GetMatchingTaskRunner()
         ->PostTaskAndReplyWithResult(
             FROM_HERE,
             base::BindOnce(&GetCspDirectivesOnTaskRunner, ctx, original_csp),
@@ -15,28 +15,34 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/no_destructor.h"
 #include "base/strings/string_util.h"
+#include "base/task/task_runner.h"
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/brave_shields/ad_block_pref_service_factory.h"
 #include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/components/brave_shields/browser/ad_block_pref_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/brave_shields/common/features.h"
 #include "brave/components/constants/network_constants.h"
 #include "brave/components/constants/url_constants.h"
 #include "brave/grit/brave_generated_resources.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
 #include "chrome/browser/net/secure_dns_config.h"
 #include "chrome/browser/net/system_network_context_manager.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/navigation_handle.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/storage_partition.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/common/url_constants.h"
 #include "extensions/common/url_pattern.h"
 #include "mojo/public/cpp/bindings/remote.h"
+#include "net/base/isolation_info.h"
 #include "net/dns/public/dns_query_type.h"
 #include "services/network/host_resolver.h"
 #include "services/network/network_context.h"
@@ -70,29 +76,22 @@ struct EngineFlags {
   bool did_match_important = false;
 };
 
-void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
-                    const ResponseCallback& next_callback,
-                    std::shared_ptr<BraveRequestInfo> ctx,
-                    EngineFlags previous_result,
-                    absl::optional<std::string> cname);
-
 class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
  private:
   mojo::Receiver<network::mojom::ResolveHostClient> receiver_{this};
-  base::OnceCallback<void(absl::optional<std::string>)> cb_;
+  AdBlockCnameCache::ResolveCallback cb_;
   base::TimeTicks start_time_;
 
  public:
+  // Resolves |host_port_pair| through |network_context|, or fails if it is
+  // null.
   AdblockCnameResolveHostClient(
-      const ResponseCallback& next_callback,
-      scoped_refptr<base::SequencedTaskRunner> task_runner,
-      std::shared_ptr<BraveRequestInfo> ctx,
-      EngineFlags previous_result) {
+      const net::HostPortPair& host_port_pair,
+      const net::NetworkAnonymizationKey& network_anonymization_key,
+      network::mojom::NetworkContext* network_context,
+      AdBlockCnameCache::ResolveCallback cb)
+      : cb_(std::move(cb)) {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-    cb_ = base::BindOnce(&UseCnameResult, task_runner, std::move(next_callback),
-                         ctx, previous_result);
-
-    const auto network_anonymization_key = ctx->network_anonymization_key;
 
     network::mojom::ResolveHostParametersPtr optional_parameters =
         network::mojom::ResolveHostParameters::New();
@@ -112,28 +111,18 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
 
     if (g_testing_host_resolver) {
       g_testing_host_resolver->ResolveHost(
-          network::mojom::HostResolverHost::NewHostPortPair(
-              net::HostPortPair::FromURL(ctx->request_url)),
+          network::mojom::HostResolverHost::NewHostPortPair(host_port_pair),
           network_anonymization_key, std::move(optional_parameters),
           receiver_.BindNewPipeAndPassRemote());
     } else {
-      auto* web_contents =
-          content::WebContents::FromFrameTreeNodeId(ctx->frame_tree_node_id);
-      if (!web_contents) {
-        start_time_ = base::TimeTicks::Now();
+      if (!network_context) {
         this->OnComplete(net::ERR_FAILED, net::ResolveErrorInfo(),
                          absl::nullopt, absl::nullopt);
         return;
       }
 
-      network::mojom::NetworkContext* network_context =
-          web_contents->GetBrowserContext()
-              ->GetDefaultStoragePartition()
-              ->GetNetworkContext();
-
       network_context->ResolveHost(
-          network::mojom::HostResolverHost::NewHostPortPair(
-              net::HostPortPair::FromURL(ctx->request_url)),
+          network::mojom::HostResolverHost::NewHostPortPair(host_port_pair),
           network_anonymization_key, std::move(optional_parameters),
           receiver_.BindNewPipeAndPassRemote());
     }
@@ -222,9 +211,52 @@ EngineFlags ShouldBlockRequestOnTaskRunner(
   return previous_result;
 }
 
+void UseCnameResult(scoped_refptr<base::TaskRunner> task_runner,
+                    const ResponseCallback& next_callback,
+                    std::shared_ptr<BraveRequestInfo> ctx,
+                    EngineFlags previous_result,
+                    base::TimeTicks start_time,
+                    absl::optional<std::string> cname);
+
+network::mojom::NetworkContext* GetNetworkContextForRequest(
+    const BraveRequestInfo& ctx) {
+  auto* web_contents =
+      content::WebContents::FromFrameTreeNodeId(ctx.frame_tree_node_id);
+  if (!web_contents)
+    return nullptr;
+  return web_contents->GetBrowserContext()
+      ->GetDefaultStoragePartition()
+      ->GetNetworkContext();
+}
+
+// Runs `callback` with the canonical name of the request's host, reusing an
+// earlier or in-flight resolution of it for the same site if there is one.
+void ResolveCnameForRequest(std::shared_ptr<BraveRequestInfo> ctx,
+                            AdBlockCnameCache::ResolveCallback callback) {
+  DCHECK(ctx->browser_context);
+  auto* cache = AdBlockCnameCache::FromBrowserContext(ctx->browser_context);
+  const std::string site = AdBlockCnameCache::GetSite(
+      ctx->tab_origin.is_empty() ? ctx->initiator_url : ctx->tab_origin);
+  const std::string host = ctx->request_url.host();
+  cache->AddUncloakedHost(site, host);
+
+  const AdBlockCnameCache::LookupResult lookup =
+      cache->Lookup(site, host, std::move(callback));
+  UMA_HISTOGRAM_ENUMERATION("Brave.ShieldsCNAMEBlocking.CacheLookup", lookup);
+  if (lookup != AdBlockCnameCache::LookupResult::kMiss)
+    return;
+
+  // This will be deleted by `AdblockCnameResolveHostClient::OnComplete`.
+  new AdblockCnameResolveHostClient(
+      net::HostPortPair::FromURL(ctx->request_url),
+      ctx->network_anonymization_key, GetNetworkContextForRequest(*ctx),
+      base::BindOnce(&AdBlockCnameCache::OnResolved, cache->GetWeakPtr(),
+                     site, host));
+}
+
 void OnShouldBlockRequestResult(
     bool then_check_uncloaked,
-    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    scoped_refptr<base::TaskRunner> task_runner,
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx,
     EngineFlags result) {
@@ -233,20 +265,25 @@ void OnShouldBlockRequestResult(
     brave_shields::BraveShieldsWebContentsObserver::DispatchBlockedEvent(
         ctx->request_url, ctx->frame_tree_node_id, brave_shields::kAds);
   } else if (then_check_uncloaked) {
-    // This will be deleted by `AdblockCnameResolveHostClient::OnComplete`.
-    new AdblockCnameResolveHostClient(std::move(next_callback), task_runner,
-                                      ctx, result);
+    ResolveCnameForRequest(
+        ctx, base::BindOnce(&UseCnameResult, task_runner, next_callback, ctx,
+                            result, base::TimeTicks::Now()));
     return;
   }
   next_callback.Run();
 }
 
-void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
+void UseCnameResult(scoped_refptr<base::TaskRunner> task_runner,
                     const ResponseCallback& next_callback,
                     std::shared_ptr<BraveRequestInfo> ctx,
                     EngineFlags previous_result,
+                    base::TimeTicks start_time,
                     absl::optional<std::string> cname) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Time the request was held up for uncloaking, which is close to zero when
+  // the canonical name was cached.
+  UMA_HISTOGRAM_TIMES("Brave.ShieldsCNAMEBlocking.AddedLatency",
+                      base::TimeTicks::Now() - start_time);
 
   if (cname.has_value() && ctx->request_url.host() != *cname &&
       !cname->empty()) {
@@ -311,16 +348,7 @@ bool ProxySettingsAllowUncloaking(content::BrowserContext* browser_context,
   return can_uncloak;
 }
 
-void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
-                                 std::shared_ptr<BraveRequestInfo> ctx) {
-  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-  DCHECK_NE(ctx->request_identifier, 0UL);
-  DCHECK(!ctx->request_url.is_empty());
-  DCHECK(!ctx->initiator_url.is_empty());
-
-  scoped_refptr<base::SequencedTaskRunner> task_runner =
-      g_brave_browser_process->ad_block_service()->GetTaskRunner();
-
+bool CanUncloakCnames(content::BrowserContext* browser_context) {
   SecureDnsConfig secure_dns_config =
       SystemNetworkContextManager::GetStubResolverConfigReader()
           ->GetSecureDnsConfiguration(false);
@@ -330,11 +358,23 @@ void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
   // DoH or standard DNS queries won't be routed through Tor, so we need to
   // skip it.
   // Also, skip CNAME uncloaking if there is currently a configured proxy.
-  bool should_check_uncloaked =
-      base::FeatureList::IsEnabled(
-          brave_shields::features::kBraveAdblockCnameUncloaking) &&
-      ctx->browser_context && !ctx->browser_context->IsTor() &&
-      ProxySettingsAllowUncloaking(ctx->browser_context, doh_enabled);
+  return base::FeatureList::IsEnabled(
+             brave_shields::features::kBraveAdblockCnameUncloaking) &&
+         browser_context && !browser_context->IsTor() &&
+         ProxySettingsAllowUncloaking(browser_context, doh_enabled);
+}
+
+void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
+                                 std::shared_ptr<BraveRequestInfo> ctx) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  DCHECK_NE(ctx->request_identifier, 0UL);
+  DCHECK(!ctx->request_url.is_empty());
+  DCHECK(!ctx->initiator_url.is_empty());
+
+  scoped_refptr<base::TaskRunner> task_runner =
+      g_brave_browser_process->ad_block_service()->GetMatchingTaskRunner();
+
+  bool should_check_uncloaked = CanUncloakCnames(ctx->browser_context);
 
   // When default 1p blocking is disabled, first-party requests should not be
   // CNAME uncloaked unless using aggressive blocking mode.
@@ -398,4 +438,50 @@ int OnBeforeURLRequest_AdBlockTPPreWork(const ResponseCallback& next_callback,
   return net::ERR_IO_PENDING;
 }
 
+void SpeculativelyResolveAdblockCnames(
+    content::NavigationHandle* navigation_handle) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!navigation_handle->IsInPrimaryMainFrame() ||
+      navigation_handle->IsSameDocument()) {
+    return;
+  }
+  const GURL& url = navigation_handle->GetURL();
+  if (!url.SchemeIsHTTPOrHTTPS()) {
+    return;
+  }
+  content::BrowserContext* browser_context =
+      navigation_handle->GetWebContents()->GetBrowserContext();
+  if (!CanUncloakCnames(browser_context)) {
+    return;
+  }
+  auto* map = HostContentSettingsMapFactory::GetForProfile(browser_context);
+  if (!brave_shields::GetBraveShieldsEnabled(map, url) ||
+      brave_shields::GetAdControlType(map, url) ==
+          brave_shields::ControlType::ALLOW) {
+    return;
+  }
+
+  auto* cache = AdBlockCnameCache::FromBrowserContext(browser_context);
+  const std::string site = AdBlockCnameCache::GetSite(url);
+  const url::Origin origin = url::Origin::Create(url);
+  const net::NetworkAnonymizationKey network_anonymization_key =
+      net::IsolationInfo::Create(net::IsolationInfo::RequestType::kOther,
+                                 origin, origin,
+                                 net::SiteForCookies::FromOrigin(origin))
+          .network_anonymization_key();
+  network::mojom::NetworkContext* network_context =
+      browser_context->GetDefaultStoragePartition()->GetNetworkContext();
+  for (const std::string& host : cache->GetUncloakedHosts(site)) {
+    if (!cache->StartSpeculativeResolution(site, host)) {
+      continue;
+    }
+    // This will be deleted by `AdblockCnameResolveHostClient::OnComplete`.
+    new AdblockCnameResolveHostClient(
+        net::HostPortPair(host, 0), network_anonymization_key,
+        network_context,
+        base::BindOnce(&AdBlockCnameCache::OnResolved, cache->GetWeakPtr(),
+                       site, host));
+  }
+}
+
 }  // namespace brave
@@ -10,6 +10,10 @@
 
 #include "brave/browser/net/url_context.h"
 
+namespace content {
+class NavigationHandle;
+}  // namespace content
+
 namespace network {
 class HostResolver;
 }  // namespace network
@@ -20,6 +24,12 @@ int OnBeforeURLRequest_AdBlockTPPreWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx);
 
+// Starts resolving the hosts that were CNAME uncloaked on the site being
+// navigated to the last time it was visited, so that its requests can be
+// checked without waiting for DNS.
+void SpeculativelyResolveAdblockCnames(
+    content::NavigationHandle* navigation_handle);
+
 // Be sure to reset this to `nullptr` when done testing to prevent future tests
 // from being affected.
 void SetAdblockCnameHostResolverForTesting(
@@ -6,13 +6,11 @@
 #include "brave/browser/net/brave_query_filter.h"
 
 #include <string>
-#include <vector>
 
 #include "base/containers/fixed_flat_map.h"
 #include "base/containers/fixed_flat_set.h"
 #include "base/strings/string_piece.h"
-#include "base/strings/string_split.h"
-#include "base/strings/string_util.h"
+#include "brave/components/query_filter/utils.h"
 #include "third_party/re2/src/re2/re2.h"
 #include "url/gurl.h"
 
@@ -74,49 +72,27 @@ static constexpr auto kScopedQueryStringTrackers =
         {"ref_url", "twitter.com"},
     });
 
-// Remove tracking query parameters from a GURL, leaving all
-// other parts untouched.
-absl::optional<std::string> StripQueryParameter(const base::StringPiece& query,
-                                                const std::string& spec) {
-  // We are using custom query string parsing code here. See
-  // https://github.com/brave/brave-core/pull/13726#discussion_r897712350
-  // for more information on why this approach was selected.
-  //
-  // Split query string by ampersands, remove tracking parameters,
-  // then join the remaining query parameters, untouched, back into
-  // a single query string.
-  const std::vector<base::StringPiece> input_kv_strings =
-      SplitStringPiece(query, "&", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
-  std::vector<base::StringPiece> output_kv_strings;
-  int disallowed_count = 0;
-  for (const auto& kv_string : input_kv_strings) {
-    const std::vector<base::StringPiece> pieces = SplitStringPiece(
-        kv_string, "=", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-    const base::StringPiece& key = pieces.empty() ? "" : pieces[0];
-    if (pieces.size() >= 2 &&
-        (kSimpleQueryStringTrackers.count(key) == 1 ||
-         (kScopedQueryStringTrackers.count(key) == 1 &&
-          GURL(spec).DomainIs(kScopedQueryStringTrackers.at(key).data())) ||
-         (kConditionalQueryStringTrackers.count(key) == 1 &&
-          !re2::RE2::PartialMatch(
-              spec, kConditionalQueryStringTrackers.at(key).data())))) {
-      ++disallowed_count;
-    } else {
-      output_kv_strings.push_back(kv_string);
-    }
+bool IsTracker(base::StringPiece key, const GURL& url) {
+  if (kSimpleQueryStringTrackers.count(key) == 1) {
+    return true;
   }
-  if (disallowed_count > 0) {
-    return base::JoinString(output_kv_strings, "&");
+  if (kScopedQueryStringTrackers.count(key) == 1 &&
+      url.DomainIs(kScopedQueryStringTrackers.at(key))) {
+    return true;
   }
-  return absl::nullopt;
+  return kConditionalQueryStringTrackers.count(key) == 1 &&
+         !re2::RE2::PartialMatch(
+             url.spec(), kConditionalQueryStringTrackers.at(key).data());
 }
 
 }  // namespace
 
 absl::optional<GURL> ApplyQueryFilter(const GURL& original_url) {
   const auto& query = original_url.query_piece();
-  const std::string& spec = original_url.spec();
-  const auto clean_query_value = StripQueryParameter(query, spec);
+  const auto clean_query_value = query_filter::StripQueryParameters(
+      query, [&original_url](base::StringPiece key) {
+        return IsTracker(key, original_url);
+      });
   if (!clean_query_value.has_value())
     return absl::nullopt;
   const auto& clean_query = clean_query_value.value();
@@ -73,6 +73,12 @@ BASE_FEATURE(kBraveBlockScreenFingerprinting,
              "BraveBlockScreenFingerprinting",
              base::FEATURE_DISABLED_BY_DEFAULT);
 
+// Derives the canvas farbling key of large canvases from a fast keyed digest
+// of their pixels instead of an HMAC over all of them.
+BASE_FEATURE(kBraveFastCanvasFarbling,
+             "BraveFastCanvasFarbling",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 // Enables protection against fingerprinting via high-resolution time stamps.
 BASE_FEATURE(kBraveRoundTimeStamps,
              "BraveRoundTimeStamps",
@@ -16,20 +16,16 @@
 #define BRAVE_AUDIOBUFFER_GETCHANNELDATA                                      \
   {                                                                           \
     NotShared<DOMFloat32Array> array = getChannelData(channel_index);         \
-    DOMFloat32Array* destination_array = array.Get();                         \
-    size_t len = destination_array->length();                                 \
-    if (len > 0) {                                                            \
-      if (ExecutionContext* context = ExecutionContext::From(script_state)) { \
-        float* destination = destination_array->Data();                       \
-        brave::BraveSessionCache::From(*context).FarbleAudioChannel(          \
-            destination, len);                                                \
-      }                                                                       \
+    if (ExecutionContext* context = ExecutionContext::From(script_state)) {   \
+      brave::BraveSessionCache::From(*context).FarbleAudioBufferChannel(      \
+          array.Get());                                                       \
     }                                                                         \
   }
 
 #define BRAVE_AUDIOBUFFER_COPYFROMCHANNEL                                    \
   if (ExecutionContext* context = ExecutionContext::From(script_state)) {    \
-    brave::BraveSessionCache::From(*context).FarbleAudioChannel(dst, count); \
+    brave::BraveSessionCache::From(*context).FarbleAudioBufferChannelCopy(   \
+        channel_data, dst, count);                                           \
   }
 
 #include "src/third_party/blink/renderer/modules/webaudio/audio_buffer.cc"
@@ -143,6 +143,18 @@ bool engine_deserialize(struct C_Engine* engine,
                         const char* data,
                         size_t data_size);
 
+/**
+ * Serializes the engine into a buffer that can later be passed to
+ * `engine_deserialize`, storing its size in `data_size`. Returns null on
+ * failure. The buffer must be freed with `engine_serialized_buffer_destroy`.
+ */
+uint8_t* engine_serialize(struct C_Engine* engine, size_t* data_size);
+
+/**
+ * Destroy a buffer returned by `engine_serialize`.
+ */
+void engine_serialized_buffer_destroy(uint8_t* data, size_t data_size);
+
 /**
  * Destroy a `Engine` once you are done with it.
  */
@@ -289,6 +289,36 @@ pub unsafe extern "C" fn engine_deserialize(
     ok
 }
 
+/// Serializes the engine into a buffer that can later be passed to `engine_deserialize`, storing
+/// its size in `data_size`. Returns null on failure. The buffer must be freed with
+/// `engine_serialized_buffer_destroy`.
+#[no_mangle]
+pub unsafe extern "C" fn engine_serialize(engine: *mut Engine, data_size: *mut size_t) -> *mut u8 {
+    assert!(!engine.is_null());
+    assert!(!data_size.is_null());
+    let engine = Box::leak(Box::from_raw(engine));
+    match engine.serialize_raw() {
+        Ok(data) => {
+            let data = data.into_boxed_slice();
+            *data_size = data.len();
+            Box::into_raw(data) as *mut u8
+        }
+        Err(_) => {
+            eprintln!("Error serializing adblock engine");
+            *data_size = 0;
+            ptr::null_mut()
+        }
+    }
+}
+
+/// Destroy a buffer returned by `engine_serialize`.
+#[no_mangle]
+pub unsafe extern "C" fn engine_serialized_buffer_destroy(data: *mut u8, data_size: size_t) {
+    if !data.is_null() {
+        drop(Box::from_raw(std::slice::from_raw_parts_mut(data, data_size)));
+    }
+}
+
 /// Destroy a `Engine` once you are done with it.
 #[no_mangle]
 pub unsafe extern "C" fn engine_destroy(engine: *mut Engine) {
@@ -134,6 +134,17 @@ bool Engine::deserialize(const char* data, size_t data_size) {
   return engine_deserialize(raw, data, data_size);
 }
 
+std::vector<unsigned char> Engine::serialize() {
+  size_t data_size = 0;
+  uint8_t* data = engine_serialize(raw, &data_size);
+  if (!data) {
+    return std::vector<unsigned char>();
+  }
+  std::vector<unsigned char> result(data, data + data_size);
+  engine_serialized_buffer_destroy(data, data_size);
+  return result;
+}
+
 void Engine::addTag(const std::string& tag) {
   engine_add_tag(raw, tag.c_str());
 }
@@ -59,6 +59,27 @@ void OnParseJsonIsolated(
 
 const unsigned int kRetriesCountOnNetworkChange = 1;
 
+// Returns the response headers of |loader|, with lowercase names, and sets
+// |response_code| when there is a response.
+base::flat_map<std::string, std::string> GetResponseHeaders(
+    const network::SimpleURLLoader* loader,
+    int* response_code) {
+  base::flat_map<std::string, std::string> headers;
+  if (!loader->ResponseInfo() || !loader->ResponseInfo()->headers) {
+    return headers;
+  }
+  auto headers_list = loader->ResponseInfo()->headers;
+  *response_code = headers_list->response_code();
+  size_t header_iter = 0;
+  std::string key;
+  std::string value;
+  while (headers_list->EnumerateHeaderLines(&header_iter, &key, &value)) {
+    key = base::ToLowerASCII(key);
+    headers[key] = value;
+  }
+  return headers;
+}
+
 }  // namespace
 
 APIRequestResult::APIRequestResult() = default;
@@ -140,6 +161,34 @@ APIRequestHelper::Ticket APIRequestHelper::Request(
   return iter;
 }
 
+APIRequestHelper::Ticket APIRequestHelper::RequestUnparsed(
+    const std::string& method,
+    const GURL& url,
+    const std::string& payload,
+    const std::string& payload_content_type,
+    bool auto_retry_on_network_change,
+    ResultCallback callback,
+    const base::flat_map<std::string, std::string>& headers,
+    size_t max_body_size /* = -1u */) {
+  auto iter = url_loaders_.insert(
+      url_loaders_.begin(),
+      CreateLoader(method, url, payload, payload_content_type,
+                   auto_retry_on_network_change,
+                   true /* allow_http_error_result*/, headers));
+  auto on_response =
+      base::BindOnce(&APIRequestHelper::OnUnparsedResponse,
+                     weak_ptr_factory_.GetWeakPtr(), iter, std::move(callback));
+  if (max_body_size == -1u) {
+    iter->get()->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
+        url_loader_factory_.get(), std::move(on_response));
+  } else {
+    iter->get()->DownloadToString(url_loader_factory_.get(),
+                                  std::move(on_response), max_body_size);
+  }
+
+  return iter;
+}
+
 APIRequestHelper::Ticket APIRequestHelper::Download(
     const GURL& url,
     const std::string& payload,
@@ -210,20 +259,7 @@ void APIRequestHelper::OnResponse(
   auto response_code = -1;
   auto error_code = loader->NetError();
   auto final_url = loader->GetFinalURL();
-  base::flat_map<std::string, std::string> headers;
-  if (loader->ResponseInfo()) {
-    auto headers_list = loader->ResponseInfo()->headers;
-    if (headers_list) {
-      response_code = headers_list->response_code();
-      size_t header_iter = 0;
-      std::string key;
-      std::string value;
-      while (headers_list->EnumerateHeaderLines(&header_iter, &key, &value)) {
-        key = base::ToLowerASCII(key);
-        headers[key] = value;
-      }
-    }
-  }
+  auto headers = GetResponseHeaders(loader, &response_code);
 
   url_loaders_.erase(iter);
   if (!response_body) {
@@ -249,6 +285,22 @@ void APIRequestHelper::OnResponse(
                      error_code, final_url, std::move(callback)));
 }
 
+void APIRequestHelper::OnUnparsedResponse(
+    SimpleURLLoaderList::iterator iter,
+    ResultCallback callback,
+    std::unique_ptr<std::string> response_body) {
+  auto* loader = iter->get();
+  auto response_code = -1;
+  auto error_code = loader->NetError();
+  auto final_url = loader->GetFinalURL();
+  auto headers = GetResponseHeaders(loader, &response_code);
+
+  url_loaders_.erase(iter);
+  std::move(callback).Run(APIRequestResult(
+      response_code, response_body ? std::move(*response_body) : "",
+      base::Value(), std::move(headers), error_code, final_url));
+}
+
 void APIRequestHelper::OnDownload(SimpleURLLoaderList::iterator iter,
                                   DownloadCallback callback,
                                   base::FilePath path) {
@@ -49,7 +49,7 @@ class APIRequestResult {
 
   // HTTP response code.
   int response_code() const { return response_code_; }
-  // Sanitized json response.
+  // Sanitized json response, or the raw body for RequestUnparsed.
   const std::string& body() const { return body_; }
   // `base::Value` of sanitized json response.
   const base::Value& value_body() const { return value_body_; }
@@ -104,6 +104,23 @@ class APIRequestHelper {
       size_t max_body_size = -1u,
       ResponseConversionCallback conversion_callback = base::NullCallback());
 
+  // Like Request, but the response body is not parsed. It is handed to
+  // |callback| as is in APIRequestResult::body(), and value_body() is none.
+  // This is for callers that read only the fields they need from large
+  // responses with a typed parser that is safe to run on untrusted input in
+  // this process, ex: the Rust parsers in //brave/components/json/rs, instead
+  // of having the whole body copied to the data decoder and turned into a
+  // base::Value tree. |max_body_size| is enforced while the body downloads.
+  Ticket RequestUnparsed(
+      const std::string& method,
+      const GURL& url,
+      const std::string& payload,
+      const std::string& payload_content_type,
+      bool auto_retry_on_network_change,
+      ResultCallback callback,
+      const base::flat_map<std::string, std::string>& headers = {},
+      size_t max_body_size = -1u);
+
   using DownloadCallback = base::OnceCallback<void(
       base::FilePath,
       const base::flat_map<std::string, std::string>& /*response_headers*/)>;
@@ -136,6 +153,9 @@ class APIRequestHelper {
                   ResultCallback callback,
                   ResponseConversionCallback conversion_callback,
                   const std::unique_ptr<std::string> response_body);
+  void OnUnparsedResponse(SimpleURLLoaderList::iterator iter,
+                          ResultCallback callback,
+                          std::unique_ptr<std::string> response_body);
   void OnDownload(SimpleURLLoaderList::iterator iter,
                   DownloadCallback callback,
                   base::FilePath path);
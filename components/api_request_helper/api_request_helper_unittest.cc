@@ -156,6 +156,36 @@ TEST_F(ApiRequestHelperUnitTest, RequestWithConversion) {
       base::BindOnce(&ConversionCallback, server_raw_response, absl::nullopt));
 }
 
+TEST_F(ApiRequestHelperUnitTest, UnparsedRequest) {
+  GURL network_url("http://localhost/");
+  const std::string server_raw_response =
+      "{\"id\":1,\"jsonrpc\":\"2.0\",\"result\":18446744073709551615}";
+  SetInterceptor("POST", network_url, server_raw_response);
+
+  // The body is handed over as is, without being parsed.
+  APIRequestResult expected_result(200, server_raw_response, base::Value(),
+                                   {{"content-type", "text/html"}}, net::OK,
+                                   network_url);
+  base::MockCallback<APIRequestHelper::ResultCallback> callback;
+  EXPECT_CALL(callback, Run(MatchesAPIRequestResult(&expected_result)));
+  api_request_helper_->RequestUnparsed("POST", network_url, "",
+                                       "application/json", false,
+                                       callback.Get());
+  base::RunLoop().RunUntilIdle();
+  testing::Mock::VerifyAndClearExpectations(&callback);
+
+  // Bodies over the size limit are dropped.
+  APIRequestResult too_large_result(200, "", base::Value(),
+                                    {{"content-type", "text/html"}},
+                                    net::ERR_INSUFFICIENT_RESOURCES,
+                                    network_url);
+  EXPECT_CALL(callback, Run(MatchesAPIRequestResult(&too_large_result)));
+  api_request_helper_->RequestUnparsed(
+      "POST", network_url, "", "application/json", false, callback.Get(), {},
+      server_raw_response.size() - 1);
+  base::RunLoop().RunUntilIdle();
+}
+
 TEST_F(ApiRequestHelperUnitTest, Is2XXResponseCode) {
   EXPECT_TRUE(
       APIRequestResult(200, {}, {}, {}, net::OK, GURL()).Is2XXResponseCode());
@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/body_sniffer/body_sniffer_buffer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+
+namespace body_sniffer {
+
+BodySnifferBuffer::BodySnifferBuffer() = default;
+
+BodySnifferBuffer::BodySnifferBuffer(std::string body) : size_(body.size()) {
+  if (!body.empty()) {
+    chunks_.push_back(std::move(body));
+  }
+}
+
+BodySnifferBuffer::~BodySnifferBuffer() = default;
+
+BodySnifferBuffer::BodySnifferBuffer(BodySnifferBuffer&& other) {
+  *this = std::move(other);
+}
+
+// Leaves |other| empty rather than with stale sizes, as loaders move their
+// buffer out and keep using the member.
+BodySnifferBuffer& BodySnifferBuffer::operator=(BodySnifferBuffer&& other) {
+  chunks_ = std::exchange(other.chunks_, {});
+  tail_capacity_ = std::exchange(other.tail_capacity_, 0);
+  size_ = std::exchange(other.size_, 0);
+  bytes_sent_ = std::exchange(other.bytes_sent_, 0);
+  send_chunk_index_ = std::exchange(other.send_chunk_index_, 0);
+  send_chunk_offset_ = std::exchange(other.send_chunk_offset_, 0);
+  bytes_copied_ = std::exchange(other.bytes_copied_, 0);
+  return *this;
+}
+
+MojoResult BodySnifferBuffer::ReadFrom(
+    const mojo::DataPipeConsumerHandle& consumer,
+    size_t max_bytes,
+    base::StringPiece* new_data) {
+  DCHECK_GT(max_bytes, 0u);
+  DCHECK_EQ(0u, bytes_sent_);
+
+  const void* buffer = nullptr;
+  uint32_t available = 0;
+  const MojoResult result = consumer.BeginReadData(
+      &buffer, &available, MOJO_BEGIN_READ_DATA_FLAG_NONE);
+  if (result != MOJO_RESULT_OK) {
+    return result;
+  }
+
+  if (tail_capacity_ == 0) {
+    chunks_.emplace_back();
+    chunks_.back().reserve(kChunkSize);
+    tail_capacity_ = kChunkSize;
+  }
+
+  // Appending within the reserved capacity never reallocates, so earlier
+  // |new_data| pieces stay valid.
+  const size_t bytes_to_read =
+      std::min({static_cast<size_t>(available), max_bytes, tail_capacity_});
+  std::string& tail = chunks_.back();
+  const size_t offset = tail.size();
+  tail.append(static_cast<const char*>(buffer), bytes_to_read);
+  consumer.EndReadData(static_cast<uint32_t>(bytes_to_read));
+
+  tail_capacity_ -= bytes_to_read;
+  size_ += bytes_to_read;
+  bytes_copied_ += bytes_to_read;
+  *new_data = base::StringPiece(tail).substr(offset);
+  return MOJO_RESULT_OK;
+}
+
+MojoResult BodySnifferBuffer::WriteTo(
+    const mojo::DataPipeProducerHandle& producer) {
+  while (send_chunk_index_ < chunks_.size()) {
+    std::string& chunk = chunks_[send_chunk_index_];
+    uint32_t bytes_written =
+        static_cast<uint32_t>(chunk.size() - send_chunk_offset_);
+    const MojoResult result =
+        producer.WriteData(chunk.data() + send_chunk_offset_, &bytes_written,
+                           MOJO_WRITE_DATA_FLAG_NONE);
+    if (result != MOJO_RESULT_OK) {
+      return result;
+    }
+
+    send_chunk_offset_ += bytes_written;
+    bytes_sent_ += bytes_written;
+    bytes_copied_ += bytes_written;
+    if (send_chunk_offset_ == chunk.size()) {
+      std::string().swap(chunk);
+      send_chunk_index_++;
+      send_chunk_offset_ = 0;
+    }
+  }
+  DCHECK(!HasUnsentData());
+  return MOJO_RESULT_OK;
+}
+
+std::string BodySnifferBuffer::ToString() const {
+  DCHECK_EQ(0u, bytes_sent_);
+  std::string result;
+  result.reserve(size_);
+  for (const auto& chunk : chunks_) {
+    result.append(chunk);
+  }
+  return result;
+}
+
+}  // namespace body_sniffer
@@ -0,0 +1,77 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BODY_SNIFFER_BODY_SNIFFER_BUFFER_H_
+#define BRAVE_COMPONENTS_BODY_SNIFFER_BODY_SNIFFER_BUFFER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+
+namespace body_sniffer {
+
+// Holds a response body while it is sniffed and then sends it on. The body is
+// kept in fixed-size chunks that are reserved up front, so bytes that were
+// already read are never reallocated or moved as the body grows, and they are
+// written to the destination pipe straight from the chunks they were read
+// into.
+class BodySnifferBuffer {
+ public:
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  BodySnifferBuffer();
+  // Takes ownership of |body| as a single chunk, e.g. for a rewritten body.
+  explicit BodySnifferBuffer(std::string body);
+  ~BodySnifferBuffer();
+
+  BodySnifferBuffer(BodySnifferBuffer&&);
+  BodySnifferBuffer& operator=(BodySnifferBuffer&&);
+
+  BodySnifferBuffer(const BodySnifferBuffer&) = delete;
+  BodySnifferBuffer& operator=(const BodySnifferBuffer&) = delete;
+
+  // Reads up to |max_bytes| from |consumer| using a two-phase read, so the
+  // data is copied once, from the pipe into the last chunk. On
+  // MOJO_RESULT_OK, |new_data| points at the bytes that were read, which stay
+  // valid until they are sent.
+  MojoResult ReadFrom(const mojo::DataPipeConsumerHandle& consumer,
+                      size_t max_bytes,
+                      base::StringPiece* new_data);
+
+  // Writes as much of the unsent data to |producer| as it accepts. Chunks are
+  // released once they have been sent. Returns MOJO_RESULT_OK once everything
+  // was sent, MOJO_RESULT_SHOULD_WAIT if the pipe is full and any other error
+  // from the pipe as is.
+  MojoResult WriteTo(const mojo::DataPipeProducerHandle& producer);
+
+  bool HasUnsentData() const { return bytes_sent_ < size_; }
+
+  // Copies the whole body into a single string. Only for use before sending.
+  std::string ToString() const;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Number of bytes copied into and out of the buffer so far.
+  size_t bytes_copied() const { return bytes_copied_; }
+
+ private:
+  std::vector<std::string> chunks_;
+  // Space left in the last chunk before a new one is needed.
+  size_t tail_capacity_ = 0;
+  size_t size_ = 0;
+
+  size_t bytes_sent_ = 0;
+  size_t send_chunk_index_ = 0;
+  size_t send_chunk_offset_ = 0;
+
+  size_t bytes_copied_ = 0;
+};
+
+}  // namespace body_sniffer
+
+#endif  // BRAVE_COMPONENTS_BODY_SNIFFER_BODY_SNIFFER_BUFFER_H_
@@ -0,0 +1,226 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/body_sniffer/body_sniffer_buffer.h"
+
+#include <string>
+
+#include "base/check_op.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "mojo/core/embedder/embedder.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace body_sniffer {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "BodySnifferBuffer.";
+// Time to read a document from the source pipe and forward it to the
+// destination pipe once it has been sniffed.
+constexpr char kMetricTimePerDocument[] = "time_per_document";
+// Bytes copied into and out of the buffer, counting reallocations.
+constexpr char kMetricBytesCopied[] = "bytes_copied";
+
+constexpr uint32_t kPipeCapacity = 64 * 1024;
+// Speedreader reads up to 65536 bytes at a time.
+constexpr size_t kReadSize = 65536;
+
+mojo::ScopedDataPipeConsumerHandle CreatePipe(
+    mojo::ScopedDataPipeProducerHandle* producer) {
+  MojoCreateDataPipeOptions options;
+  options.struct_size = sizeof(MojoCreateDataPipeOptions);
+  options.flags = MOJO_CREATE_DATA_PIPE_FLAG_NONE;
+  options.element_num_bytes = 1;
+  options.capacity_num_bytes = kPipeCapacity;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  CHECK_EQ(MOJO_RESULT_OK, mojo::CreateDataPipe(&options, *producer, consumer));
+  return consumer;
+}
+
+std::string MakeDocument(size_t size) {
+  std::string document;
+  document.reserve(size);
+  for (size_t i = 0; document.size() < size; ++i) {
+    document += "<p>paragraph " + base::NumberToString(i) + "</p>\n";
+  }
+  document.resize(size);
+  return document;
+}
+
+// The source and destination pipes of a sniffing loader. The source pipe is
+// fed |document| as it drains, and the destination pipe is drained as it
+// fills.
+class Pump {
+ public:
+  explicit Pump(const std::string& document) : document_(document) {
+    source_consumer_ = CreatePipe(&source_producer_);
+    destination_consumer_ = CreatePipe(&destination_producer_);
+  }
+
+  // Writes as much of the document as the source pipe accepts, closing it
+  // once everything has been written.
+  void Feed() {
+    if (!source_producer_.is_valid()) {
+      return;
+    }
+    uint32_t bytes = static_cast<uint32_t>(document_.size() - fed_);
+    if (bytes > 0 &&
+        source_producer_->WriteData(document_.data() + fed_, &bytes,
+                                    MOJO_WRITE_DATA_FLAG_NONE) ==
+            MOJO_RESULT_OK) {
+      fed_ += bytes;
+    }
+    if (fed_ == document_.size()) {
+      source_producer_.reset();
+    }
+  }
+
+  // Reads everything available from the destination pipe.
+  void Drain() {
+    char buffer[kPipeCapacity];
+    uint32_t bytes = sizeof(buffer);
+    while (destination_consumer_->ReadData(buffer, &bytes,
+                                           MOJO_READ_DATA_FLAG_NONE) ==
+           MOJO_RESULT_OK) {
+      drained_ += bytes;
+      bytes = sizeof(buffer);
+    }
+  }
+
+  void Finish() {
+    destination_producer_.reset();
+    Drain();
+  }
+
+  mojo::DataPipeConsumerHandle source() const {
+    return source_consumer_.get();
+  }
+  const mojo::ScopedDataPipeProducerHandle& destination() const {
+    return destination_producer_;
+  }
+  size_t drained() const { return drained_; }
+
+ private:
+  const std::string& document_;
+  size_t fed_ = 0;
+  size_t drained_ = 0;
+  mojo::ScopedDataPipeProducerHandle source_producer_;
+  mojo::ScopedDataPipeConsumerHandle source_consumer_;
+  mojo::ScopedDataPipeProducerHandle destination_producer_;
+  mojo::ScopedDataPipeConsumerHandle destination_consumer_;
+};
+
+// Buffers all of |document| in a BodySnifferBuffer, as a loader does while
+// sniffing, then forwards it. Returns the bytes copied.
+size_t PumpThroughBuffer(const std::string& document) {
+  Pump pump(document);
+  BodySnifferBuffer buffer;
+  MojoResult result = MOJO_RESULT_OK;
+  while (result != MOJO_RESULT_FAILED_PRECONDITION) {
+    pump.Feed();
+    base::StringPiece new_data;
+    do {
+      result = buffer.ReadFrom(pump.source(), kReadSize, &new_data);
+    } while (result == MOJO_RESULT_OK);
+  }
+  while (buffer.WriteTo(pump.destination().get()) == MOJO_RESULT_SHOULD_WAIT) {
+    pump.Drain();
+  }
+  pump.Finish();
+  EXPECT_EQ(document.size(), pump.drained());
+  return buffer.bytes_copied();
+}
+
+// Buffers |document| in a single growing string, as BodySnifferURLLoader used
+// to, and returns the bytes copied. Reallocations are counted as copies of
+// what was buffered so far.
+size_t PumpThroughString(const std::string& document) {
+  Pump pump(document);
+  std::string buffer;
+  size_t bytes_copied = 0;
+  MojoResult result = MOJO_RESULT_OK;
+  while (result != MOJO_RESULT_FAILED_PRECONDITION) {
+    pump.Feed();
+    do {
+      const size_t start_size = buffer.size();
+      const size_t capacity = buffer.capacity();
+      uint32_t bytes = static_cast<uint32_t>(kReadSize);
+      buffer.resize(start_size + bytes);
+      if (buffer.capacity() != capacity) {
+        bytes_copied += start_size;
+      }
+      result = pump.source().ReadData(&buffer[start_size], &bytes,
+                                      MOJO_READ_DATA_FLAG_NONE);
+      buffer.resize(start_size + (result == MOJO_RESULT_OK ? bytes : 0));
+      if (result == MOJO_RESULT_OK) {
+        bytes_copied += bytes;
+      }
+    } while (result == MOJO_RESULT_OK);
+  }
+  size_t sent = 0;
+  while (sent < buffer.size()) {
+    uint32_t bytes = static_cast<uint32_t>(buffer.size() - sent);
+    if (pump.destination()->WriteData(buffer.data() + sent, &bytes,
+                                      MOJO_WRITE_DATA_FLAG_NONE) ==
+        MOJO_RESULT_OK) {
+      sent += bytes;
+      bytes_copied += bytes;
+    }
+    pump.Drain();
+  }
+  pump.Finish();
+  EXPECT_EQ(document.size(), pump.drained());
+  return bytes_copied;
+}
+
+}  // namespace
+
+// Compares buffering and forwarding multi-megabyte documents with
+// BodySnifferBuffer against a single growing string.
+class BodySnifferBufferPerfTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() {
+    static bool mojo_initialized = false;
+    if (!mojo_initialized) {
+      mojo::core::Init();
+      mojo_initialized = true;
+    }
+  }
+
+ protected:
+  template <typename PumpFunction>
+  void Run(const std::string& story_prefix, PumpFunction pump_function) {
+    for (size_t megabytes : {1u, 4u, 16u}) {
+      const std::string document = MakeDocument(megabytes * 1024 * 1024);
+
+      const base::ElapsedTimer timer;
+      const size_t bytes_copied = pump_function(document);
+      const base::TimeDelta elapsed = timer.Elapsed();
+
+      perf_test::PerfResultReporter reporter(
+          kMetricPrefix,
+          story_prefix + "_" + base::NumberToString(megabytes) + "mb");
+      reporter.RegisterImportantMetric(kMetricTimePerDocument, "ms");
+      reporter.RegisterImportantMetric(kMetricBytesCopied, "bytes");
+      reporter.AddResult(kMetricTimePerDocument, elapsed);
+      reporter.AddResult(kMetricBytesCopied, bytes_copied);
+    }
+  }
+};
+
+TEST_F(BodySnifferBufferPerfTest, Chunks) {
+  Run("chunks", &PumpThroughBuffer);
+}
+
+TEST_F(BodySnifferBufferPerfTest, GrowingString) {
+  Run("growing_string", &PumpThroughString);
+}
+
+}  // namespace body_sniffer
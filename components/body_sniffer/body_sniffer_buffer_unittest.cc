@@ -0,0 +1,248 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/body_sniffer/body_sniffer_buffer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace body_sniffer {
+
+namespace {
+
+constexpr uint32_t kPipeCapacity = 64 * 1024;
+
+void CreatePipe(mojo::ScopedDataPipeProducerHandle* producer,
+                mojo::ScopedDataPipeConsumerHandle* consumer) {
+  MojoCreateDataPipeOptions options;
+  options.struct_size = sizeof(MojoCreateDataPipeOptions);
+  options.flags = MOJO_CREATE_DATA_PIPE_FLAG_NONE;
+  options.element_num_bytes = 1;
+  options.capacity_num_bytes = kPipeCapacity;
+  ASSERT_EQ(MOJO_RESULT_OK,
+            mojo::CreateDataPipe(&options, *producer, *consumer));
+}
+
+std::string MakeDocument(size_t size) {
+  std::string document;
+  document.reserve(size);
+  for (size_t i = 0; document.size() < size; ++i) {
+    document += "<p>paragraph " + std::to_string(i) + "</p>\n";
+  }
+  document.resize(size);
+  return document;
+}
+
+// Writes as much of |data| from |*offset| as |producer| accepts, closing the
+// pipe once everything has been written.
+void Feed(const std::string& data,
+          size_t* offset,
+          mojo::ScopedDataPipeProducerHandle* producer) {
+  if (!producer->is_valid()) {
+    return;
+  }
+  uint32_t bytes = static_cast<uint32_t>(data.size() - *offset);
+  if (bytes > 0 &&
+      (*producer)->WriteData(data.data() + *offset, &bytes,
+                             MOJO_WRITE_DATA_FLAG_NONE) == MOJO_RESULT_OK) {
+    *offset += bytes;
+  }
+  if (*offset == data.size()) {
+    producer->reset();
+  }
+}
+
+// Reads everything available from |consumer| into |output|.
+void Drain(const mojo::ScopedDataPipeConsumerHandle& consumer,
+           std::string* output) {
+  char buffer[kPipeCapacity];
+  uint32_t bytes = sizeof(buffer);
+  while (consumer->ReadData(buffer, &bytes, MOJO_READ_DATA_FLAG_NONE) ==
+         MOJO_RESULT_OK) {
+    output->append(buffer, bytes);
+    bytes = sizeof(buffer);
+  }
+}
+
+struct PumpStats {
+  std::string output;
+  size_t bytes_copied = 0;
+};
+
+// Pushes |document| through a source pipe into a BodySnifferBuffer and then
+// out through a destination pipe, as a sniffing loader does.
+PumpStats PumpThroughBuffer(const std::string& document, size_t read_size) {
+  PumpStats stats;
+  mojo::ScopedDataPipeProducerHandle source_producer;
+  mojo::ScopedDataPipeConsumerHandle source_consumer;
+  CreatePipe(&source_producer, &source_consumer);
+  mojo::ScopedDataPipeProducerHandle destination_producer;
+  mojo::ScopedDataPipeConsumerHandle destination_consumer;
+  CreatePipe(&destination_producer, &destination_consumer);
+
+  BodySnifferBuffer buffer;
+  size_t fed = 0;
+  for (;;) {
+    Feed(document, &fed, &source_producer);
+    base::StringPiece new_data;
+    MojoResult result;
+    while ((result = buffer.ReadFrom(source_consumer.get(), read_size,
+                                     &new_data)) == MOJO_RESULT_OK) {
+    }
+    if (result == MOJO_RESULT_FAILED_PRECONDITION) {
+      break;
+    }
+  }
+  while (buffer.WriteTo(destination_producer.get()) ==
+         MOJO_RESULT_SHOULD_WAIT) {
+    Drain(destination_consumer, &stats.output);
+  }
+  destination_producer.reset();
+  Drain(destination_consumer, &stats.output);
+  stats.bytes_copied = buffer.bytes_copied();
+  return stats;
+}
+
+// The same as above, but growing a single string as BodySnifferURLLoader used
+// to. Reallocations are counted as copies of what was buffered so far.
+PumpStats PumpThroughString(const std::string& document, size_t read_size) {
+  PumpStats stats;
+  mojo::ScopedDataPipeProducerHandle source_producer;
+  mojo::ScopedDataPipeConsumerHandle source_consumer;
+  CreatePipe(&source_producer, &source_consumer);
+  mojo::ScopedDataPipeProducerHandle destination_producer;
+  mojo::ScopedDataPipeConsumerHandle destination_consumer;
+  CreatePipe(&destination_producer, &destination_consumer);
+
+  std::string buffer;
+  size_t fed = 0;
+  for (;;) {
+    Feed(document, &fed, &source_producer);
+    MojoResult result;
+    do {
+      const size_t start_size = buffer.size();
+      const size_t capacity = buffer.capacity();
+      uint32_t bytes = static_cast<uint32_t>(read_size);
+      buffer.resize(start_size + bytes);
+      if (buffer.capacity() != capacity) {
+        stats.bytes_copied += start_size;
+      }
+      result = source_consumer->ReadData(&buffer[start_size], &bytes,
+                                         MOJO_READ_DATA_FLAG_NONE);
+      buffer.resize(start_size + (result == MOJO_RESULT_OK ? bytes : 0));
+      if (result == MOJO_RESULT_OK) {
+        stats.bytes_copied += bytes;
+      }
+    } while (result == MOJO_RESULT_OK);
+    if (result == MOJO_RESULT_FAILED_PRECONDITION) {
+      break;
+    }
+  }
+  size_t sent = 0;
+  while (sent < buffer.size()) {
+    uint32_t bytes = static_cast<uint32_t>(buffer.size() - sent);
+    if (destination_producer->WriteData(buffer.data() + sent, &bytes,
+                                        MOJO_WRITE_DATA_FLAG_NONE) ==
+        MOJO_RESULT_OK) {
+      sent += bytes;
+      stats.bytes_copied += bytes;
+    }
+    Drain(destination_consumer, &stats.output);
+  }
+  destination_producer.reset();
+  Drain(destination_consumer, &stats.output);
+  return stats;
+}
+
+}  // namespace
+
+TEST(BodySnifferBufferTest, ReadDataStaysInPlace) {
+  const std::string document = MakeDocument(3 * BodySnifferBuffer::kChunkSize);
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  CreatePipe(&producer, &consumer);
+
+  BodySnifferBuffer buffer;
+  std::vector<base::StringPiece> pieces;
+  size_t fed = 0;
+  MojoResult result = MOJO_RESULT_OK;
+  while (result != MOJO_RESULT_FAILED_PRECONDITION) {
+    Feed(document, &fed, &producer);
+    base::StringPiece new_data;
+    result = buffer.ReadFrom(consumer.get(), 1000, &new_data);
+    if (result == MOJO_RESULT_OK) {
+      EXPECT_LE(new_data.size(), 1000u);
+      pieces.push_back(new_data);
+    }
+  }
+
+  // Every piece still points at the bytes that were read into it.
+  std::string joined;
+  for (const auto& piece : pieces) {
+    joined.append(piece.data(), piece.size());
+  }
+  EXPECT_EQ(document, joined);
+  EXPECT_EQ(document.size(), buffer.size());
+  EXPECT_EQ(document, buffer.ToString());
+  EXPECT_EQ(document.size(), buffer.bytes_copied());
+}
+
+TEST(BodySnifferBufferTest, WritesWhenPipeDrains) {
+  const std::string document = MakeDocument(5 * kPipeCapacity / 2);
+  BodySnifferBuffer buffer(document);
+  EXPECT_TRUE(buffer.HasUnsentData());
+
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  CreatePipe(&producer, &consumer);
+
+  std::string output;
+  EXPECT_EQ(MOJO_RESULT_SHOULD_WAIT, buffer.WriteTo(producer.get()));
+  EXPECT_TRUE(buffer.HasUnsentData());
+  Drain(consumer, &output);
+  EXPECT_EQ(MOJO_RESULT_SHOULD_WAIT, buffer.WriteTo(producer.get()));
+  Drain(consumer, &output);
+  EXPECT_EQ(MOJO_RESULT_OK, buffer.WriteTo(producer.get()));
+  EXPECT_FALSE(buffer.HasUnsentData());
+  Drain(consumer, &output);
+  EXPECT_EQ(document, output);
+
+  consumer.reset();
+  BodySnifferBuffer closed(document);
+  EXPECT_EQ(MOJO_RESULT_FAILED_PRECONDITION, closed.WriteTo(producer.get()));
+}
+
+TEST(BodySnifferBufferTest, MoveLeavesSourceEmpty) {
+  BodySnifferBuffer buffer(MakeDocument(100));
+  BodySnifferBuffer moved = std::move(buffer);
+  EXPECT_EQ(100u, moved.size());
+  EXPECT_TRUE(buffer.empty());  // NOLINT(bugprone-use-after-move)
+  EXPECT_FALSE(buffer.HasUnsentData());
+}
+
+// Compares bytes copied to buffer and forward multi-megabyte documents with a
+// single growing string, as before, and with BodySnifferBuffer.
+TEST(BodySnifferBufferTest, CopiesLessThanGrowingString) {
+  // Speedreader reads up to 65536 bytes at a time.
+  constexpr size_t kReadSize = 65536;
+  for (size_t megabytes : {1u, 4u, 16u}) {
+    const std::string document = MakeDocument(megabytes * 1024 * 1024);
+
+    const PumpStats string_stats = PumpThroughString(document, kReadSize);
+    const PumpStats buffer_stats = PumpThroughBuffer(document, kReadSize);
+    EXPECT_EQ(document, string_stats.output);
+    EXPECT_EQ(document, buffer_stats.output);
+
+    // One copy in and one copy out.
+    EXPECT_EQ(2 * document.size(), buffer_stats.bytes_copied);
+    EXPECT_LT(buffer_stats.bytes_copied, string_stats.bytes_copied);
+  }
+}
+
+}  // namespace body_sniffer
@@ -155,22 +155,15 @@ void BodySnifferURLLoader::ResumeReadingBodyFromNet() {
   source_url_loader_->ResumeReadingBodyFromNet();
 }
 
-// Only returns true if MOJO_RESULT_OK
-bool BodySnifferURLLoader::CheckBufferedBody(uint32_t readBufferSize) {
-  size_t start_size = buffered_body_.size();  // Where to start reading from
-  uint32_t read_bytes = readBufferSize;
-  // Increase size of the buffer to accommodate new bytes to read
-  buffered_body_.resize(start_size + read_bytes);
-
-  auto result = body_consumer_handle_->ReadData(
-      &buffered_body_[0] + start_size, &read_bytes, MOJO_READ_DATA_FLAG_NONE);
+bool BodySnifferURLLoader::CheckBufferedBody(uint32_t max_bytes,
+                                             base::StringPiece* new_data) {
+  auto result = buffered_body_.ReadFrom(body_consumer_handle_.get(), max_bytes,
+                                        new_data);
   switch (result) {
     case MOJO_RESULT_OK:
-      read_bytes_ += read_bytes;
-      buffered_body_.resize(start_size + read_bytes);
+      read_bytes_ += new_data->size();
       return true;
     case MOJO_RESULT_FAILED_PRECONDITION:
-      buffered_body_.resize(start_size);
       CompleteLoading(std::move(buffered_body_));
       break;
     case MOJO_RESULT_SHOULD_WAIT:
@@ -183,13 +176,12 @@ bool BodySnifferURLLoader::CheckBufferedBody(uint32_t readBufferSize) {
   return false;
 }
 
-void BodySnifferURLLoader::CompleteLoading(std::string body) {
+void BodySnifferURLLoader::CompleteLoading(BodySnifferBuffer body) {
   read_bytes_ = 0;
   DCHECK_EQ(State::kLoading, state_);
   state_ = State::kSending;
 
   buffered_body_ = std::move(body);
-  bytes_remaining_in_buffer_ = buffered_body_.size();
   if (!throttle_ || !body_producer_handle_) {
     Abort();
     return;
@@ -203,7 +195,7 @@ void BodySnifferURLLoader::CompleteLoading(std::string body) {
       base::BindRepeating(&BodySnifferURLLoader::OnBodyWritable,
                           base::Unretained(this)));
 
-  if (bytes_remaining_in_buffer_) {
+  if (buffered_body_.HasUnsentData()) {
     SendBufferedBodyToClient();
     return;
   }
@@ -235,12 +227,8 @@ void BodySnifferURLLoader::CancelAndResetHandles() {
 void BodySnifferURLLoader::SendBufferedBodyToClient() {
   DCHECK_EQ(State::kSending, state_);
   // Send the buffered data first.
-  DCHECK_GT(bytes_remaining_in_buffer_, 0u);
-  size_t start_position = buffered_body_.size() - bytes_remaining_in_buffer_;
-  uint32_t bytes_sent = bytes_remaining_in_buffer_;
-  MojoResult result =
-      body_producer_handle_->WriteData(buffered_body_.data() + start_position,
-                                       &bytes_sent, MOJO_WRITE_DATA_FLAG_NONE);
+  DCHECK(buffered_body_.HasUnsentData());
+  MojoResult result = buffered_body_.WriteTo(body_producer_handle_.get());
   switch (result) {
     case MOJO_RESULT_OK:
       break;
@@ -256,7 +244,6 @@ void BodySnifferURLLoader::SendBufferedBodyToClient() {
       NOTREACHED();
       return;
   }
-  bytes_remaining_in_buffer_ -= bytes_sent;
   body_producer_watcher_.ArmOrNotify();
 }
 
@@ -11,7 +11,9 @@
 
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 #include "base/task/sequenced_task_runner.h"
+#include "brave/components/body_sniffer/body_sniffer_buffer.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/receiver.h"
@@ -93,12 +95,15 @@ class BodySnifferURLLoader : public network::mojom::URLLoaderClient,
   void PauseReadingBodyFromNet() override;
   void ResumeReadingBodyFromNet() override;
 
-  bool CheckBufferedBody(uint32_t readBufferSize);
+  // Reads up to |max_bytes| more of the body into |buffered_body_|. Only
+  // returns true if something was read, in which case |new_data| points at
+  // it.
+  bool CheckBufferedBody(uint32_t max_bytes, base::StringPiece* new_data);
 
   virtual void OnBodyReadable(MojoResult) = 0;
   virtual void OnBodyWritable(MojoResult) = 0;
 
-  virtual void CompleteLoading(std::string body);
+  virtual void CompleteLoading(BodySnifferBuffer body);
   void CompleteSending();
   virtual void OnCompleteSending();
   void SendBufferedBodyToClient();
@@ -120,8 +125,7 @@ class BodySnifferURLLoader : public network::mojom::URLLoaderClient,
 
   absl::optional<network::URLLoaderCompletionStatus> complete_status_;
 
-  std::string buffered_body_;
-  size_t bytes_remaining_in_buffer_;
+  BodySnifferBuffer buffered_body_;
   size_t read_bytes_ = 0;
 
   mojo::ScopedDataPipeConsumerHandle body_consumer_handle_;
@@ -11,6 +11,7 @@
 #include "base/logging.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 
 namespace {
 
@@ -45,6 +46,17 @@ DATFileDataBuffer ReadDATFileData(const base::FilePath& dat_file_path) {
   return buffer;
 }
 
+std::unique_ptr<base::MemoryMappedFile> MapDATFile(
+    const base::FilePath& dat_file_path) {
+  auto mapped_file = std::make_unique<base::MemoryMappedFile>();
+  if (!mapped_file->Initialize(dat_file_path) || mapped_file->length() == 0) {
+    LOG(ERROR) << "MapDATFile: cannot "
+               << "map dat file " << dat_file_path;
+    return nullptr;
+  }
+  return mapped_file;
+}
+
 std::string GetDATFileAsString(const base::FilePath& file_path) {
   std::string contents;
   bool success = base::ReadFileToString(file_path, &contents);
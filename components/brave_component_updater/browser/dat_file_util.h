@@ -13,6 +13,10 @@
 
 #include "base/files/file_path.h"
 
+namespace base {
+class MemoryMappedFile;
+}  // namespace base
+
 namespace brave_component_updater {
 
 using DATFileDataBuffer = std::vector<unsigned char>;
@@ -21,6 +25,11 @@ std::string GetDATFileAsString(const base::FilePath& file_path);
 
 DATFileDataBuffer ReadDATFileData(const base::FilePath& dat_file_path);
 
+// Maps the DAT file read-only instead of copying it to the heap. Returns
+// nullptr if the file is missing, empty or can't be mapped.
+std::unique_ptr<base::MemoryMappedFile> MapDATFile(
+    const base::FilePath& dat_file_path);
+
 template <typename T>
 using LoadDATFileDataResult =
     std::pair<std::unique_ptr<T>, brave_component_updater::DATFileDataBuffer>;
@@ -70,7 +70,7 @@ void AdBlockComponentFiltersProvider::LoadDATBuffer(
     return;
   }
 
-  base::FilePath list_file_path = component_path_.AppendASCII(kListFile);
+  base::FilePath list_file_path = GetListFilePath();
 
   base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE, {base::MayBlock()},
@@ -78,4 +78,11 @@ void AdBlockComponentFiltersProvider::LoadDATBuffer(
       base::BindOnce(std::move(cb), false));
 }
 
+base::FilePath AdBlockComponentFiltersProvider::GetListFilePath() const {
+  if (component_path_.empty()) {
+    return base::FilePath();
+  }
+  return component_path_.AppendASCII(kListFile);
+}
+
 }  // namespace brave_shields
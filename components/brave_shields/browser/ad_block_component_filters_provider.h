@@ -8,6 +8,7 @@
 
 #include <string>
 
+#include "base/files/file_path.h"
 #include "base/functional/callback.h"
 #include "base/observer_list.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
@@ -20,10 +21,6 @@ namespace component_updater {
 class ComponentUpdateService;
 }  // namespace component_updater
 
-namespace base {
-class FilePath;
-}
-
 class AdBlockServiceTest;
 
 namespace brave_shields {
@@ -51,6 +48,7 @@ class AdBlockComponentFiltersProvider : public AdBlockFiltersProvider {
   void LoadDATBuffer(
       base::OnceCallback<void(bool deserialize,
                               const DATFileDataBuffer& dat_buf)>) override;
+  base::FilePath GetListFilePath() const override;
 
   // Remove the component. This will force it to be redownloaded next time it
   // is registered.
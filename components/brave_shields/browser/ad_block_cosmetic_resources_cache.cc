@@ -0,0 +1,98 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources_cache.h"
+
+#include <new>
+
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/strcat.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+AdBlockCosmeticResourcesCache::AdBlockCosmeticResourcesCache(
+    size_t max_entries)
+    : entries_(max_entries),
+      generation_region_(base::ReadOnlySharedMemoryRegion::Create(
+          sizeof(std::atomic<uint32_t>))) {
+  if (generation_region_.IsValid()) {
+    generation_ =
+        new (generation_region_.mapping.memory()) std::atomic<uint32_t>(0);
+  }
+}
+
+AdBlockCosmeticResourcesCache::~AdBlockCosmeticResourcesCache() = default;
+
+// static
+std::string AdBlockCosmeticResourcesCache::MakeKey(const GURL& url,
+                                                   bool aggressive_blocking) {
+  return base::StrCat(
+      {aggressive_blocking ? "1" : "0", "|", url.GetWithoutRef().spec()});
+}
+
+absl::optional<base::Value::Dict> AdBlockCosmeticResourcesCache::Get(
+    const std::string& key) {
+  absl::optional<base::Value::Dict> resources;
+  {
+    base::AutoLock lock(lock_);
+    auto it = entries_.Get(key);
+    if (it != entries_.end()) {
+      resources = it->second.Clone();
+    }
+  }
+
+  if (resources) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+  }
+  UMA_HISTOGRAM_BOOLEAN(
+      "Brave.CosmeticFilters.UrlCosmeticResourcesBrowserCacheHit",
+      resources.has_value());
+  return resources;
+}
+
+void AdBlockCosmeticResourcesCache::Put(const std::string& key,
+                                        const base::Value::Dict& resources) {
+  base::AutoLock lock(lock_);
+  entries_.Put(key, resources.Clone());
+}
+
+void AdBlockCosmeticResourcesCache::Clear() {
+  {
+    base::AutoLock lock(lock_);
+    entries_.Clear();
+  }
+  if (generation_) {
+    generation_->fetch_add(1, std::memory_order_release);
+  }
+}
+
+base::ReadOnlySharedMemoryRegion
+AdBlockCosmeticResourcesCache::DuplicateGenerationRegion() const {
+  return generation_region_.region.Duplicate();
+}
+
+base::Value::Dict AdBlockCosmeticResourcesCache::GetDebugInfo() const {
+  size_t entry_count = 0;
+  {
+    base::AutoLock lock(lock_);
+    entry_count = entries_.size();
+  }
+
+  base::Value::Dict result;
+  result.Set("entries", static_cast<int>(entry_count));
+  result.Set("hits", static_cast<int>(hits_.load(std::memory_order_relaxed)));
+  result.Set("misses",
+             static_cast<int>(misses_.load(std::memory_order_relaxed)));
+  if (generation_) {
+    result.Set("generation",
+               static_cast<int>(generation_->load(std::memory_order_acquire)));
+  }
+  return result;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,76 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include "base/containers/lru_cache.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/values.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+class GURL;
+
+namespace brave_shields {
+
+// Bounded cache of the merged `UrlCosmeticResources` results computed by
+// `AdBlockService`, cleared whenever any engine's state changes.
+//
+// The cache also owns a small shared memory region holding a generation
+// number that is bumped on every clear. Renderers map it read-only and use it
+// to validate their own per-process copies of these results, so that they can
+// reuse them without a round trip to the browser.
+class AdBlockCosmeticResourcesCache
+    : public base::RefCountedThreadSafe<AdBlockCosmeticResourcesCache> {
+ public:
+  explicit AdBlockCosmeticResourcesCache(size_t max_entries);
+  AdBlockCosmeticResourcesCache(const AdBlockCosmeticResourcesCache&) = delete;
+  AdBlockCosmeticResourcesCache& operator=(
+      const AdBlockCosmeticResourcesCache&) = delete;
+
+  // Cosmetic resources depend on the host, which selects the site-specific
+  // rules, and on the full URL, which `$generichide` exceptions are matched
+  // against. The fragment affects neither.
+  static std::string MakeKey(const GURL& url, bool aggressive_blocking);
+
+  absl::optional<base::Value::Dict> Get(const std::string& key);
+  void Put(const std::string& key, const base::Value::Dict& resources);
+  void Clear();
+
+  // Returns a read-only handle to the generation region, or an invalid region
+  // if it could not be created.
+  base::ReadOnlySharedMemoryRegion DuplicateGenerationRegion() const;
+
+  // Entry counts and hit/miss counters for brave://adblock-internals.
+  base::Value::Dict GetDebugInfo() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<AdBlockCosmeticResourcesCache>;
+
+  ~AdBlockCosmeticResourcesCache();
+
+  mutable base::Lock lock_;
+  base::HashingLRUCache<std::string, base::Value::Dict> entries_
+      GUARDED_BY(lock_);
+
+  base::MappedReadOnlyRegion generation_region_;
+  std::atomic<uint32_t>* generation_ = nullptr;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_CACHE_H_
@@ -0,0 +1,91 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources_cache.h"
+
+#include <atomic>
+#include <string>
+#include <utility>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+base::Value::Dict MakeResources(const std::string& selector) {
+  base::Value::Dict resources;
+  base::Value::List hide_selectors;
+  hide_selectors.Append(selector);
+  resources.Set("hide_selectors", std::move(hide_selectors));
+  return resources;
+}
+
+}  // namespace
+
+TEST(AdBlockCosmeticResourcesCacheTest, KeyIgnoresOnlyFragment) {
+  const std::string key = AdBlockCosmeticResourcesCache::MakeKey(
+      GURL("https://a.example/page"), false);
+  EXPECT_EQ(key, AdBlockCosmeticResourcesCache::MakeKey(
+                     GURL("https://a.example/page#section"), false));
+  EXPECT_NE(key, AdBlockCosmeticResourcesCache::MakeKey(
+                     GURL("https://a.example/page"), true));
+  // A `$generichide` exception can match a single path or query of a host.
+  EXPECT_NE(key, AdBlockCosmeticResourcesCache::MakeKey(
+                     GURL("https://a.example/other"), false));
+  EXPECT_NE(key, AdBlockCosmeticResourcesCache::MakeKey(
+                     GURL("https://a.example/page?q=1"), false));
+  EXPECT_NE(key, AdBlockCosmeticResourcesCache::MakeKey(
+                     GURL("https://b.example/page"), false));
+}
+
+TEST(AdBlockCosmeticResourcesCacheTest, HitsAndMisses) {
+  auto cache = base::MakeRefCounted<AdBlockCosmeticResourcesCache>(16);
+  const std::string key = AdBlockCosmeticResourcesCache::MakeKey(
+      GURL("https://a.example/"), false);
+
+  EXPECT_FALSE(cache->Get(key));
+  cache->Put(key, MakeResources(".ad"));
+  const absl::optional<base::Value::Dict> resources = cache->Get(key);
+  ASSERT_TRUE(resources);
+  EXPECT_EQ(MakeResources(".ad"), *resources);
+
+  const base::Value::Dict debug_info = cache->GetDebugInfo();
+  EXPECT_EQ(1, debug_info.FindInt("entries"));
+  EXPECT_EQ(1, debug_info.FindInt("hits"));
+  EXPECT_EQ(1, debug_info.FindInt("misses"));
+}
+
+TEST(AdBlockCosmeticResourcesCacheTest, EvictsLeastRecentlyUsed) {
+  auto cache = base::MakeRefCounted<AdBlockCosmeticResourcesCache>(2);
+  cache->Put("a", MakeResources(".a"));
+  cache->Put("b", MakeResources(".b"));
+  EXPECT_TRUE(cache->Get("a"));
+  cache->Put("c", MakeResources(".c"));
+
+  EXPECT_TRUE(cache->Get("a"));
+  EXPECT_FALSE(cache->Get("b"));
+  EXPECT_TRUE(cache->Get("c"));
+}
+
+TEST(AdBlockCosmeticResourcesCacheTest, ClearBumpsSharedGeneration) {
+  auto cache = base::MakeRefCounted<AdBlockCosmeticResourcesCache>(16);
+  base::ReadOnlySharedMemoryRegion region = cache->DuplicateGenerationRegion();
+  ASSERT_TRUE(region.IsValid());
+  base::ReadOnlySharedMemoryMapping mapping = region.Map();
+  ASSERT_TRUE(mapping.IsValid());
+  const auto* generation =
+      static_cast<const std::atomic<uint32_t>*>(mapping.memory());
+  const uint32_t initial_generation = generation->load();
+
+  cache->Put("a", MakeResources(".a"));
+  cache->Clear();
+
+  EXPECT_FALSE(cache->Get("a"));
+  EXPECT_EQ(initial_generation + 1, generation->load());
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,109 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "base/containers/span.h"
+#include "base/hash/hash.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/strcat.h"
+
+namespace brave_shields {
+
+AdBlockDecisionCache::Shard::Shard(size_t max_entries)
+    : entries(max_entries) {}
+
+AdBlockDecisionCache::Shard::~Shard() = default;
+
+AdBlockDecisionCache::AdBlockDecisionCache(size_t max_entries) {
+  const size_t entries_per_shard =
+      std::max<size_t>(1, max_entries / kShardCount);
+  for (auto& shard : shards_) {
+    shard = std::make_unique<Shard>(entries_per_shard);
+  }
+}
+
+AdBlockDecisionCache::~AdBlockDecisionCache() = default;
+
+// static
+std::string AdBlockDecisionCache::MakeKey(const AdBlockRequestInfo& request) {
+  // The URL goes last since it is the only component that can contain the
+  // separator.
+  return base::StrCat(
+      {request.aggressive_blocking ? "1" : "0", "|",
+       base::NumberToString(static_cast<int>(request.resource_type)), "|",
+       request.tab_host, "|", request.url.spec()});
+}
+
+bool AdBlockDecisionCache::Get(const std::string& key,
+                               AdBlockRequestResult* result) {
+  Shard& shard = GetShard(key);
+  {
+    base::AutoLock lock(shard.lock);
+    auto it = shard.entries.Get(key);
+    if (it != shard.entries.end()) {
+      *result = it->second;
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void AdBlockDecisionCache::Put(const std::string& key,
+                               const AdBlockRequestResult& result,
+                               Generation generation) {
+  Shard& shard = GetShard(key);
+  base::AutoLock lock(shard.lock);
+  // Checked under the shard lock: `Clear` bumps the generation before it
+  // clears each shard, so a stale result is either rejected here or removed
+  // by the subsequent clear.
+  if (generation != generation_.load(std::memory_order_acquire)) {
+    return;
+  }
+  shard.entries.Put(key, result);
+}
+
+AdBlockDecisionCache::Generation AdBlockDecisionCache::generation() const {
+  return generation_.load(std::memory_order_acquire);
+}
+
+void AdBlockDecisionCache::Clear() {
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+  clears_.fetch_add(1, std::memory_order_relaxed);
+  for (auto& shard : shards_) {
+    base::AutoLock lock(shard->lock);
+    shard->entries.Clear();
+  }
+}
+
+base::Value::Dict AdBlockDecisionCache::GetDebugInfo() const {
+  size_t entry_count = 0;
+  for (const auto& shard : shards_) {
+    base::AutoLock lock(shard->lock);
+    entry_count += shard->entries.size();
+  }
+
+  base::Value::Dict result;
+  result.Set("entries", static_cast<int>(entry_count));
+  result.Set("hits", static_cast<int>(hits_.load(std::memory_order_relaxed)));
+  result.Set("misses",
+             static_cast<int>(misses_.load(std::memory_order_relaxed)));
+  result.Set("clears",
+             static_cast<int>(clears_.load(std::memory_order_relaxed)));
+  return result;
+}
+
+AdBlockDecisionCache::Shard& AdBlockDecisionCache::GetShard(
+    const std::string& key) {
+  return *shards_[base::FastHash(base::as_bytes(base::make_span(key))) %
+                  kShardCount];
+}
+
+}  // namespace brave_shields
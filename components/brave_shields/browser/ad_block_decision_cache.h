@@ -0,0 +1,83 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "base/containers/lru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/values.h"
+#include "brave/components/brave_shields/browser/ad_block_request_info.h"
+
+namespace brave_shields {
+
+// Bounded cache of network blocking decisions made by `AdBlockService`, keyed
+// by everything that affects the decision: the request URL, resource type, tab
+// host and whether aggressive blocking is in effect. The cache is split into
+// independently locked shards so that concurrent lookups rarely contend, and
+// is cleared as a whole whenever any engine's state changes.
+class AdBlockDecisionCache
+    : public base::RefCountedThreadSafe<AdBlockDecisionCache> {
+ public:
+  // Snapshot of the cache generation, taken before consulting the engines so
+  // that results computed against a since-replaced engine are not stored.
+  using Generation = uint64_t;
+
+  explicit AdBlockDecisionCache(size_t max_entries);
+  AdBlockDecisionCache(const AdBlockDecisionCache&) = delete;
+  AdBlockDecisionCache& operator=(const AdBlockDecisionCache&) = delete;
+
+  static std::string MakeKey(const AdBlockRequestInfo& request);
+
+  // Returns true and fills |result| if a decision for |key| is cached.
+  bool Get(const std::string& key, AdBlockRequestResult* result);
+  // Stores |result| unless the cache was cleared since |generation|.
+  void Put(const std::string& key,
+           const AdBlockRequestResult& result,
+           Generation generation);
+  Generation generation() const;
+  void Clear();
+
+  // Entry counts and hit/miss counters for brave://adblock-internals.
+  base::Value::Dict GetDebugInfo() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<AdBlockDecisionCache>;
+
+  static constexpr size_t kShardCount = 16;
+
+  struct Shard {
+    explicit Shard(size_t max_entries);
+    ~Shard();
+
+    mutable base::Lock lock;
+    base::HashingLRUCache<std::string, AdBlockRequestResult> entries
+        GUARDED_BY(lock);
+  };
+
+  ~AdBlockDecisionCache();
+
+  Shard& GetShard(const std::string& key);
+
+  std::array<std::unique_ptr<Shard>, kShardCount> shards_;
+  std::atomic<Generation> generation_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> clears_{0};
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_DECISION_CACHE_H_
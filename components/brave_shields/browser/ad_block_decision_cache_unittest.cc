@@ -0,0 +1,92 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+AdBlockRequestInfo MakeRequest(const std::string& url,
+                               const std::string& tab_host,
+                               bool aggressive_blocking) {
+  return AdBlockRequestInfo(GURL(url), blink::mojom::ResourceType::kScript,
+                            tab_host, aggressive_blocking);
+}
+
+AdBlockRequestResult BlockedResult() {
+  AdBlockRequestResult result;
+  result.did_match_rule = true;
+  return result;
+}
+
+}  // namespace
+
+TEST(AdBlockDecisionCacheTest, KeyIncludesAllInputs) {
+  const std::string key = AdBlockDecisionCache::MakeKey(
+      MakeRequest("https://tracker.example/a.js", "a.example", false));
+  EXPECT_NE(key, AdBlockDecisionCache::MakeKey(MakeRequest(
+                     "https://tracker.example/b.js", "a.example", false)));
+  EXPECT_NE(key, AdBlockDecisionCache::MakeKey(MakeRequest(
+                     "https://tracker.example/a.js", "b.example", false)));
+  EXPECT_NE(key, AdBlockDecisionCache::MakeKey(MakeRequest(
+                     "https://tracker.example/a.js", "a.example", true)));
+  EXPECT_NE(key, AdBlockDecisionCache::MakeKey(AdBlockRequestInfo(
+                     GURL("https://tracker.example/a.js"),
+                     blink::mojom::ResourceType::kImage, "a.example", false)));
+}
+
+TEST(AdBlockDecisionCacheTest, HitsAndMisses) {
+  auto cache = base::MakeRefCounted<AdBlockDecisionCache>(64);
+  const std::string key = AdBlockDecisionCache::MakeKey(
+      MakeRequest("https://tracker.example/a.js", "a.example", false));
+
+  AdBlockRequestResult result;
+  EXPECT_FALSE(cache->Get(key, &result));
+  cache->Put(key, BlockedResult(), cache->generation());
+  EXPECT_TRUE(cache->Get(key, &result));
+  EXPECT_TRUE(result.did_match_rule);
+
+  const base::Value::Dict debug_info = cache->GetDebugInfo();
+  EXPECT_EQ(1, debug_info.FindInt("entries"));
+  EXPECT_EQ(1, debug_info.FindInt("hits"));
+  EXPECT_EQ(1, debug_info.FindInt("misses"));
+}
+
+TEST(AdBlockDecisionCacheTest, ClearInvalidatesEntriesAndStaleResults) {
+  auto cache = base::MakeRefCounted<AdBlockDecisionCache>(64);
+  const std::string key = AdBlockDecisionCache::MakeKey(
+      MakeRequest("https://tracker.example/a.js", "a.example", false));
+  cache->Put(key, BlockedResult(), cache->generation());
+
+  // A check that started before the engine changed must not be cached.
+  const AdBlockDecisionCache::Generation stale_generation = cache->generation();
+  cache->Clear();
+  AdBlockRequestResult result;
+  EXPECT_FALSE(cache->Get(key, &result));
+  cache->Put(key, BlockedResult(), stale_generation);
+  EXPECT_FALSE(cache->Get(key, &result));
+
+  cache->Put(key, BlockedResult(), cache->generation());
+  EXPECT_TRUE(cache->Get(key, &result));
+}
+
+TEST(AdBlockDecisionCacheTest, IsBounded) {
+  auto cache = base::MakeRefCounted<AdBlockDecisionCache>(32);
+  for (int i = 0; i < 1000; ++i) {
+    cache->Put(AdBlockDecisionCache::MakeKey(MakeRequest(
+                   "https://tracker.example/" + std::to_string(i), "a.example",
+                   false)),
+               BlockedResult(), cache->generation());
+  }
+  EXPECT_LE(*cache->GetDebugInfo().FindInt("entries"), 32);
+}
+
+}  // namespace brave_shields
@@ -12,11 +12,15 @@
 
 #include "base/containers/contains.h"
 #include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/functional/bind.h"
 #include "base/json/json_reader.h"
+#include "base/logging.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/ranges/algorithm.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/task/sequenced_task_runner.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
@@ -98,7 +102,17 @@ std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
 
 namespace brave_shields {
 
-AdBlockEngine::AdBlockEngine() : ad_block_client_(new adblock::Engine()) {
+AdBlockEngine::Snapshot::Snapshot(std::unique_ptr<adblock::Engine> engine)
+    : engine_(std::move(engine)) {
+  DCHECK(engine_);
+}
+
+AdBlockEngine::Snapshot::~Snapshot() = default;
+
+AdBlockEngine::AdBlockEngine(bool concurrent_matching)
+    : concurrent_matching_(concurrent_matching),
+      snapshot_(base::MakeRefCounted<Snapshot>(
+          std::make_unique<adblock::Engine>())) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
@@ -113,7 +127,7 @@ void AdBlockEngine::ShouldStartRequest(const GURL& url,
                                        bool* did_match_important,
                                        std::string* mock_data_url,
                                        std::string* rewritten_url) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const scoped_refptr<Snapshot> snapshot = GetSnapshot();
   // Determine third-party here so the library doesn't need to figure it out.
   // CreateFromNormalizedTuple is needed because SameDomainOrHost needs
   // a URL or origin and not a string to a host name.
@@ -121,10 +135,12 @@ void AdBlockEngine::ShouldStartRequest(const GURL& url,
       url,
       url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
       INCLUDE_PRIVATE_REGISTRIES);
-  ad_block_client_->matches(url.spec(), url.host(), tab_host, is_third_party,
-                            ResourceTypeToString(resource_type), did_match_rule,
-                            did_match_exception, did_match_important,
-                            mock_data_url, rewritten_url);
+  snapshot->engine()->matches(url.spec(), url.host(), tab_host,
+                              is_third_party,
+                              ResourceTypeToString(resource_type),
+                              did_match_rule, did_match_exception,
+                              did_match_important, mock_data_url,
+                              rewritten_url);
 
   // LOG(ERROR) << "AdBlockEngine::ShouldStartRequest(), host: "
   //  << tab_host
@@ -136,7 +152,7 @@ absl::optional<std::string> AdBlockEngine::GetCspDirectives(
     const GURL& url,
     blink::mojom::ResourceType resource_type,
     const std::string& tab_host) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const scoped_refptr<Snapshot> snapshot = GetSnapshot();
   // Determine third-party here so the library doesn't need to figure it out.
   // CreateFromNormalizedTuple is needed because SameDomainOrHost needs
   // a URL or origin and not a string to a host name.
@@ -144,7 +160,7 @@ absl::optional<std::string> AdBlockEngine::GetCspDirectives(
       url,
       url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
       INCLUDE_PRIVATE_REGISTRIES);
-  const std::string result = ad_block_client_->getCspDirectives(
+  const std::string result = snapshot->engine()->getCspDirectives(
       url.spec(), url.host(), tab_host, is_third_party,
       ResourceTypeToString(resource_type));
 
@@ -157,20 +173,38 @@ absl::optional<std::string> AdBlockEngine::GetCspDirectives(
 
 void AdBlockEngine::EnableTag(const std::string& tag, bool enabled) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (concurrent_matching_) {
+    const bool changed = enabled ? tags_.insert(tag).second : tags_.erase(tag);
+    if (changed) {
+      ScheduleRebuild();
+    }
+    return;
+  }
+
+  adblock::Engine* engine = GetSnapshot()->engine();
   if (enabled) {
-    if (tags_.find(tag) == tags_.end()) {
-      ad_block_client_->addTag(tag);
-      tags_.insert(tag);
+    if (!tags_.insert(tag).second) {
+      return;
     }
+    engine->addTag(tag);
   } else {
-    ad_block_client_->removeTag(tag);
-    tags_.erase(tag);
+    if (!tags_.erase(tag)) {
+      return;
+    }
+    engine->removeTag(tag);
   }
+  NotifyStateChanged();
 }
 
 void AdBlockEngine::UseResources(const std::string& resources) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  ad_block_client_->useResources(resources);
+  if (concurrent_matching_) {
+    resources_json_ = resources;
+    ScheduleRebuild();
+    return;
+  }
+  GetSnapshot()->engine()->useResources(resources);
+  NotifyStateChanged();
 }
 
 bool AdBlockEngine::TagExists(const std::string& tag) {
@@ -180,7 +214,8 @@ bool AdBlockEngine::TagExists(const std::string& tag) {
 
 base::Value::Dict AdBlockEngine::GetDebugInfo() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  const auto debug_info_struct = ad_block_client_->getAdblockDebugInfo();
+  const auto debug_info_struct =
+      GetSnapshot()->engine()->getAdblockDebugInfo();
   base::Value::List regex_list;
   for (const auto& regex_entry : debug_info_struct.regex_data) {
     base::Value::Dict regex_info;
@@ -200,20 +235,29 @@ base::Value::Dict AdBlockEngine::GetDebugInfo() {
 
 void AdBlockEngine::DiscardRegex(uint64_t regex_id) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  ad_block_client_->discardRegex(regex_id);
+  // A published snapshot may be in use by other threads, so its regexes can't
+  // be discarded one by one; they are released by the discard policy instead.
+  if (concurrent_matching_) {
+    DVLOG(1) << "Ignoring regex discard in concurrent matching mode";
+    return;
+  }
+  GetSnapshot()->engine()->discardRegex(regex_id);
 }
 
 void AdBlockEngine::SetupDiscardPolicy(
     const adblock::RegexManagerDiscardPolicy& policy) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   regex_discard_policy_ = policy;
-  ad_block_client_->setupDiscardPolicy(policy);
+  if (concurrent_matching_) {
+    ScheduleRebuild();
+    return;
+  }
+  GetSnapshot()->engine()->setupDiscardPolicy(policy);
 }
 
 base::Value::Dict AdBlockEngine::UrlCosmeticResources(const std::string& url) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  absl::optional<base::Value> result =
-      base::JSONReader::Read(ad_block_client_->urlCosmeticResources(url));
+  absl::optional<base::Value> result = base::JSONReader::Read(
+      GetSnapshot()->engine()->urlCosmeticResources(url));
 
   if (!result) {
     return base::Value::Dict();
@@ -227,9 +271,9 @@ base::Value::List AdBlockEngine::HiddenClassIdSelectors(
     const std::vector<std::string>& classes,
     const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  absl::optional<base::Value> result = base::JSONReader::Read(
-      ad_block_client_->hiddenClassIdSelectors(classes, ids, exceptions));
+  absl::optional<base::Value> result =
+      base::JSONReader::Read(GetSnapshot()->engine()->hiddenClassIdSelectors(
+          classes, ids, exceptions));
 
   if (!result) {
     return base::Value::List();
@@ -240,43 +284,179 @@ base::Value::List AdBlockEngine::HiddenClassIdSelectors(
 }
 
 void AdBlockEngine::Load(bool deserialize,
-                         const DATFileDataBuffer& dat_buf,
+                         DATFileDataBuffer dat_buf,
                          const std::string& resources_json) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  SCOPED_UMA_HISTOGRAM_TIMER("Brave.Adblock.EngineLoadTime.Buffer");
   if (deserialize) {
     OnDATLoaded(dat_buf, resources_json);
   } else {
     OnListSourceLoaded(dat_buf, resources_json);
   }
+  if (concurrent_matching_ && !dat_buf.empty()) {
+    // Retain the buffer the list arrived in rather than a copy of it.
+    source_deserialize_ = deserialize;
+    source_buf_ = std::move(dat_buf);
+    source_file_path_.clear();
+  }
+}
+
+void AdBlockEngine::UseCompiledEngine(CompiledAdBlockEngine compiled,
+                                      const std::string& resources_json) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!compiled.engine) {
+    return;
+  }
+  if (concurrent_matching_ && !compiled.serialized.empty()) {
+    source_deserialize_ = true;
+    source_buf_ = std::move(compiled.serialized);
+    source_file_path_.clear();
+  }
+  UpdateAdBlockClient(std::move(compiled.engine), resources_json);
+}
+
+void AdBlockEngine::LoadFromFile(bool deserialize,
+                                 const base::FilePath& list_file_path,
+                                 const std::string& resources_json) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  SCOPED_UMA_HISTOGRAM_TIMER("Brave.Adblock.EngineLoadTime.Mapped");
+  // The mapping only needs to outlive engine construction, since the engine
+  // copies everything it needs out of the list. The mapped pages are clean
+  // and can be dropped by the OS, unlike a heap copy of the file.
+  std::unique_ptr<base::MemoryMappedFile> mapped_file =
+      brave_component_updater::MapDATFile(list_file_path);
+  if (!mapped_file) {
+    return;
+  }
+  if (concurrent_matching_) {
+    source_deserialize_ = deserialize;
+    source_file_path_ = list_file_path;
+    source_buf_.clear();
+  }
+  UpdateAdBlockClient(CreateEngine(deserialize, mapped_file->bytes()),
+                      resources_json);
+}
+
+scoped_refptr<AdBlockEngine::Snapshot> AdBlockEngine::GetSnapshot() const {
+  if (!concurrent_matching_) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  }
+  base::AutoLock lock(snapshot_lock_);
+  return snapshot_;
+}
+
+void AdBlockEngine::PublishSnapshot(scoped_refptr<Snapshot> snapshot) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  {
+    base::AutoLock lock(snapshot_lock_);
+    snapshot_.swap(snapshot);
+  }
+  // |snapshot| now holds the previous engine, which is destroyed here unless
+  // a reader still holds a reference to it, outside of |snapshot_lock_|.
+}
+
+std::unique_ptr<adblock::Engine> AdBlockEngine::CreateEngineFromSource()
+    const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!source_file_path_.empty()) {
+    std::unique_ptr<base::MemoryMappedFile> mapped_file =
+        brave_component_updater::MapDATFile(source_file_path_);
+    if (!mapped_file) {
+      LOG(ERROR) << "Could not map adblock list " << source_file_path_;
+      return nullptr;
+    }
+    return CreateEngine(source_deserialize_, mapped_file->bytes());
+  }
+  if (source_buf_.empty()) {
+    return std::make_unique<adblock::Engine>();
+  }
+  return CreateEngine(source_deserialize_, source_buf_);
+}
+
+// static
+std::unique_ptr<adblock::Engine> AdBlockEngine::CreateEngine(
+    bool deserialize,
+    base::span<const uint8_t> data) {
+  if (!deserialize) {
+    return std::make_unique<adblock::Engine>(
+        reinterpret_cast<const char*>(data.data()), data.size());
+  }
+  auto engine = std::make_unique<adblock::Engine>();
+  engine->deserialize(reinterpret_cast<const char*>(data.data()),
+                      data.size());
+  return engine;
+}
+
+void AdBlockEngine::ScheduleRebuild() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(concurrent_matching_);
+  if (rebuild_pending_) {
+    return;
+  }
+  rebuild_pending_ = true;
+  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+      FROM_HERE, base::BindOnce(&AdBlockEngine::RebuildSnapshot, AsWeakPtr()));
+}
+
+void AdBlockEngine::RebuildSnapshot() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(concurrent_matching_);
+  if (!rebuild_pending_) {
+    // A newer list was loaded meanwhile, with the current state applied.
+    return;
+  }
+  rebuild_pending_ = false;
+  std::unique_ptr<adblock::Engine> engine = CreateEngineFromSource();
+  if (!engine) {
+    // Keep matching against the current engine rather than an empty one.
+    return;
+  }
+  if (!source_deserialize_ && !source_buf_.empty()) {
+    // Replace the list with its serialized form, so that later rebuilds
+    // deserialize it rather than parse the list again. Mapped lists are left
+    // as they are, since their pages don't count against the heap.
+    DATFileDataBuffer serialized = engine->serialize();
+    if (!serialized.empty()) {
+      source_deserialize_ = true;
+      source_buf_ = std::move(serialized);
+    }
+  }
+  UpdateAdBlockClient(std::move(engine), resources_json_);
 }
 
 void AdBlockEngine::UpdateAdBlockClient(
     std::unique_ptr<adblock::Engine> ad_block_client,
     const std::string& resources_json) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  ad_block_client_ = std::move(ad_block_client);
+  // The new engine gets the current tags and resources, so there is nothing
+  // left for a scheduled rebuild to apply.
+  rebuild_pending_ = false;
   if (regex_discard_policy_) {
-    ad_block_client_->setupDiscardPolicy(*regex_discard_policy_);
+    ad_block_client->setupDiscardPolicy(*regex_discard_policy_);
+  }
+  ad_block_client->useResources(resources_json);
+  if (concurrent_matching_) {
+    resources_json_ = resources_json;
   }
-  UseResources(resources_json);
-  AddKnownTagsToAdBlockInstance();
+  for (const auto& tag : tags_) {
+    ad_block_client->addTag(tag);
+  }
+  // The engine is fully configured before it becomes visible to readers.
+  PublishSnapshot(base::MakeRefCounted<Snapshot>(std::move(ad_block_client)));
+  if (!load_start_time_.is_null()) {
+    UMA_HISTOGRAM_MEDIUM_TIMES("Brave.Adblock.TimeToFirstEngine",
+                               base::TimeTicks::Now() - load_start_time_);
+    load_start_time_ = base::TimeTicks();
+  }
+  NotifyStateChanged();
   if (test_observer_) {
     test_observer_->OnEngineUpdated();
   }
 }
 
-void AdBlockEngine::AddKnownTagsToAdBlockInstance() {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  std::for_each(tags_.begin(), tags_.end(), [&](const std::string tag) {
-    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-    ad_block_client_->addTag(tag);
-  });
-}
-
 void AdBlockEngine::OnListSourceLoaded(const DATFileDataBuffer& filters,
                                        const std::string& resources_json) {
-  auto engine = std::make_unique<adblock::Engine>(
-      reinterpret_cast<const char*>(filters.data()), filters.size());
-  UpdateAdBlockClient(std::move(engine), resources_json);
+  UpdateAdBlockClient(CreateEngine(false, filters), resources_json);
 }
 
 void AdBlockEngine::OnDATLoaded(const DATFileDataBuffer& dat_buf,
@@ -286,11 +466,24 @@ void AdBlockEngine::OnDATLoaded(const DATFileDataBuffer& dat_buf,
     return;
   }
 
-  auto client = std::make_unique<adblock::Engine>();
-  client->deserialize(reinterpret_cast<const char*>(&dat_buf.front()),
-                      dat_buf.size());
+  UpdateAdBlockClient(CreateEngine(true, dat_buf), resources_json);
+}
+
+void AdBlockEngine::SetStateChangedCallback(base::RepeatingClosure callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  state_changed_callback_ = std::move(callback);
+}
+
+void AdBlockEngine::SetLoadStartTime(base::TimeTicks start_time) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  load_start_time_ = start_time;
+}
 
-  UpdateAdBlockClient(std::move(client), resources_json);
+void AdBlockEngine::NotifyStateChanged() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (state_changed_callback_) {
+    state_changed_callback_.Run();
+  }
 }
 
 void AdBlockEngine::AddObserverForTest(AdBlockEngine::TestObserver* observer) {
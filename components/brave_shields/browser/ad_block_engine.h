@@ -14,12 +14,20 @@
 #include <utility>
 #include <vector>
 
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+#include "base/functional/callback.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list_types.h"
 #include "base/sequence_checker.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_engine_compiler.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 #include "url/gurl.h"
 
@@ -42,7 +50,28 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   using GetDATFileDataResult =
       brave_component_updater::LoadDATFileDataResult<adblock::Engine>;
 
-  AdBlockEngine();
+  // An `adblock::Engine` shared between the engine sequence and any readers
+  // that are currently matching against it. Once a snapshot has been
+  // published in concurrent matching mode it is never mutated again; state
+  // changes build a new snapshot and swap it in instead.
+  class Snapshot : public base::RefCountedThreadSafe<Snapshot> {
+   public:
+    explicit Snapshot(std::unique_ptr<adblock::Engine> engine);
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    adblock::Engine* engine() const { return engine_.get(); }
+
+   private:
+    friend class base::RefCountedThreadSafe<Snapshot>;
+    ~Snapshot();
+
+    const std::unique_ptr<adblock::Engine> engine_;
+  };
+
+  // When |concurrent_matching| is true, `ShouldStartRequest` and the other
+  // read-only queries may be called from any thread.
+  explicit AdBlockEngine(bool concurrent_matching = false);
   AdBlockEngine(const AdBlockEngine&) = delete;
   AdBlockEngine& operator=(const AdBlockEngine&) = delete;
   ~AdBlockEngine();
@@ -60,11 +89,15 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
       const GURL& url,
       blink::mojom::ResourceType resource_type,
       const std::string& tab_host);
+  // In concurrent matching mode, resource and tag changes are applied by a
+  // rebuild posted to the engine sequence.
   void UseResources(const std::string& resources);
   void EnableTag(const std::string& tag, bool enabled);
   bool TagExists(const std::string& tag);
 
   base::Value::Dict GetDebugInfo();
+  // Does nothing in concurrent matching mode, where compiled regexes are only
+  // released by the discard policy.
   void DiscardRegex(uint64_t regex_id);
   void SetupDiscardPolicy(const adblock::RegexManagerDiscardPolicy& policy);
 
@@ -75,8 +108,17 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
       const std::vector<std::string>& exceptions);
 
   void Load(bool deserialize,
-            const DATFileDataBuffer& dat_buf,
+            DATFileDataBuffer dat_buf,
             const std::string& resources_json);
+  // Swaps in an engine that was built off the engine sequence by
+  // `CompileAdBlockEngine`.
+  void UseCompiledEngine(CompiledAdBlockEngine compiled,
+                         const std::string& resources_json);
+  // Like `Load`, but maps |list_file_path| into memory and builds the engine
+  // straight from the mapping rather than from a heap copy of the file.
+  void LoadFromFile(bool deserialize,
+                    const base::FilePath& list_file_path,
+                    const std::string& resources_json);
 
   class TestObserver : public base::CheckedObserver {
    public:
@@ -86,8 +128,18 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   void AddObserverForTest(TestObserver* observer);
   void RemoveObserverForTest();
 
+  bool concurrent_matching() const { return concurrent_matching_; }
+
+  // Sets a callback to run on the engine sequence whenever the engine is
+  // replaced or its tags or resources change, i.e. whenever previously
+  // computed blocking decisions may no longer be valid.
+  void SetStateChangedCallback(base::RepeatingClosure callback);
+
+  // Records the time from |start_time| until the first list is loaded into
+  // the engine, i.e. until the engine can first block anything.
+  void SetLoadStartTime(base::TimeTicks start_time);
+
  protected:
-  void AddKnownTagsToAdBlockInstance();
   void UpdateAdBlockClient(std::unique_ptr<adblock::Engine> ad_block_client,
                            const std::string& resources_json);
   void OnListSourceLoaded(const DATFileDataBuffer& filters,
@@ -96,8 +148,26 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   void OnDATLoaded(const DATFileDataBuffer& dat_buf,
                    const std::string& resources_json);
 
-  std::unique_ptr<adblock::Engine> ad_block_client_
-      GUARDED_BY_CONTEXT(sequence_checker_);
+  // Returns the currently published engine. The returned reference keeps the
+  // engine alive even if a newer one is published meanwhile.
+  scoped_refptr<Snapshot> GetSnapshot() const;
+  void PublishSnapshot(scoped_refptr<Snapshot> snapshot);
+  // Posts a `RebuildSnapshot` task to the engine sequence unless one is
+  // already pending, so that tag, resource and discard policy changes made in
+  // a row share a single rebuild.
+  void ScheduleRebuild();
+  // Builds a fresh engine from the last loaded list, applying the current
+  // tags, resources and discard policy, and publishes it. Only used in
+  // concurrent matching mode, where the published engine can't be modified.
+  // Lists loaded from a buffer are kept serialized after their first rebuild
+  // to keep later ones cheap; mapped lists are mapped again.
+  void RebuildSnapshot();
+  // Returns nullptr if the last loaded list file can no longer be mapped.
+  std::unique_ptr<adblock::Engine> CreateEngineFromSource() const;
+  static std::unique_ptr<adblock::Engine> CreateEngine(
+      bool deserialize,
+      base::span<const uint8_t> data);
+  void NotifyStateChanged();
 
  private:
   friend class ::AdBlockServiceTest;
@@ -105,10 +175,28 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   friend class ::EphemeralStorage1pDomainBlockBrowserTest;
   friend class ::PerfPredictorTabHelperTest;
 
+  const bool concurrent_matching_;
+
+  mutable base::Lock snapshot_lock_;
+  scoped_refptr<Snapshot> snapshot_ GUARDED_BY(snapshot_lock_);
+
+  // Source of the current engine, retained in concurrent matching mode so
+  // that tag and resource changes can be applied to a new engine. Lists
+  // loaded with `LoadFromFile` keep only their path and are mapped again.
+  bool source_deserialize_ GUARDED_BY_CONTEXT(sequence_checker_) = false;
+  DATFileDataBuffer source_buf_ GUARDED_BY_CONTEXT(sequence_checker_);
+  base::FilePath source_file_path_ GUARDED_BY_CONTEXT(sequence_checker_);
+  std::string resources_json_ GUARDED_BY_CONTEXT(sequence_checker_);
+  bool rebuild_pending_ GUARDED_BY_CONTEXT(sequence_checker_) = false;
+
   std::set<std::string> tags_ GUARDED_BY_CONTEXT(sequence_checker_);
   absl::optional<adblock::RegexManagerDiscardPolicy> regex_discard_policy_
       GUARDED_BY_CONTEXT(sequence_checker_);
 
+  base::RepeatingClosure state_changed_callback_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+  base::TimeTicks load_start_time_ GUARDED_BY_CONTEXT(sequence_checker_);
+
   raw_ptr<TestObserver> test_observer_ = nullptr;
 
   SEQUENCE_CHECKER(sequence_checker_);
@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_engine_compiler.h"
+
+#include <utility>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/logging.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "crypto/sha2.h"
+
+namespace brave_shields {
+
+namespace {
+
+// Bump whenever the serialized engine format changes in a way that
+// adblock-rust can't detect by itself, to avoid loading stale cache entries.
+constexpr int kCacheFormatVersion = 1;
+
+constexpr char kCacheFileExtension[] = ".dat";
+
+std::string GetCacheFilePrefix(const std::string& cache_name) {
+  return base::StrCat({cache_name, "-v",
+                       base::NumberToString(kCacheFormatVersion), "-"});
+}
+
+// Removes all cache entries for |cache_name|, including those written with
+// other format versions, other than |keep|.
+void DeleteStaleCacheEntries(const base::FilePath& cache_dir,
+                             const std::string& cache_name,
+                             const base::FilePath& keep) {
+  const std::string prefix = cache_name + "-";
+  base::FileEnumerator enumerator(cache_dir, false,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (path != keep &&
+        base::StartsWith(path.BaseName().MaybeAsASCII(), prefix)) {
+      base::DeleteFile(path);
+    }
+  }
+}
+
+}  // namespace
+
+CompiledAdBlockEngine::CompiledAdBlockEngine() = default;
+CompiledAdBlockEngine::CompiledAdBlockEngine(CompiledAdBlockEngine&&) = default;
+CompiledAdBlockEngine& CompiledAdBlockEngine::operator=(
+    CompiledAdBlockEngine&&) = default;
+CompiledAdBlockEngine::~CompiledAdBlockEngine() = default;
+
+base::FilePath GetCompiledAdBlockEnginePath(const base::FilePath& cache_dir,
+                                            const std::string& cache_name,
+                                            const DATFileDataBuffer& filters) {
+  const std::string hash = crypto::SHA256HashString(base::StringPiece(
+      reinterpret_cast<const char*>(filters.data()), filters.size()));
+  return cache_dir.AppendASCII(
+      base::StrCat({GetCacheFilePrefix(cache_name),
+                    base::HexEncode(hash.data(), hash.size()),
+                    kCacheFileExtension}));
+}
+
+CompiledAdBlockEngine CompileAdBlockEngine(const base::FilePath& cache_dir,
+                                           const std::string& cache_name,
+                                           const DATFileDataBuffer& filters) {
+  CompiledAdBlockEngine result;
+  const base::FilePath cache_path =
+      GetCompiledAdBlockEnginePath(cache_dir, cache_name, filters);
+
+  if (base::PathExists(cache_path)) {
+    DATFileDataBuffer cached =
+        brave_component_updater::ReadDATFileData(cache_path);
+    auto engine = std::make_unique<adblock::Engine>();
+    if (!cached.empty() &&
+        engine->deserialize(reinterpret_cast<const char*>(cached.data()),
+                            cached.size())) {
+      result.engine = std::move(engine);
+      result.serialized = std::move(cached);
+      result.from_cache = true;
+      return result;
+    }
+    // Fall through and replace the unusable entry.
+    base::DeleteFile(cache_path);
+  }
+
+  result.engine = std::make_unique<adblock::Engine>(
+      reinterpret_cast<const char*>(filters.data()), filters.size());
+  result.serialized = result.engine->serialize();
+  if (result.serialized.empty()) {
+    return result;
+  }
+
+  if (!base::CreateDirectory(cache_dir) ||
+      !base::ImportantFileWriter::WriteFileAtomically(
+          cache_path,
+          base::StringPiece(
+              reinterpret_cast<const char*>(result.serialized.data()),
+              result.serialized.size()))) {
+    LOG(ERROR) << "CompileAdBlockEngine: cannot write " << cache_path;
+    return result;
+  }
+  DeleteStaleCacheEntries(cache_dir, cache_name, cache_path);
+  return result;
+}
+
+}  // namespace brave_shields
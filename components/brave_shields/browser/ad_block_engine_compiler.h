@@ -0,0 +1,57 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_ENGINE_COMPILER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_ENGINE_COMPILER_H_
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+
+using brave_component_updater::DATFileDataBuffer;
+
+namespace adblock {
+class Engine;
+}  // namespace adblock
+
+namespace brave_shields {
+
+// An adblock engine built off the engine sequence, ready to be swapped in.
+struct CompiledAdBlockEngine {
+  CompiledAdBlockEngine();
+  CompiledAdBlockEngine(CompiledAdBlockEngine&&);
+  CompiledAdBlockEngine& operator=(CompiledAdBlockEngine&&);
+  ~CompiledAdBlockEngine();
+
+  std::unique_ptr<adblock::Engine> engine;
+  // The serialized form of |engine|, which can be used to rebuild it.
+  DATFileDataBuffer serialized;
+  // Whether |engine| was deserialized from the on-disk cache rather than
+  // compiled from the list source.
+  bool from_cache = false;
+};
+
+// Returns the path under |cache_dir| at which the compiled engine for
+// |filters| is cached. Files are named after |cache_name| and a hash of the
+// list contents, so an unchanged list always maps to the same file.
+base::FilePath GetCompiledAdBlockEnginePath(const base::FilePath& cache_dir,
+                                            const std::string& cache_name,
+                                            const DATFileDataBuffer& filters);
+
+// Builds an engine for the filter list source in |filters|. If a serialized
+// engine for the same list contents exists in |cache_dir| it is deserialized;
+// otherwise the list is compiled, and the result is serialized to the cache,
+// replacing any previous entry for |cache_name|. Blocks on disk IO and can
+// take a long time for large lists, so must be run on a low priority
+// `base::MayBlock()` task runner rather than on the engine sequence.
+CompiledAdBlockEngine CompileAdBlockEngine(const base::FilePath& cache_dir,
+                                           const std::string& cache_name,
+                                           const DATFileDataBuffer& filters);
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_ENGINE_COMPILER_H_
@@ -0,0 +1,100 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_engine_compiler.h"
+
+#include <string>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+DATFileDataBuffer ToBuffer(const std::string& str) {
+  return DATFileDataBuffer(str.begin(), str.end());
+}
+
+int CountFiles(const base::FilePath& dir) {
+  int count = 0;
+  base::FileEnumerator enumerator(dir, false, base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    count++;
+  }
+  return count;
+}
+
+}  // namespace
+
+class AdBlockEngineCompilerTest : public testing::Test {
+ public:
+  AdBlockEngineCompilerTest() = default;
+  ~AdBlockEngineCompilerTest() override = default;
+
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  base::FilePath cache_dir() const {
+    return temp_dir_.GetPath().AppendASCII("cache");
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(AdBlockEngineCompilerTest, CachesCompiledEngineByListContents) {
+  const DATFileDataBuffer filters = ToBuffer("||tracker.example^\n");
+
+  CompiledAdBlockEngine compiled =
+      CompileAdBlockEngine(cache_dir(), "additional", filters);
+  ASSERT_TRUE(compiled.engine);
+  EXPECT_FALSE(compiled.from_cache);
+  EXPECT_FALSE(compiled.serialized.empty());
+  EXPECT_TRUE(base::PathExists(
+      GetCompiledAdBlockEnginePath(cache_dir(), "additional", filters)));
+
+  CompiledAdBlockEngine cached =
+      CompileAdBlockEngine(cache_dir(), "additional", filters);
+  ASSERT_TRUE(cached.engine);
+  EXPECT_TRUE(cached.from_cache);
+  EXPECT_EQ(compiled.serialized, cached.serialized);
+}
+
+TEST_F(AdBlockEngineCompilerTest, ReplacesStaleEntries) {
+  CompileAdBlockEngine(cache_dir(), "additional",
+                       ToBuffer("||tracker.example^\n"));
+  CompileAdBlockEngine(cache_dir(), "default", ToBuffer("||ads.example^\n"));
+  EXPECT_EQ(2, CountFiles(cache_dir()));
+
+  const DATFileDataBuffer updated = ToBuffer("||other-tracker.example^\n");
+  CompiledAdBlockEngine compiled =
+      CompileAdBlockEngine(cache_dir(), "additional", updated);
+  EXPECT_FALSE(compiled.from_cache);
+  EXPECT_EQ(2, CountFiles(cache_dir()));
+  EXPECT_TRUE(base::PathExists(
+      GetCompiledAdBlockEnginePath(cache_dir(), "additional", updated)));
+}
+
+TEST_F(AdBlockEngineCompilerTest, RecompilesCorruptEntries) {
+  const DATFileDataBuffer filters = ToBuffer("||tracker.example^\n");
+  const base::FilePath cache_path =
+      GetCompiledAdBlockEnginePath(cache_dir(), "additional", filters);
+  ASSERT_TRUE(base::CreateDirectory(cache_dir()));
+  ASSERT_TRUE(base::WriteFile(cache_path, "not an engine"));
+
+  CompiledAdBlockEngine compiled =
+      CompileAdBlockEngine(cache_dir(), "additional", filters);
+  ASSERT_TRUE(compiled.engine);
+  EXPECT_FALSE(compiled.from_cache);
+
+  EXPECT_TRUE(CompileAdBlockEngine(cache_dir(), "additional", filters)
+                  .from_cache);
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,233 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_engine.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/raw_ptr.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/task_environment.h"
+#include "base/threading/simple_thread.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_shields/browser/ad_block_request_info.h"
+#include "brave/components/brave_shields/common/adblock_domain_resolver.h"
+#include "brave/components/brave_shields/common/buildflags/buildflags.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kFilters[] =
+    "||tracker.example^\n"
+    "@@||tracker.example/allowed.js\n"
+    "||ads.example^$tag=test-tag\n";
+
+DATFileDataBuffer ToBuffer(const std::string& str) {
+  return DATFileDataBuffer(str.begin(), str.end());
+}
+
+#if BUILDFLAG(ENABLE_ADBLOCK_CONCURRENT_MATCHING)
+constexpr int kRequestsPerThread = 2000;
+
+// Repeatedly matches a fixed set of requests and records any result that
+// doesn't agree with the filters loaded above.
+class MatchingDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit MatchingDelegate(AdBlockEngine* engine) : engine_(engine) {}
+
+  void Run() override {
+    for (int i = 0; i < kRequestsPerThread; ++i) {
+      if (!Matches("https://tracker.example/script.js") ||
+          Matches("https://tracker.example/allowed.js") ||
+          Matches("https://first-party.example/app.js")) {
+        mismatches_++;
+      }
+    }
+  }
+
+  int mismatches() const { return mismatches_; }
+
+ private:
+  // Returns whether a script request for |url| would be blocked.
+  bool Matches(const std::string& url) {
+    bool did_match_rule = false;
+    bool did_match_exception = false;
+    bool did_match_important = false;
+    std::string mock_data_url;
+    std::string rewritten_url;
+    engine_->ShouldStartRequest(
+        GURL(url), blink::mojom::ResourceType::kScript, "first-party.example",
+        false, &did_match_rule, &did_match_exception, &did_match_important,
+        &mock_data_url, &rewritten_url);
+    return did_match_rule && !did_match_exception;
+  }
+
+  raw_ptr<AdBlockEngine> engine_;
+  int mismatches_ = 0;
+};
+#endif  // BUILDFLAG(ENABLE_ADBLOCK_CONCURRENT_MATCHING)
+
+class EngineUpdateCounter : public AdBlockEngine::TestObserver {
+ public:
+  void OnEngineUpdated() override { updates_++; }
+
+  int updates() const { return updates_; }
+
+ private:
+  int updates_ = 0;
+};
+
+}  // namespace
+
+class AdBlockEngineConcurrencyTest : public testing::Test {
+ public:
+  AdBlockEngineConcurrencyTest() = default;
+  ~AdBlockEngineConcurrencyTest() override = default;
+
+ protected:
+  void SetUp() override {
+    adblock::SetDomainResolver(AdBlockServiceDomainResolver);
+    engine_ = std::make_unique<AdBlockEngine>(/*concurrent_matching=*/true);
+    engine_->Load(false, ToBuffer(kFilters), "[]");
+  }
+
+#if BUILDFLAG(ENABLE_ADBLOCK_CONCURRENT_MATCHING)
+  // Runs |thread_count| matching threads while filter list updates are
+  // published, returning the total number of mismatched results.
+  int RunMatchingThreads(int thread_count) {
+    std::vector<std::unique_ptr<MatchingDelegate>> delegates;
+    base::DelegateSimpleThreadPool pool("AdBlockEngineTest", thread_count);
+    pool.Start();
+    for (int i = 0; i < thread_count; ++i) {
+      delegates.push_back(std::make_unique<MatchingDelegate>(engine_.get()));
+      pool.AddWork(delegates.back().get());
+    }
+    for (int i = 0; i < 10; ++i) {
+      engine_->EnableTag("test-tag", i % 2 == 0);
+      engine_->Load(false, ToBuffer(kFilters), "[]");
+    }
+    pool.JoinAll();
+
+    int mismatches = 0;
+    for (const auto& delegate : delegates) {
+      mismatches += delegate->mismatches();
+    }
+    return mismatches;
+  }
+#endif  // BUILDFLAG(ENABLE_ADBLOCK_CONCURRENT_MATCHING)
+
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<AdBlockEngine> engine_;
+};
+
+#if BUILDFLAG(ENABLE_ADBLOCK_CONCURRENT_MATCHING)
+TEST_F(AdBlockEngineConcurrencyTest, ConsistentResultsAcrossSnapshotSwaps) {
+  EXPECT_EQ(0, RunMatchingThreads(4));
+  EXPECT_FALSE(engine_->TagExists("test-tag"));
+}
+#endif  // BUILDFLAG(ENABLE_ADBLOCK_CONCURRENT_MATCHING)
+
+TEST_F(AdBlockEngineConcurrencyTest, TagsSurviveSnapshotRebuild) {
+  engine_->EnableTag("test-tag", true);
+  engine_->Load(false, ToBuffer(kFilters), "[]");
+  EXPECT_TRUE(engine_->TagExists("test-tag"));
+
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string mock_data_url;
+  std::string rewritten_url;
+  engine_->ShouldStartRequest(GURL("https://ads.example/banner.png"),
+                              blink::mojom::ResourceType::kImage,
+                              "first-party.example", false, &did_match_rule,
+                              &did_match_exception, &did_match_important,
+                              &mock_data_url, &rewritten_url);
+  EXPECT_TRUE(did_match_rule);
+
+  // Later rebuilds start from the list as serialized by the first one, and
+  // changes made in a row share one rebuild.
+  EngineUpdateCounter counter;
+  engine_->AddObserverForTest(&counter);
+  engine_->EnableTag("other-tag", true);
+  engine_->EnableTag("test-tag", false);
+  task_environment_.RunUntilIdle();
+  engine_->RemoveObserverForTest();
+  EXPECT_EQ(1, counter.updates());
+  did_match_rule = false;
+  engine_->ShouldStartRequest(GURL("https://ads.example/banner.png"),
+                              blink::mojom::ResourceType::kImage,
+                              "first-party.example", false, &did_match_rule,
+                              &did_match_exception, &did_match_important,
+                              &mock_data_url, &rewritten_url);
+  EXPECT_FALSE(did_match_rule);
+  did_match_rule = false;
+  engine_->ShouldStartRequest(GURL("https://tracker.example/script.js"),
+                              blink::mojom::ResourceType::kScript,
+                              "first-party.example", false, &did_match_rule,
+                              &did_match_exception, &did_match_important,
+                              &mock_data_url, &rewritten_url);
+  EXPECT_TRUE(did_match_rule);
+}
+
+TEST_F(AdBlockEngineConcurrencyTest, RecordsTimeToFirstEngineOnce) {
+  base::HistogramTester histogram_tester;
+  engine_ = std::make_unique<AdBlockEngine>(/*concurrent_matching=*/true);
+  engine_->SetLoadStartTime(base::TimeTicks::Now());
+  engine_->Load(false, ToBuffer(kFilters), "[]");
+  engine_->Load(false, ToBuffer(kFilters), "[]");
+  histogram_tester.ExpectTotalCount("Brave.Adblock.TimeToFirstEngine", 1);
+}
+
+TEST_F(AdBlockEngineConcurrencyTest, LoadFromMappedFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath list_file_path =
+      temp_dir.GetPath().AppendASCII("list.txt");
+  ASSERT_TRUE(base::WriteFile(list_file_path, "||mapped.example^\n"));
+
+  engine_->LoadFromFile(false, list_file_path, "[]");
+
+  AdBlockRequestResult mapped_result;
+  engine_->ShouldStartRequest(
+      GURL("https://mapped.example/ad.js"), blink::mojom::ResourceType::kScript,
+      "first-party.example", false, &mapped_result.did_match_rule,
+      &mapped_result.did_match_exception, &mapped_result.did_match_important,
+      &mapped_result.mock_data_url, &mapped_result.rewritten_url);
+  EXPECT_TRUE(mapped_result.did_match_rule);
+
+  // Rebuilding the snapshot keeps the mapped list.
+  engine_->EnableTag("test-tag", true);
+  task_environment_.RunUntilIdle();
+  AdBlockRequestResult previous_list_result;
+  engine_->ShouldStartRequest(
+      GURL("https://tracker.example/script.js"),
+      blink::mojom::ResourceType::kScript, "first-party.example", false,
+      &previous_list_result.did_match_rule,
+      &previous_list_result.did_match_exception,
+      &previous_list_result.did_match_important,
+      &previous_list_result.mock_data_url,
+      &previous_list_result.rewritten_url);
+  EXPECT_FALSE(previous_list_result.did_match_rule);
+
+  // A missing file leaves the current engine in place.
+  engine_->LoadFromFile(false, temp_dir.GetPath().AppendASCII("missing.txt"),
+                        "[]");
+  mapped_result = AdBlockRequestResult();
+  engine_->ShouldStartRequest(
+      GURL("https://mapped.example/ad.js"), blink::mojom::ResourceType::kScript,
+      "first-party.example", false, &mapped_result.did_match_rule,
+      &mapped_result.did_match_exception, &mapped_result.did_match_important,
+      &mapped_result.mock_data_url, &mapped_result.rewritten_url);
+  EXPECT_TRUE(mapped_result.did_match_rule);
+}
+
+}  // namespace brave_shields
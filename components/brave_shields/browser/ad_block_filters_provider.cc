@@ -37,6 +37,10 @@ void AdBlockFiltersProvider::LoadDAT(
   LoadDATBuffer(std::move(cb));
 }
 
+base::FilePath AdBlockFiltersProvider::GetListFilePath() const {
+  return base::FilePath();
+}
+
 base::WeakPtr<AdBlockFiltersProvider> AdBlockFiltersProvider::AsWeakPtr() {
   return weak_factory_.GetWeakPtr();
 }
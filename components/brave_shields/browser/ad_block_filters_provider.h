@@ -6,6 +6,7 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_FILTERS_PROVIDER_H_
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_FILTERS_PROVIDER_H_
 
+#include "base/files/file_path.h"
 #include "base/functional/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
@@ -36,6 +37,12 @@ class AdBlockFiltersProvider {
   void LoadDAT(base::OnceCallback<void(bool deserialize,
                                        const DATFileDataBuffer& dat_buf)>);
 
+  // Returns the path of a file containing this provider's complete filter
+  // list source, if one is available on disk, so that it can be mapped into
+  // memory instead of being read through `LoadDAT`. Returns an empty path
+  // otherwise.
+  virtual base::FilePath GetListFilePath() const;
+
   base::WeakPtr<AdBlockFiltersProvider> AsWeakPtr();
 
  protected:
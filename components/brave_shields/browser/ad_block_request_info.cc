@@ -0,0 +1,38 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_request_info.h"
+
+namespace brave_shields {
+
+AdBlockRequestInfo::AdBlockRequestInfo() = default;
+
+AdBlockRequestInfo::AdBlockRequestInfo(const GURL& url,
+                                       blink::mojom::ResourceType resource_type,
+                                       const std::string& tab_host,
+                                       bool aggressive_blocking)
+    : url(url),
+      resource_type(resource_type),
+      tab_host(tab_host),
+      aggressive_blocking(aggressive_blocking) {}
+
+AdBlockRequestInfo::AdBlockRequestInfo(const AdBlockRequestInfo&) = default;
+
+AdBlockRequestInfo& AdBlockRequestInfo::operator=(const AdBlockRequestInfo&) =
+    default;
+
+AdBlockRequestInfo::~AdBlockRequestInfo() = default;
+
+AdBlockRequestResult::AdBlockRequestResult() = default;
+
+AdBlockRequestResult::AdBlockRequestResult(const AdBlockRequestResult&) =
+    default;
+
+AdBlockRequestResult& AdBlockRequestResult::operator=(
+    const AdBlockRequestResult&) = default;
+
+AdBlockRequestResult::~AdBlockRequestResult() = default;
+
+}  // namespace brave_shields
@@ -0,0 +1,51 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_REQUEST_INFO_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_REQUEST_INFO_H_
+
+#include <string>
+
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+// A single subresource request to be checked by the adblock engines.
+struct AdBlockRequestInfo {
+  AdBlockRequestInfo();
+  AdBlockRequestInfo(const GURL& url,
+                     blink::mojom::ResourceType resource_type,
+                     const std::string& tab_host,
+                     bool aggressive_blocking);
+  AdBlockRequestInfo(const AdBlockRequestInfo&);
+  AdBlockRequestInfo& operator=(const AdBlockRequestInfo&);
+  ~AdBlockRequestInfo();
+
+  GURL url;
+  blink::mojom::ResourceType resource_type =
+      blink::mojom::ResourceType::kSubResource;
+  std::string tab_host;
+  bool aggressive_blocking = false;
+};
+
+// The outcome of checking an `AdBlockRequestInfo`, equivalent to the
+// out-parameters of `AdBlockService::ShouldStartRequest`.
+struct AdBlockRequestResult {
+  AdBlockRequestResult();
+  AdBlockRequestResult(const AdBlockRequestResult&);
+  AdBlockRequestResult& operator=(const AdBlockRequestResult&);
+  ~AdBlockRequestResult();
+
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string mock_data_url;
+  std::string rewritten_url;
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_REQUEST_INFO_H_
@@ -17,17 +17,24 @@
 #include "base/memory/ptr_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/thread_pool.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
 #include "brave/components/brave_shields/browser/ad_block_component_filters_provider.h"
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_provider.h"
+#include "brave/components/brave_shields/browser/ad_block_decision_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_default_resource_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_engine.h"
+#include "brave/components/brave_shields/browser/ad_block_engine_compiler.h"
 #include "brave/components/brave_shields/browser/ad_block_filter_list_catalog_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
+#include "brave/components/brave_shields/browser/ad_block_request_info.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager.h"
 #include "brave/components/brave_shields/common/adblock_domain_resolver.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "brave/components/brave_shields/common/buildflags/buildflags.h"
 #include "brave/components/brave_shields/common/features.h"
 #include "brave/components/brave_shields/common/pref_names.h"
 #include "components/prefs/pref_change_registrar.h"
@@ -50,6 +57,9 @@ const char kAdBlockComponentBase64PublicKey[] =
     "q+SDNXROG554RnU4BnDJaNETTkDTZ0Pn+rmLmp1qY5Si0yGsfHkrv3FS3vdxVozO"
     "PQIDAQAB";
 
+// Directory under the profile in which compiled engines are cached.
+const char kAdBlockEngineCacheDirName[] = "AdBlockEngineCache";
+
 std::string g_ad_block_component_id_(kAdBlockComponentId);
 std::string g_ad_block_component_base64_public_key_(
     kAdBlockComponentBase64PublicKey);
@@ -58,19 +68,53 @@ std::string g_ad_block_component_base64_public_key_(
 
 namespace brave_shields {
 
+namespace {
+
+// Sharing an engine between matching threads needs adblock-rust's thread-safe
+// regex cache, which is only built in with the build flag.
+bool IsConcurrentMatchingEnabled() {
+#if BUILDFLAG(ENABLE_ADBLOCK_CONCURRENT_MATCHING)
+  return base::FeatureList::IsEnabled(features::kAdblockConcurrentMatching);
+#else
+  return false;
+#endif
+}
+
+// Either cache may be null if its feature is disabled.
+void ClearCaches(
+    scoped_refptr<AdBlockDecisionCache> decision_cache,
+    scoped_refptr<AdBlockCosmeticResourcesCache> cosmetic_resources_cache) {
+  if (decision_cache) {
+    decision_cache->Clear();
+  }
+  if (cosmetic_resources_cache) {
+    cosmetic_resources_cache->Clear();
+  }
+}
+
+}  // namespace
+
 AdBlockService::SourceProviderObserver::SourceProviderObserver(
     AdBlockEngine* adblock_engine,
     AdBlockFiltersProvider* filters_provider,
     AdBlockResourceProvider* resource_provider,
-    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    const base::FilePath& engine_cache_dir,
+    const std::string& engine_cache_name)
     : adblock_engine_(adblock_engine),
+      engine_cache_dir_(engine_cache_dir),
+      engine_cache_name_(engine_cache_name),
       filters_provider_(filters_provider),
       resource_provider_(resource_provider),
       task_runner_(task_runner) {
+  if (!engine_cache_dir_.empty() &&
+      base::FeatureList::IsEnabled(features::kAdblockBackgroundCompilation)) {
+    compile_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+        {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+  }
   filters_provider_->AddObserver(this);
-  filters_provider_->LoadDAT(
-      base::BindOnce(&AdBlockService::SourceProviderObserver::OnDATLoaded,
-                     weak_factory_.GetWeakPtr()));
+  LoadFilters();
 }
 
 AdBlockService::SourceProviderObserver::~SourceProviderObserver() {
@@ -79,6 +123,26 @@ AdBlockService::SourceProviderObserver::~SourceProviderObserver() {
 }
 
 void AdBlockService::SourceProviderObserver::OnChanged() {
+  LoadFilters();
+}
+
+void AdBlockService::SourceProviderObserver::LoadFilters() {
+  if (base::FeatureList::IsEnabled(features::kAdblockMappedListLoading)) {
+    base::FilePath list_file_path = filters_provider_->GetListFilePath();
+    if (!list_file_path.empty()) {
+      // The file is mapped on the engine's task runner, so there is no need
+      // to read it here first.
+      deserialize_ = false;
+      dat_buf_.clear();
+      list_file_path_ = std::move(list_file_path);
+      resource_provider_->AddObserver(this);
+      resource_provider_->LoadResources(
+          base::BindOnce(&SourceProviderObserver::OnResourcesLoaded,
+                         weak_factory_.GetWeakPtr()));
+      return;
+    }
+  }
+
   filters_provider_->LoadDAT(
       base::BindOnce(&AdBlockService::SourceProviderObserver::OnDATLoaded,
                      weak_factory_.GetWeakPtr()));
@@ -89,6 +153,7 @@ void AdBlockService::SourceProviderObserver::OnDATLoaded(
     const DATFileDataBuffer& dat_buf) {
   deserialize_ = deserialize;
   dat_buf_ = std::move(dat_buf);
+  list_file_path_.clear();
   // multiple AddObserver calls are ignored
   resource_provider_->AddObserver(this);
   resource_provider_->LoadResources(base::BindOnce(
@@ -97,11 +162,40 @@ void AdBlockService::SourceProviderObserver::OnDATLoaded(
 
 void AdBlockService::SourceProviderObserver::OnResourcesLoaded(
     const std::string& resources_json) {
-  if (dat_buf_.empty()) {
-    task_runner_->PostTask(
+  if (!list_file_path_.empty()) {
+    PostEngineTask(base::BindOnce(&AdBlockEngine::LoadFromFile,
+                                  adblock_engine_->AsWeakPtr(), deserialize_,
+                                  list_file_path_, resources_json));
+    // Later resource updates only need to be applied to the existing engine.
+    list_file_path_.clear();
+  } else if (dat_buf_.empty()) {
+    PostEngineTask(base::BindOnce(&AdBlockEngine::UseResources,
+                                  adblock_engine_->AsWeakPtr(),
+                                  resources_json));
+  } else if (compile_task_runner_ && !deserialize_) {
+    // Compile (or fetch from the cache) off the engine sequence, so that
+    // matching continues against the current engine until the new one is
+    // ready. Tasks on |compile_task_runner_| run in order, so a newer list
+    // can't be swapped in before an older one.
+    ++pending_compiles_;
+    compile_task_runner_->PostTaskAndReply(
         FROM_HERE,
-        base::BindOnce(&AdBlockEngine::UseResources,
-                       adblock_engine_->AsWeakPtr(), resources_json));
+        base::BindOnce(
+            [](base::FilePath cache_dir, std::string cache_name,
+               DATFileDataBuffer dat_buf, std::string resources_json,
+               scoped_refptr<base::SequencedTaskRunner> task_runner,
+               base::WeakPtr<AdBlockEngine> engine) {
+              CompiledAdBlockEngine compiled =
+                  CompileAdBlockEngine(cache_dir, cache_name, dat_buf);
+              task_runner->PostTask(
+                  FROM_HERE, base::BindOnce(&AdBlockEngine::UseCompiledEngine,
+                                            engine, std::move(compiled),
+                                            resources_json));
+            },
+            engine_cache_dir_, engine_cache_name_, std::move(dat_buf_),
+            resources_json, task_runner_, adblock_engine_->AsWeakPtr()),
+        base::BindOnce(&SourceProviderObserver::OnCompileDone,
+                       weak_factory_.GetWeakPtr()));
   } else {
     auto engine_load_callback = base::BindOnce(
         [](base::WeakPtr<AdBlockEngine> engine, bool deserialize,
@@ -112,8 +206,31 @@ void AdBlockService::SourceProviderObserver::OnResourcesLoaded(
         },
         adblock_engine_->AsWeakPtr(), deserialize_, std::move(dat_buf_),
         resources_json);
-    task_runner_->PostTask(FROM_HERE, std::move(engine_load_callback));
+    PostEngineTask(std::move(engine_load_callback));
+  }
+}
+
+void AdBlockService::SourceProviderObserver::PostEngineTask(
+    base::OnceClosure task) {
+  if (!pending_compiles_) {
+    task_runner_->PostTask(FROM_HERE, std::move(task));
+    return;
   }
+  // The compile task posts its engine to |task_runner_| before finishing, so
+  // forwarding from |compile_task_runner_| keeps |task| behind it.
+  compile_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](scoped_refptr<base::SequencedTaskRunner> task_runner,
+             base::OnceClosure task) {
+            task_runner->PostTask(FROM_HERE, std::move(task));
+          },
+          task_runner_, std::move(task)));
+}
+
+void AdBlockService::SourceProviderObserver::OnCompileDone() {
+  DCHECK_GT(pending_compiles_, 0);
+  --pending_compiles_;
 }
 
 void AdBlockService::ShouldStartRequest(
@@ -126,16 +243,58 @@ void AdBlockService::ShouldStartRequest(
     bool* did_match_important,
     std::string* mock_data_url,
     std::string* rewritten_url) {
-  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  DCHECK(GetMatchingTaskRunner()->RunsTasksInCurrentSequence());
+
+  // Cached decisions only apply to a fresh check, not to one continuing from
+  // the results of an earlier check (e.g. after CNAME uncloaking).
+  const bool is_fresh_check =
+      did_match_rule && !*did_match_rule && did_match_exception &&
+      !*did_match_exception && did_match_important && !*did_match_important &&
+      (!mock_data_url || mock_data_url->empty()) &&
+      (!rewritten_url || rewritten_url->empty());
+  if (!decision_cache_ || !is_fresh_check) {
+    MatchEngines(url, resource_type, tab_host, aggressive_blocking,
+                 did_match_rule, did_match_exception, did_match_important,
+                 mock_data_url, rewritten_url);
+    return;
+  }
 
+  const std::string key = AdBlockDecisionCache::MakeKey(
+      AdBlockRequestInfo(url, resource_type, tab_host, aggressive_blocking));
+  AdBlockRequestResult result;
+  if (!decision_cache_->Get(key, &result)) {
+    const AdBlockDecisionCache::Generation generation =
+        decision_cache_->generation();
+    MatchEngines(url, resource_type, tab_host, aggressive_blocking,
+                 &result.did_match_rule, &result.did_match_exception,
+                 &result.did_match_important, &result.mock_data_url,
+                 &result.rewritten_url);
+    decision_cache_->Put(key, result, generation);
+  }
+
+  *did_match_rule = result.did_match_rule;
+  *did_match_exception = result.did_match_exception;
+  *did_match_important = result.did_match_important;
+  if (mock_data_url) {
+    *mock_data_url = std::move(result.mock_data_url);
+  }
+  if (rewritten_url) {
+    *rewritten_url = std::move(result.rewritten_url);
+  }
+}
+
+void AdBlockService::MatchEngines(const GURL& url,
+                                  blink::mojom::ResourceType resource_type,
+                                  const std::string& tab_host,
+                                  bool aggressive_blocking,
+                                  bool* did_match_rule,
+                                  bool* did_match_exception,
+                                  bool* did_match_important,
+                                  std::string* mock_data_url,
+                                  std::string* rewritten_url) {
   GURL request_url;
 
-  if (aggressive_blocking ||
-      base::FeatureList::IsEnabled(
-          brave_shields::features::kBraveAdblockDefault1pBlocking) ||
-      !SameDomainOrHost(
-          url, url::Origin::CreateFromNormalizedTuple("https", tab_host, 80),
-          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES)) {
+  if (ShouldCheckDefaultEngine(url, tab_host, aggressive_blocking)) {
     request_url =
         rewritten_url && !rewritten_url->empty() ? GURL(*rewritten_url) : url;
     default_engine_->ShouldStartRequest(
@@ -154,11 +313,22 @@ void AdBlockService::ShouldStartRequest(
       did_match_exception, did_match_important, mock_data_url, rewritten_url);
 }
 
+bool AdBlockService::ShouldCheckDefaultEngine(const GURL& url,
+                                              const std::string& tab_host,
+                                              bool aggressive_blocking) const {
+  return aggressive_blocking ||
+         base::FeatureList::IsEnabled(
+             brave_shields::features::kBraveAdblockDefault1pBlocking) ||
+         !SameDomainOrHost(
+             url, url::Origin::CreateFromNormalizedTuple("https", tab_host, 80),
+             net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+}
+
 absl::optional<std::string> AdBlockService::GetCspDirectives(
     const GURL& url,
     blink::mojom::ResourceType resource_type,
     const std::string& tab_host) {
-  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  DCHECK(GetMatchingTaskRunner()->RunsTasksInCurrentSequence());
   auto csp_directives =
       default_engine_->GetCspDirectives(url, resource_type, tab_host);
 
@@ -173,6 +343,17 @@ base::Value::Dict AdBlockService::UrlCosmeticResources(
     const std::string& url,
     bool aggressive_blocking) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  std::string cache_key;
+  if (cosmetic_resources_cache_) {
+    cache_key =
+        AdBlockCosmeticResourcesCache::MakeKey(GURL(url), aggressive_blocking);
+    absl::optional<base::Value::Dict> cached_resources =
+        cosmetic_resources_cache_->Get(cache_key);
+    if (cached_resources) {
+      return std::move(*cached_resources);
+    }
+  }
+
   base::Value::Dict resources = default_engine_->UrlCosmeticResources(url);
 
   if (!aggressive_blocking) {
@@ -199,9 +380,21 @@ base::Value::Dict AdBlockService::UrlCosmeticResources(
   MergeResourcesInto(std::move(additional_resources), resources,
                      /*force_hide=*/true);
 
+  if (cosmetic_resources_cache_) {
+    cosmetic_resources_cache_->Put(cache_key, resources);
+  }
+
   return resources;
 }
 
+base::ReadOnlySharedMemoryRegion
+AdBlockService::GetCosmeticResourcesGenerationRegion() const {
+  if (!cosmetic_resources_cache_) {
+    return base::ReadOnlySharedMemoryRegion();
+  }
+  return cosmetic_resources_cache_->DuplicateGenerationRegion();
+}
+
 // The return value here is formatted differently from the rest of the adblock
 // service instances. We need to distinguish between selectors returned from
 // the default engine and those returned by other engines, but still comply
@@ -216,6 +409,14 @@ base::Value::Dict AdBlockService::HiddenClassIdSelectors(
     const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  // Renderers can only use the unmatched classes and ids while they have the
+  // cosmetic resources cache generation to validate them against.
+  if (cosmetic_resources_cache_ &&
+      base::FeatureList::IsEnabled(
+          features::kCosmeticFilteringUnmatchedClassIdCache)) {
+    return HiddenClassIdSelectorsWithUnmatched(classes, ids, exceptions);
+  }
+
   base::Value::List hide_selectors =
       default_engine_->HiddenClassIdSelectors(classes, ids, exceptions);
 
@@ -231,6 +432,39 @@ base::Value::Dict AdBlockService::HiddenClassIdSelectors(
   return result;
 }
 
+// Same as above, with two more properties listing the classes and ids that
+// have no generic rules in any engine:
+//  - "unmatched_classes"
+//  - "unmatched_ids"
+// Those don't depend on the page, so renderers can avoid querying them again.
+// Exceptions are page-specific, so they are applied after the unmatched tokens
+// have been found rather than by the engines.
+base::Value::Dict AdBlockService::HiddenClassIdSelectorsWithUnmatched(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const std::vector<std::string>& exceptions) {
+  const std::vector<std::string> no_exceptions;
+  base::Value::List hide_selectors =
+      default_engine_->HiddenClassIdSelectors(classes, ids, no_exceptions);
+  base::Value::List force_hide_selectors =
+      additional_filters_engine_->HiddenClassIdSelectors(classes, ids,
+                                                         no_exceptions);
+
+  base::Value::Dict result;
+  result.Set("unmatched_classes",
+             FindUnmatchedTokens(classes, '.',
+                                 {&hide_selectors, &force_hide_selectors}));
+  result.Set("unmatched_ids",
+             FindUnmatchedTokens(ids, '#',
+                                 {&hide_selectors, &force_hide_selectors}));
+
+  RemoveExceptedSelectors(exceptions, hide_selectors);
+  RemoveExceptedSelectors(exceptions, force_hide_selectors);
+  result.Set("hide_selectors", std::move(hide_selectors));
+  result.Set("force_hide_selectors", std::move(force_hide_selectors));
+  return result;
+}
+
 AdBlockRegionalServiceManager* AdBlockService::regional_service_manager() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   return regional_service_manager_.get();
@@ -262,16 +496,54 @@ AdBlockService::AdBlockService(
           std::move(subscription_download_manager_getter)),
       component_update_service_(cus),
       task_runner_(task_runner),
+      matching_task_runner_(
+          IsConcurrentMatchingEnabled()
+              ? base::ThreadPool::CreateTaskRunner(
+                    {base::TaskPriority::USER_BLOCKING,
+                     base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN})
+              : task_runner_),
       default_engine_(std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter>(
-          new AdBlockEngine(),
+          new AdBlockEngine(matching_task_runner_ != task_runner_),
           base::OnTaskRunnerDeleter(GetTaskRunner()))),
       additional_filters_engine_(
           std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter>(
-              new AdBlockEngine(),
+              new AdBlockEngine(matching_task_runner_ != task_runner_),
               base::OnTaskRunnerDeleter(GetTaskRunner()))) {
   // Initializes adblock-rust's domain resolution implementation
   adblock::SetDomainResolver(AdBlockServiceDomainResolver);
 
+  // Posted ahead of any list loads. base::Unretained() is safe because the
+  // engine is deleted on the same sequence.
+  GetTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&AdBlockEngine::SetLoadStartTime,
+                     base::Unretained(default_engine_.get()),
+                     base::TimeTicks::Now()));
+
+  if (base::FeatureList::IsEnabled(features::kAdblockDecisionCache)) {
+    decision_cache_ = base::MakeRefCounted<AdBlockDecisionCache>(
+        features::kAdblockDecisionCacheSize.Get());
+  }
+  if (base::FeatureList::IsEnabled(
+          features::kCosmeticFilteringResourcesCache)) {
+    cosmetic_resources_cache_ =
+        base::MakeRefCounted<AdBlockCosmeticResourcesCache>(
+            features::kCosmeticFilteringResourcesCacheSize.Get());
+  }
+  if (decision_cache_ || cosmetic_resources_cache_) {
+    // base::Unretained() is safe because the engines are deleted on the same
+    // sequence.
+    for (AdBlockEngine* engine :
+         {default_engine_.get(), additional_filters_engine_.get()}) {
+      GetTaskRunner()->PostTask(
+          FROM_HERE,
+          base::BindOnce(&AdBlockEngine::SetStateChangedCallback,
+                         base::Unretained(engine),
+                         base::BindRepeating(&ClearCaches, decision_cache_,
+                                             cosmetic_resources_cache_)));
+    }
+  }
+
   if (base::FeatureList::IsEnabled(
           features::kAdblockOverrideRegexDiscardPolicy)) {
     adblock::RegexManagerDiscardPolicy policy;
@@ -301,14 +573,17 @@ AdBlockService::AdBlockService(
   custom_filters_provider_ =
       std::make_unique<AdBlockCustomFiltersProvider>(local_state_);
 
+  const base::FilePath engine_cache_dir =
+      profile_dir_.AppendASCII(kAdBlockEngineCacheDirName);
   default_service_observer_ = std::make_unique<SourceProviderObserver>(
       default_engine_.get(), default_filters_provider_.get(),
-      resource_provider_.get(), GetTaskRunner());
+      resource_provider_.get(), GetTaskRunner(), engine_cache_dir, "default");
   additional_filters_service_observer_ =
       std::make_unique<SourceProviderObserver>(
           additional_filters_engine_.get(),
           AdBlockFiltersProviderManager::GetInstance(),
-          resource_provider_.get(), GetTaskRunner());
+          resource_provider_.get(), GetTaskRunner(), engine_cache_dir,
+          "additional");
 }
 
 AdBlockService::~AdBlockService() = default;
@@ -362,6 +637,10 @@ base::SequencedTaskRunner* AdBlockService::GetTaskRunner() {
   return task_runner_.get();
 }
 
+scoped_refptr<base::TaskRunner> AdBlockService::GetMatchingTaskRunner() {
+  return matching_task_runner_;
+}
+
 void RegisterPrefsForAdBlockService(PrefRegistrySimple* registry) {
   registry->RegisterBooleanPref(prefs::kAdBlockCookieListOptInShown, false);
   registry->RegisterBooleanPref(prefs::kAdBlockCookieListSettingTouched, false);
@@ -402,6 +681,15 @@ void AdBlockService::OnGetDebugInfoFromDefaultEngine(
     base::Value::Dict default_engine_debug_info) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+  if (decision_cache_) {
+    default_engine_debug_info.Set("decision_cache",
+                                  decision_cache_->GetDebugInfo());
+  }
+  if (cosmetic_resources_cache_) {
+    default_engine_debug_info.Set("cosmetic_resources_cache",
+                                  cosmetic_resources_cache_->GetDebugInfo());
+  }
+
   // base::Unretained() is safe because |additional_filters_engine_| is deleted
   // on the same sequence. See docs/threading_and_tasks_testing.md for
   // explanations.
@@ -13,10 +13,12 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
 #include "base/task/sequenced_task_runner.h"
+#include "base/task/task_runner.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_filters_provider.h"
 #include "brave/components/brave_shields/browser/ad_block_filters_provider_manager.h"
@@ -41,6 +43,8 @@ struct RegexManagerDiscardPolicy;
 }
 namespace brave_shields {
 
+class AdBlockCosmeticResourcesCache;
+class AdBlockDecisionCache;
 class AdBlockEngine;
 class AdBlockComponentFiltersProvider;
 class AdBlockDefaultResourceProvider;
@@ -55,17 +59,30 @@ class AdBlockService {
   class SourceProviderObserver : public AdBlockResourceProvider::Observer,
                                  public AdBlockFiltersProvider::Observer {
    public:
+    // If |engine_cache_dir| is not empty and the AdblockBackgroundCompilation
+    // feature is enabled, filter list sources are compiled on a separate low
+    // priority sequence and cached in |engine_cache_dir| under
+    // |engine_cache_name|.
     SourceProviderObserver(
         AdBlockEngine* adblock_engine,
         AdBlockFiltersProvider* source_provider,
         AdBlockResourceProvider* resource_provider,
-        scoped_refptr<base::SequencedTaskRunner> task_runner);
+        scoped_refptr<base::SequencedTaskRunner> task_runner,
+        const base::FilePath& engine_cache_dir = base::FilePath(),
+        const std::string& engine_cache_name = std::string());
     SourceProviderObserver(const SourceProviderObserver&) = delete;
     SourceProviderObserver& operator=(const SourceProviderObserver&) = delete;
     ~SourceProviderObserver() override;
 
    private:
+    // Loads the provider's filters, either as a buffer through `LoadDAT` or,
+    // when mapped list loading applies, by noting the list file to map.
+    void LoadFilters();
     void OnDATLoaded(bool deserialize, const DATFileDataBuffer& dat_buf);
+    // Posts |task| to |task_runner_|, behind the result of any compile still
+    // in flight so that the compiled engine can't override a later update.
+    void PostEngineTask(base::OnceClosure task);
+    void OnCompileDone();
 
     // AdBlockFiltersProvider::Observer
     void OnChanged() override;
@@ -75,7 +92,17 @@ class AdBlockService {
 
     bool deserialize_;
     DATFileDataBuffer dat_buf_;
+    // Set instead of |dat_buf_| when the list will be mapped by the engine.
+    base::FilePath list_file_path_;
     raw_ptr<AdBlockEngine> adblock_engine_;
+    base::FilePath engine_cache_dir_;
+    std::string engine_cache_name_;
+    // Sequence on which filter lists are compiled; null if lists are compiled
+    // on |task_runner_|.
+    scoped_refptr<base::SequencedTaskRunner> compile_task_runner_;
+    // Number of compiles posted to |compile_task_runner_| whose engine hasn't
+    // yet been posted to |task_runner_|.
+    int pending_compiles_ = 0;
     raw_ptr<AdBlockFiltersProvider> filters_provider_;    // not owned
     raw_ptr<AdBlockResourceProvider> resource_provider_;  // not owned
     scoped_refptr<base::SequencedTaskRunner> task_runner_;
@@ -113,6 +140,10 @@ class AdBlockService {
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
+  // Returns the region renderers map to validate their cached
+  // `UrlCosmeticResources` results, or an invalid region if caching is
+  // disabled.
+  base::ReadOnlySharedMemoryRegion GetCosmeticResourcesGenerationRegion() const;
 
   AdBlockRegionalServiceManager* regional_service_manager();
   AdBlockSubscriptionServiceManager* subscription_service_manager();
@@ -129,6 +160,10 @@ class AdBlockService {
   void SetupDiscardPolicy(const adblock::RegexManagerDiscardPolicy& policy);
 
   base::SequencedTaskRunner* GetTaskRunner();
+  // Task runner on which `ShouldStartRequest` and `GetCspDirectives` may be
+  // called. Unsequenced when concurrent matching is enabled, otherwise the
+  // same as `GetTaskRunner()`.
+  scoped_refptr<base::TaskRunner> GetMatchingTaskRunner();
 
   void UseSourceProvidersForTest(AdBlockFiltersProvider* source_provider,
                                  AdBlockResourceProvider* resource_provider);
@@ -147,6 +182,29 @@ class AdBlockService {
     return default_filters_provider_.get();
   }
 
+  // Checks the request against the default and additional engines, without
+  // consulting the decision cache.
+  void MatchEngines(const GURL& url,
+                    blink::mojom::ResourceType resource_type,
+                    const std::string& tab_host,
+                    bool aggressive_blocking,
+                    bool* did_match_rule,
+                    bool* did_match_exception,
+                    bool* did_match_important,
+                    std::string* mock_data_url,
+                    std::string* rewritten_url);
+
+  // Whether a request should be checked against the default engine, which is
+  // skipped for first-party requests in standard blocking mode.
+  bool ShouldCheckDefaultEngine(const GURL& url,
+                                const std::string& tab_host,
+                                bool aggressive_blocking) const;
+
+  base::Value::Dict HiddenClassIdSelectorsWithUnmatched(
+      const std::vector<std::string>& classes,
+      const std::vector<std::string>& ids,
+      const std::vector<std::string>& exceptions);
+
   void OnGetDebugInfoFromDefaultEngine(
       GetDebugInfoCallback callback,
       base::Value::Dict default_engine_debug_info);
@@ -164,6 +222,7 @@ class AdBlockService {
   raw_ptr<component_updater::ComponentUpdateService> component_update_service_;
 
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  scoped_refptr<base::TaskRunner> matching_task_runner_;
 
   std::unique_ptr<AdBlockDefaultResourceProvider> resource_provider_
       GUARDED_BY_CONTEXT(sequence_checker_);
@@ -178,6 +237,11 @@ class AdBlockService {
   std::unique_ptr<AdBlockRegionalServiceManager> regional_service_manager_
       GUARDED_BY_CONTEXT(sequence_checker_);
 
+  // Null when the decision cache is disabled.
+  scoped_refptr<AdBlockDecisionCache> decision_cache_;
+  // Null when the cosmetic resources cache is disabled.
+  scoped_refptr<AdBlockCosmeticResourcesCache> cosmetic_resources_cache_;
+
   std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter> default_engine_;
   std::unique_ptr<AdBlockEngine, base::OnTaskRunnerDeleter>
       additional_filters_engine_;
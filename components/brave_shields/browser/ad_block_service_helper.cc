@@ -7,6 +7,8 @@
 
 #include <utility>
 
+#include "base/containers/contains.h"
+#include "base/containers/flat_set.h"
 #include "base/strings/strcat.h"
 #include "base/values.h"
 
@@ -102,4 +104,51 @@ void MergeResourcesInto(base::Value::Dict from,
   }
 }
 
+// Generic class and id rules are keyed by the first class or id in their
+// selector, so a token can only have matched if it appears, with its prefix,
+// in one of the returned selectors. Looking for it anywhere in the selector
+// errs on the side of reporting a token as matched.
+base::Value::List FindUnmatchedTokens(
+    const std::vector<std::string>& tokens,
+    char prefix,
+    const std::vector<const base::Value::List*>& selector_lists) {
+  base::Value::List unmatched;
+  for (const auto& token : tokens) {
+    std::string prefixed_token(1, prefix);
+    prefixed_token += token;
+    bool matched = false;
+    for (const base::Value::List* selectors : selector_lists) {
+      for (const auto& selector : *selectors) {
+        const std::string* selector_string = selector.GetIfString();
+        if (selector_string &&
+            selector_string->find(prefixed_token) != std::string::npos) {
+          matched = true;
+          break;
+        }
+      }
+      if (matched) {
+        break;
+      }
+    }
+    if (!matched) {
+      unmatched.Append(token);
+    }
+  }
+  return unmatched;
+}
+
+void RemoveExceptedSelectors(const std::vector<std::string>& exceptions,
+                             base::Value::List& selectors) {
+  if (exceptions.empty()) {
+    return;
+  }
+
+  const base::flat_set<std::string> exception_set(exceptions.begin(),
+                                                  exceptions.end());
+  selectors.EraseIf([&exception_set](const base::Value& selector) {
+    const std::string* selector_string = selector.GetIfString();
+    return selector_string && base::Contains(exception_set, *selector_string);
+  });
+}
+
 }  // namespace brave_shields
@@ -23,6 +23,17 @@ void MergeResourcesInto(base::Value::Dict from,
                         base::Value::Dict& into,
                         bool force_hide);
 
+// Returns the entries of |tokens| that don't appear after |prefix| ('.' for
+// classes, '#' for ids) in any of |selector_lists|.
+base::Value::List FindUnmatchedTokens(
+    const std::vector<std::string>& tokens,
+    char prefix,
+    const std::vector<const base::Value::List*>& selector_lists);
+
+// Removes every selector that is listed in |exceptions| from |selectors|.
+void RemoveExceptedSelectors(const std::vector<std::string>& exceptions,
+                             base::Value::List& selectors);
+
 }  // namespace brave_shields
 
 #endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_SERVICE_HELPER_H_
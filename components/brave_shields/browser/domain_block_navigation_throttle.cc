@@ -129,7 +129,7 @@ DomainBlockNavigationThrottle::WillStartRequest() {
 
   // Otherwise, call the ad block service on a task runner to determine whether
   // this domain should be blocked.
-  ad_block_service_->GetTaskRunner()->PostTaskAndReplyWithResult(
+  ad_block_service_->GetMatchingTaskRunner()->PostTaskAndReplyWithResult(
       FROM_HERE,
       base::BindOnce(&ShouldBlockDomainOnTaskRunner, ad_block_service_,
                      request_url),
@@ -0,0 +1,60 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <string>
+#include <vector>
+
+#include "base/values.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+base::Value::List MakeList(const std::vector<std::string>& items) {
+  base::Value::List list;
+  for (const auto& item : items) {
+    list.Append(item);
+  }
+  return list;
+}
+
+}  // namespace
+
+TEST(HiddenClassIdSelectorsTest, FindUnmatchedClasses) {
+  const base::Value::List hide_selectors = MakeList({".ad", ".banner > img"});
+  const base::Value::List force_hide_selectors = MakeList({".sponsored"});
+
+  EXPECT_EQ(MakeList({"content", "nav"}),
+            FindUnmatchedTokens(
+                {"ad", "content", "banner", "sponsored", "nav"}, '.',
+                {&hide_selectors, &force_hide_selectors}));
+}
+
+TEST(HiddenClassIdSelectorsTest, FindUnmatchedIdsUsesIdPrefix) {
+  const base::Value::List hide_selectors = MakeList({".ad", "#promo"});
+
+  EXPECT_EQ(MakeList({"ad"}),
+            FindUnmatchedTokens({"ad", "promo"}, '#', {&hide_selectors}));
+}
+
+TEST(HiddenClassIdSelectorsTest, NoSelectorsMeansAllUnmatched) {
+  const base::Value::List hide_selectors;
+
+  EXPECT_EQ(MakeList({"a", "b"}),
+            FindUnmatchedTokens({"a", "b"}, '.', {&hide_selectors}));
+}
+
+TEST(HiddenClassIdSelectorsTest, RemoveExceptedSelectors) {
+  base::Value::List selectors = MakeList({".ad", "#promo", ".banner"});
+  RemoveExceptedSelectors({"#promo", ".unrelated"}, selectors);
+  EXPECT_EQ(MakeList({".ad", ".banner"}), selectors);
+
+  RemoveExceptedSelectors({}, selectors);
+  EXPECT_EQ(MakeList({".ad", ".banner"}), selectors);
+}
+
+}  // namespace brave_shields
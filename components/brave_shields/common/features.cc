@@ -88,6 +88,24 @@ BASE_FEATURE(kCosmeticFilteringExtraPerfMetrics,
              "CosmeticFilteringExtraPerfMetrics",
              base::FEATURE_DISABLED_BY_DEFAULT);
 
+// When enabled, `UrlCosmeticResources` results are cached in the browser and
+// in each renderer until the state of any adblock engine changes, so that
+// subframes and repeat visits don't need a blocking IPC.
+BASE_FEATURE(kCosmeticFilteringResourcesCache,
+             "CosmeticFilteringResourcesCache",
+             base::FEATURE_ENABLED_BY_DEFAULT);
+
+constexpr base::FeatureParam<int> kCosmeticFilteringResourcesCacheSize{
+    &kCosmeticFilteringResourcesCache, "size", 256};
+
+// When enabled along with kCosmeticFilteringResourcesCache,
+// `HiddenClassIdSelectors` results report the classes and ids that have no
+// generic hide rules, and each renderer remembers them until the state of any
+// adblock engine changes so that they aren't queried again.
+BASE_FEATURE(kCosmeticFilteringUnmatchedClassIdCache,
+             "CosmeticFilteringUnmatchedClassIdCache",
+             base::FEATURE_ENABLED_BY_DEFAULT);
+
 BASE_FEATURE(kCosmeticFilteringJsPerformance,
              "CosmeticFilteringJsPerformance",
              base::FEATURE_ENABLED_BY_DEFAULT);
@@ -106,6 +124,38 @@ constexpr base::FeatureParam<std::string>
     kCosmeticFilteringFetchNewClassIdRulesThrottlingMs{
         &kCosmeticFilteringJsPerformance, "fetch_throttling_ms", "100"};
 
+// When enabled, filter lists are compiled into engines on a separate, lower
+// priority sequence and only swapped in once ready. Compiled engines are
+// cached on disk keyed by list contents, so unchanged lists are deserialized
+// rather than parsed again on the next startup.
+BASE_FEATURE(kAdblockBackgroundCompilation,
+             "AdblockBackgroundCompilation",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+// When enabled, network requests are matched against immutable snapshots of
+// the adblock engines from a pool of threads rather than on the single adblock
+// sequence. Filter list updates build a new engine and publish it atomically.
+// Only has an effect in builds with enable_adblock_concurrent_matching.
+BASE_FEATURE(kAdblockConcurrentMatching,
+             "AdblockConcurrentMatching",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+// When enabled, network blocking decisions are cached per (url, resource type,
+// tab host, aggressive blocking) until the state of any adblock engine changes.
+BASE_FEATURE(kAdblockDecisionCache,
+             "AdblockDecisionCache",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+constexpr base::FeatureParam<int> kAdblockDecisionCacheSize{
+    &kAdblockDecisionCache, "size", 4096};
+
+// When enabled, filter lists that are available as a single file on disk (the
+// default and regional component lists) are memory-mapped and handed to the
+// adblock engine directly, instead of first being read into a heap buffer.
+BASE_FEATURE(kAdblockMappedListLoading,
+             "AdblockMappedListLoading",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 BASE_FEATURE(kAdblockOverrideRegexDiscardPolicy,
              "AdblockOverrideRegexDiscardPolicy",
              base::FEATURE_DISABLED_BY_DEFAULT);
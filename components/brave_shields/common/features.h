@@ -28,6 +28,9 @@ BASE_DECLARE_FEATURE(kBraveReduceLanguage);
 BASE_DECLARE_FEATURE(kBraveDarkModeBlock);
 BASE_DECLARE_FEATURE(kCosmeticFilteringSyncLoad);
 BASE_DECLARE_FEATURE(kCosmeticFilteringExtraPerfMetrics);
+BASE_DECLARE_FEATURE(kCosmeticFilteringResourcesCache);
+extern const base::FeatureParam<int> kCosmeticFilteringResourcesCacheSize;
+BASE_DECLARE_FEATURE(kCosmeticFilteringUnmatchedClassIdCache);
 BASE_DECLARE_FEATURE(kCosmeticFilteringJsPerformance);
 extern const base::FeatureParam<std::string>
     kCosmeticFilteringSubFrameFirstSelectorsPollingDelayMs;
@@ -35,6 +38,11 @@ extern const base::FeatureParam<std::string>
     kCosmeticFilteringswitchToSelectorsPollingThreshold;
 extern const base::FeatureParam<std::string>
     kCosmeticFilteringFetchNewClassIdRulesThrottlingMs;
+BASE_DECLARE_FEATURE(kAdblockBackgroundCompilation);
+BASE_DECLARE_FEATURE(kAdblockConcurrentMatching);
+BASE_DECLARE_FEATURE(kAdblockDecisionCache);
+extern const base::FeatureParam<int> kAdblockDecisionCacheSize;
+BASE_DECLARE_FEATURE(kAdblockMappedListLoading);
 BASE_DECLARE_FEATURE(kAdblockOverrideRegexDiscardPolicy);
 extern const base::FeatureParam<int>
     kAdblockOverrideRegexDiscardPolicyCleanupIntervalSec;
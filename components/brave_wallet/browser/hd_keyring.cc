@@ -30,8 +30,7 @@ std::vector<AddedAcountInfo> HDKeyring::AddAccounts(size_t number) {
   size_t cur_accounts_number = accounts_.size();
   for (size_t i = cur_accounts_number; i < cur_accounts_number + number; ++i) {
     auto& added_account = accounts_.emplace_back(DeriveAccount(i));
-    result.push_back(
-        {added_account->GetPath(), GetAddressInternal(added_account.get())});
+    result.push_back({added_account->GetPath(), GetAddress(i)});
   }
 
   return result;
@@ -47,6 +46,9 @@ std::vector<std::string> HDKeyring::GetAccounts() const {
 
 void HDKeyring::RemoveAccount() {
   accounts_.pop_back();
+  if (account_addresses_.size() > accounts_.size()) {
+    account_addresses_.resize(accounts_.size());
+  }
 }
 
 bool HDKeyring::AddImportedAddress(const std::string& address,
@@ -88,7 +90,13 @@ bool HDKeyring::RemoveImportedAccount(const std::string& address) {
 std::string HDKeyring::GetAddress(size_t index) const {
   if (accounts_.empty() || index >= accounts_.size())
     return std::string();
-  return GetAddressInternal(accounts_[index].get());
+  // Addresses are hashed or encoded from public keys, so they are computed
+  // once per account rather than on every lookup.
+  while (account_addresses_.size() <= index) {
+    account_addresses_.push_back(
+        GetAddressInternal(accounts_[account_addresses_.size()].get()));
+  }
+  return account_addresses_[index];
 }
 
 std::string HDKeyring::GetDiscoveryAddress(size_t index) const {
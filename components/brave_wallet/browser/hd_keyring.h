@@ -71,6 +71,8 @@ class HDKeyring {
 
   std::unique_ptr<HDKeyBase> root_;
   std::vector<std::unique_ptr<HDKeyBase>> accounts_;
+  // Addresses of |accounts_|, filled in as they are looked up.
+  mutable std::vector<std::string> account_addresses_;
   // TODO(apaymyshev): make separate abstraction for imported keys as they are
   // not HD keys.
   // (address, key)
@@ -0,0 +1,230 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/json_rpc_request_batcher.h"
+
+#include <utility>
+
+#include "base/containers/contains.h"
+#include "base/functional/bind.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "brave/components/brave_wallet/browser/json_rpc_requests_helper.h"
+#include "net/http/http_status_code.h"
+
+namespace brave_wallet {
+
+namespace {
+
+// How long an endpoint that rejected a batch is only sent single calls.
+constexpr base::TimeDelta kBatchRetryDelay = base::Minutes(10);
+
+// Invalid Request, as answered by endpoints that only accept single calls.
+constexpr int kInvalidRequestErrorCode = -32600;
+
+// Whether |response| is a JSON-RPC error saying that batches aren't
+// supported, rather than an error about the calls or the endpoint's state.
+bool IsBatchRejection(const base::Value& response) {
+  if (!response.is_dict()) {
+    return false;
+  }
+  const base::Value::Dict* error = response.GetDict().FindDict("error");
+  if (!error) {
+    return false;
+  }
+  if (error->FindInt("code") == kInvalidRequestErrorCode) {
+    return true;
+  }
+  const std::string* message = error->FindString("message");
+  return message && base::Contains(base::ToLowerASCII(*message), "batch");
+}
+
+}  // namespace
+
+JsonRpcRequestBatcher::Call::Call(std::string json_payload,
+                                  bool auto_retry_on_network_change,
+                                  ResultCallback callback)
+    : json_payload(std::move(json_payload)),
+      headers(MakeCommonJsonRpcHeaders(this->json_payload)),
+      auto_retry_on_network_change(auto_retry_on_network_change),
+      callback(std::move(callback)) {}
+
+JsonRpcRequestBatcher::Call::~Call() = default;
+JsonRpcRequestBatcher::Call::Call(Call&&) = default;
+JsonRpcRequestBatcher::Call& JsonRpcRequestBatcher::Call::operator=(Call&&) =
+    default;
+
+JsonRpcRequestBatcher::JsonRpcRequestBatcher(
+    APIRequestHelper* api_request_helper)
+    : api_request_helper_(api_request_helper) {
+  DCHECK(api_request_helper_);
+}
+
+JsonRpcRequestBatcher::~JsonRpcRequestBatcher() = default;
+
+void JsonRpcRequestBatcher::Request(const GURL& network_url,
+                                    const std::string& json_payload,
+                                    bool auto_retry_on_network_change,
+                                    ResultCallback callback) {
+  DCHECK(network_url.is_valid());
+  Call call(json_payload, auto_retry_on_network_change, std::move(callback));
+  if (IsBatchUnsupported(network_url)) {
+    SendCall(network_url, std::move(call));
+    return;
+  }
+
+  if (queued_calls_.empty()) {
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE, base::BindOnce(&JsonRpcRequestBatcher::SendQueuedCalls,
+                                  weak_ptr_factory_.GetWeakPtr()));
+  }
+  queued_calls_[{network_url, call.headers}].push_back(std::move(call));
+}
+
+bool JsonRpcRequestBatcher::IsBatchUnsupported(const GURL& network_url) const {
+  auto it = batch_unsupported_until_.find(network_url);
+  return it != batch_unsupported_until_.end() &&
+         base::TimeTicks::Now() < it->second;
+}
+
+void JsonRpcRequestBatcher::SendQueuedCalls() {
+  auto queued_calls = std::exchange(queued_calls_, {});
+  for (auto& [key, calls] : queued_calls) {
+    SendBatch(key.first, key.second, std::move(calls));
+  }
+}
+
+void JsonRpcRequestBatcher::SendBatch(const GURL& network_url,
+                                      const Headers& headers,
+                                      std::vector<Call> calls) {
+  if (calls.size() == 1) {
+    SendCall(network_url, std::move(calls.front()));
+    return;
+  }
+
+  // Calls are given their position in the batch as id, as most calls are
+  // made with the same id.
+  base::Value::List batch;
+  std::vector<Call> batched_calls;
+  for (auto& call : calls) {
+    absl::optional<base::Value> request =
+        base::JSONReader::Read(call.json_payload);
+    if (!request || !request->is_dict()) {
+      SendCall(network_url, std::move(call));
+      continue;
+    }
+    if (base::Value* id = request->GetDict().Find("id")) {
+      call.id = std::move(*id);
+    }
+    request->GetDict().Set("id", static_cast<int>(batched_calls.size()));
+    batch.Append(std::move(*request));
+    batched_calls.push_back(std::move(call));
+  }
+  if (batched_calls.empty()) {
+    return;
+  }
+  if (batched_calls.size() == 1) {
+    SendCall(network_url, std::move(batched_calls.front()));
+    return;
+  }
+
+  std::string json_payload;
+  base::JSONWriter::Write(batch, &json_payload);
+  const bool auto_retry_on_network_change =
+      base::ranges::all_of(batched_calls, &Call::auto_retry_on_network_change);
+  api_request_helper_->Request(
+      "POST", network_url, json_payload, "application/json",
+      auto_retry_on_network_change,
+      base::BindOnce(&JsonRpcRequestBatcher::OnBatchResponse,
+                     weak_ptr_factory_.GetWeakPtr(), network_url,
+                     std::move(batched_calls)),
+      headers);
+}
+
+void JsonRpcRequestBatcher::SendCall(const GURL& network_url, Call call) {
+  api_request_helper_->Request(
+      "POST", network_url, call.json_payload, "application/json",
+      call.auto_retry_on_network_change, std::move(call.callback),
+      std::move(call.headers));
+}
+
+void JsonRpcRequestBatcher::OnBatchResponse(
+    const GURL& network_url,
+    std::vector<Call> calls,
+    APIRequestResult api_request_result) {
+  // Callbacks may end up destroying the batcher along with its owner.
+  auto weak_this = weak_ptr_factory_.GetWeakPtr();
+  if (!api_request_result.value_body().is_list()) {
+    const int response_code = api_request_result.response_code();
+    const bool is_overloaded = response_code == net::HTTP_TOO_MANY_REQUESTS ||
+                               response_code >= net::HTTP_INTERNAL_SERVER_ERROR;
+    if (!is_overloaded && IsBatchRejection(api_request_result.value_body())) {
+      batch_unsupported_until_[network_url] =
+          base::TimeTicks::Now() + kBatchRetryDelay;
+      for (auto& call : calls) {
+        SendCall(network_url, std::move(call));
+      }
+      return;
+    }
+
+    // The endpoint is rate limiting or failing, answered with another error,
+    // or wasn't reached at all. Sending every call again on its own would
+    // multiply the load on it, so each call fails with the batch's result and
+    // is left to the callers' own error handling.
+    for (auto& call : calls) {
+      std::move(call.callback)
+          .Run(APIRequestResult(
+              response_code, api_request_result.body(),
+              api_request_result.value_body().Clone(),
+              api_request_result.headers(), api_request_result.error_code(),
+              api_request_result.final_url()));
+      if (!weak_this) {
+        return;
+      }
+    }
+    return;
+  }
+
+  std::vector<bool> answered(calls.size(), false);
+  for (const auto& response : api_request_result.value_body().GetList()) {
+    if (!response.is_dict()) {
+      continue;
+    }
+    absl::optional<int> index = response.GetDict().FindInt("id");
+    if (!index || *index < 0 || static_cast<size_t>(*index) >= calls.size() ||
+        answered[*index]) {
+      continue;
+    }
+    answered[*index] = true;
+    Call& call = calls[*index];
+
+    base::Value::Dict call_response = response.GetDict().Clone();
+    call_response.Set("id", std::move(call.id));
+    std::string body;
+    base::JSONWriter::Write(call_response, &body);
+    std::move(call.callback)
+        .Run(APIRequestResult(api_request_result.response_code(),
+                              std::move(body),
+                              base::Value(std::move(call_response)),
+                              api_request_result.headers(),
+                              api_request_result.error_code(),
+                              api_request_result.final_url()));
+    if (!weak_this) {
+      return;
+    }
+  }
+
+  // Calls left out of the response are sent again on their own.
+  for (size_t i = 0; i < calls.size(); ++i) {
+    if (!answered[i]) {
+      SendCall(network_url, std::move(calls[i]));
+    }
+  }
+}
+
+}  // namespace brave_wallet
@@ -0,0 +1,93 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_JSON_RPC_REQUEST_BATCHER_H_
+#define BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_JSON_RPC_REQUEST_BATCHER_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "brave/components/api_request_helper/api_request_helper.h"
+#include "url/gurl.h"
+
+namespace brave_wallet {
+
+// Coalesces JSON-RPC calls to the same network URL into JSON-RPC 2.0 batch
+// requests. Calls requested while a task runs are sent together once it is
+// done, so a loop over accounts, tokens or pending transactions makes a
+// single request per network. Only calls sent with the same headers, i.e. of
+// the same JSON-RPC method, are batched together, so proxies routing on the
+// X-Eth-Method header still see the method of every call. Each call still
+// gets its own APIRequestResult, with the response to that call as its body,
+// so existing response handlers work unchanged. Endpoints that reject batches
+// with a JSON-RPC error are sent single calls for a while. Any other failure
+// of a batch, e.g. a rate limit, fails each of its calls.
+class JsonRpcRequestBatcher {
+ public:
+  using APIRequestHelper = api_request_helper::APIRequestHelper;
+  using APIRequestResult = api_request_helper::APIRequestResult;
+  using ResultCallback = APIRequestHelper::ResultCallback;
+
+  explicit JsonRpcRequestBatcher(APIRequestHelper* api_request_helper);
+  ~JsonRpcRequestBatcher();
+  JsonRpcRequestBatcher(const JsonRpcRequestBatcher&) = delete;
+  JsonRpcRequestBatcher& operator=(const JsonRpcRequestBatcher&) = delete;
+
+  // Queues |json_payload|, a single JSON-RPC call, to be sent to
+  // |network_url|.
+  void Request(const GURL& network_url,
+               const std::string& json_payload,
+               bool auto_retry_on_network_change,
+               ResultCallback callback);
+
+ private:
+  using Headers = base::flat_map<std::string, std::string>;
+
+  struct Call {
+    Call(std::string json_payload,
+         bool auto_retry_on_network_change,
+         ResultCallback callback);
+    ~Call();
+    Call(Call&&);
+    Call& operator=(Call&&);
+
+    std::string json_payload;
+    Headers headers;
+    bool auto_retry_on_network_change;
+    ResultCallback callback;
+    // Id of the call as requested, given back in its response.
+    base::Value id;
+  };
+
+  bool IsBatchUnsupported(const GURL& network_url) const;
+  void SendQueuedCalls();
+  void SendBatch(const GURL& network_url,
+                 const Headers& headers,
+                 std::vector<Call> calls);
+  void SendCall(const GURL& network_url, Call call);
+  void OnBatchResponse(const GURL& network_url,
+                       std::vector<Call> calls,
+                       APIRequestResult api_request_result);
+
+  raw_ptr<APIRequestHelper> api_request_helper_ = nullptr;
+  // Calls to send once the current task is done, by network URL and headers.
+  std::map<std::pair<GURL, Headers>, std::vector<Call>> queued_calls_;
+  // Endpoints that rejected a batch, and until when they are only sent single
+  // calls. Batches are tried again after a while, in case the endpoint was
+  // upgraded or a load balancer sent the batch to an older server.
+  std::map<GURL, base::TimeTicks> batch_unsupported_until_;
+  base::WeakPtrFactory<JsonRpcRequestBatcher> weak_ptr_factory_{this};
+};
+
+}  // namespace brave_wallet
+
+#endif  // BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_JSON_RPC_REQUEST_BATCHER_H_
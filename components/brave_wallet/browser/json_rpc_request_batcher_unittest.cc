@@ -0,0 +1,328 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/json_rpc_request_batcher.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/functional/barrier_closure.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
+#include "brave/components/brave_wallet/browser/eth_data_builder.h"
+#include "brave/components/brave_wallet/browser/eth_requests.h"
+#include "net/http/http_status_code.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
+#include "services/data_decoder/public/cpp/test_support/in_process_data_decoder.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_wallet {
+
+namespace {
+
+using api_request_helper::APIRequestHelper;
+using api_request_helper::APIRequestResult;
+
+// What the stub RPC server answers each call with, so responses can be
+// matched with their calls.
+std::string ResultFor(const base::Value::Dict& call) {
+  std::string result;
+  const base::Value::List* params = call.FindList("params");
+  if (params) {
+    base::JSONWriter::Write(*params, &result);
+  }
+  return result;
+}
+
+base::Value::Dict ResponseFor(const base::Value::Dict& call) {
+  base::Value::Dict response;
+  response.Set("jsonrpc", "2.0");
+  if (const base::Value* id = call.Find("id")) {
+    response.Set("id", id->Clone());
+  }
+  response.Set("result", ResultFor(call));
+  return response;
+}
+
+}  // namespace
+
+class JsonRpcRequestBatcherUnitTest : public testing::Test {
+ public:
+  JsonRpcRequestBatcherUnitTest()
+      : shared_url_loader_factory_(
+            base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+                &url_loader_factory_)),
+        api_request_helper_(
+            net::NetworkTrafficAnnotationTag(TRAFFIC_ANNOTATION_FOR_TESTS),
+            shared_url_loader_factory_),
+        batcher_(&api_request_helper_) {}
+
+ protected:
+  void SetUp() override {
+    // A stub RPC server answering every call with its params.
+    url_loader_factory_.SetInterceptor(base::BindLambdaForTesting(
+        [&](const network::ResourceRequest& request) {
+          ++requests_sent_;
+          auto payload = base::JSONReader::Read(
+              request.request_body->elements()
+                  ->at(0)
+                  .As<network::DataElementBytes>()
+                  .AsStringPiece());
+          ASSERT_TRUE(payload);
+          std::string response;
+          net::HttpStatusCode status = net::HTTP_OK;
+          if (payload->is_list()) {
+            ++batches_sent_;
+            batch_sizes_.push_back(payload->GetList().size());
+            std::string method;
+            request.headers.GetHeader("X-Eth-Method", &method);
+            batch_methods_.insert(method);
+            base::Value::List responses;
+            if (!batch_error_.empty()) {
+              response = batch_error_;
+              status = batch_error_status_;
+            } else if (reject_batches_) {
+              response =
+                  R"({"jsonrpc":"2.0","id":null,"error":)"
+                  R"({"code":-32600,"message":"Batches are not supported"}})";
+            } else {
+              for (const auto& call : payload->GetList()) {
+                if (responses.size() + 1 < payload->GetList().size() ||
+                    !drop_last_response_) {
+                  responses.Append(ResponseFor(call.GetDict()));
+                }
+              }
+              base::JSONWriter::Write(responses, &response);
+            }
+          } else {
+            base::JSONWriter::Write(ResponseFor(payload->GetDict()),
+                                    &response);
+          }
+          url_loader_factory_.ClearResponses();
+          url_loader_factory_.AddResponse(request.url.spec(), response,
+                                          status);
+        }));
+  }
+
+  // Requests |payloads| to |url| and waits for all of them to be answered,
+  // checking that each got the response to its own call.
+  void RequestAll(const GURL& url, const std::vector<std::string>& payloads) {
+    base::RunLoop run_loop;
+    auto barrier =
+        base::BarrierClosure(payloads.size(), run_loop.QuitClosure());
+    for (const auto& payload : payloads) {
+      auto call = base::JSONReader::Read(payload);
+      ASSERT_TRUE(call);
+      auto callback = base::BindLambdaForTesting(
+          [barrier, expected_result = ResultFor(call->GetDict())](
+              APIRequestResult api_request_result) {
+            ASSERT_TRUE(api_request_result.value_body().is_dict());
+            const auto& response = api_request_result.value_body().GetDict();
+            EXPECT_EQ(response.FindInt("id"), 1);
+            const std::string* result = response.FindString("result");
+            ASSERT_TRUE(result);
+            EXPECT_EQ(*result, expected_result);
+            barrier.Run();
+          });
+      batcher_.Request(url, payload, true, std::move(callback));
+    }
+    run_loop.Run();
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  data_decoder::test::InProcessDataDecoder in_process_data_decoder_;
+  network::TestURLLoaderFactory url_loader_factory_;
+  scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory_;
+  APIRequestHelper api_request_helper_;
+  JsonRpcRequestBatcher batcher_;
+
+  size_t requests_sent_ = 0;
+  size_t batches_sent_ = 0;
+  std::vector<size_t> batch_sizes_;
+  std::set<std::string> batch_methods_;
+  bool reject_batches_ = false;
+  bool drop_last_response_ = false;
+  // What batches are answered with instead, unless empty.
+  std::string batch_error_;
+  net::HttpStatusCode batch_error_status_ = net::HTTP_OK;
+};
+
+TEST_F(JsonRpcRequestBatcherUnitTest, CoalescesCallsPerNetwork) {
+  const GURL mainnet("https://mainnet.example.com/");
+  const GURL polygon("https://polygon.example.com/");
+  std::vector<std::string> payloads;
+  for (int i = 0; i < 3; ++i) {
+    payloads.push_back(
+        eth::eth_getTransactionReceipt("0x" + base::NumberToString(i)));
+  }
+
+  base::RunLoop run_loop;
+  auto barrier = base::BarrierClosure(5, run_loop.QuitClosure());
+  auto expect_result = [&](const std::string& payload) {
+    auto call = base::JSONReader::Read(payload);
+    return base::BindLambdaForTesting(
+        [barrier, expected_result = ResultFor(call->GetDict())](
+            APIRequestResult api_request_result) {
+          EXPECT_TRUE(api_request_result.Is2XXResponseCode());
+          const std::string* result =
+              api_request_result.value_body().GetDict().FindString("result");
+          ASSERT_TRUE(result);
+          EXPECT_EQ(*result, expected_result);
+          barrier.Run();
+        });
+  };
+  for (const auto& payload : payloads) {
+    batcher_.Request(mainnet, payload, true, expect_result(payload));
+  }
+  const std::string block_number = eth::eth_blockNumber();
+  batcher_.Request(polygon, block_number, true, expect_result(block_number));
+  // Calls made in a later task go out in a batch of their own.
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(requests_sent_, 2u);
+  batcher_.Request(mainnet, payloads[0], true, expect_result(payloads[0]));
+  run_loop.Run();
+
+  // One batch for mainnet, a single call for polygon and a single call for
+  // the later mainnet call.
+  EXPECT_EQ(requests_sent_, 3u);
+  EXPECT_EQ(batches_sent_, 1u);
+  EXPECT_EQ(batch_sizes_, std::vector<size_t>({3u}));
+}
+
+TEST_F(JsonRpcRequestBatcherUnitTest, FallsBackWhenBatchesAreRejected) {
+  reject_batches_ = true;
+  const GURL url("https://mainnet.example.com/");
+  std::vector<std::string> payloads;
+  for (int i = 0; i < 4; ++i) {
+    payloads.push_back(
+        eth::eth_getBalance("0x" + base::NumberToString(i), "latest"));
+  }
+
+  RequestAll(url, payloads);
+  // The rejected batch and each call on its own.
+  EXPECT_EQ(batches_sent_, 1u);
+  EXPECT_EQ(requests_sent_, 5u);
+
+  // The endpoint isn't sent batches for a while.
+  RequestAll(url, payloads);
+  EXPECT_EQ(batches_sent_, 1u);
+  EXPECT_EQ(requests_sent_, 9u);
+
+  // The endpoint may have been upgraded since, so batches are tried again
+  // later.
+  reject_batches_ = false;
+  task_environment_.FastForwardBy(base::Minutes(10));
+  RequestAll(url, payloads);
+  EXPECT_EQ(batches_sent_, 2u);
+  EXPECT_EQ(requests_sent_, 10u);
+}
+
+// Batches failing for other reasons than being unsupported, e.g. a rate
+// limit, fail each of their calls instead of sending each of them again.
+TEST_F(JsonRpcRequestBatcherUnitTest, FailsCallsWhenBatchFails) {
+  const GURL url("https://mainnet.example.com/");
+  constexpr size_t kCalls = 3;
+  const struct {
+    net::HttpStatusCode status;
+    const char* body;
+  } kFailures[] = {
+      {net::HTTP_TOO_MANY_REQUESTS, "Too Many Requests"},
+      {net::HTTP_SERVICE_UNAVAILABLE,
+       R"({"jsonrpc":"2.0","id":null,"error":)"
+       R"({"code":-32600,"message":"Batches are not supported"}})"},
+      {net::HTTP_OK,
+       R"({"jsonrpc":"2.0","id":null,"error":)"
+       R"({"code":-32005,"message":"Request rate exceeded"}})"},
+  };
+
+  size_t expected_requests = 0;
+  for (const auto& failure : kFailures) {
+    SCOPED_TRACE(failure.body);
+    batch_error_status_ = failure.status;
+    batch_error_ = failure.body;
+
+    base::RunLoop run_loop;
+    auto barrier = base::BarrierClosure(kCalls, run_loop.QuitClosure());
+    for (size_t i = 0; i < kCalls; ++i) {
+      batcher_.Request(
+          url, eth::eth_getBalance("0x" + base::NumberToString(i), "latest"),
+          true,
+          base::BindLambdaForTesting(
+              [&, barrier](APIRequestResult api_request_result) {
+                EXPECT_EQ(api_request_result.response_code(), failure.status);
+                if (api_request_result.Is2XXResponseCode()) {
+                  ASSERT_TRUE(api_request_result.value_body().is_dict());
+                  EXPECT_EQ(api_request_result.value_body()
+                                .GetDict()
+                                .FindIntByDottedPath("error.code"),
+                            -32005);
+                }
+                barrier.Run();
+              }));
+    }
+    run_loop.Run();
+
+    // Only the batch was sent, and the next calls are batched again.
+    expected_requests++;
+    EXPECT_EQ(requests_sent_, expected_requests);
+    EXPECT_EQ(batches_sent_, expected_requests);
+  }
+}
+
+TEST_F(JsonRpcRequestBatcherUnitTest, ResendsCallsLeftOutOfResponse) {
+  drop_last_response_ = true;
+  const GURL url("https://mainnet.example.com/");
+  std::vector<std::string> payloads;
+  for (int i = 0; i < 3; ++i) {
+    payloads.push_back(
+        eth::eth_getBalance("0x" + base::NumberToString(i), "latest"));
+  }
+
+  RequestAll(url, payloads);
+  EXPECT_EQ(batches_sent_, 1u);
+  EXPECT_EQ(requests_sent_, 2u);
+}
+
+// Calls of different methods are sent in batches of their own, so that each
+// batch can be sent with the X-Eth-Method header of its calls.
+TEST_F(JsonRpcRequestBatcherUnitTest, BatchesCallsPerMethod) {
+  constexpr size_t kAccounts = 5;
+  constexpr size_t kTokens = 3;
+  const GURL url("https://mainnet.example.com/");
+  std::vector<std::string> payloads;
+  for (size_t account = 0; account < kAccounts; ++account) {
+    const std::string address =
+        "0x" + std::string(38, '0') + base::NumberToString(10 + account);
+    payloads.push_back(eth::eth_getBalance(address, kEthereumBlockTagLatest));
+    std::string data;
+    ASSERT_TRUE(erc20::BalanceOf(address, &data));
+    for (size_t token = 0; token < kTokens; ++token) {
+      const std::string contract =
+          "0x" + std::string(38, '1') + base::NumberToString(10 + token);
+      payloads.push_back(eth::eth_call("", contract, "", "", "", data,
+                                       kEthereumBlockTagLatest));
+    }
+  }
+
+  RequestAll(url, payloads);
+  EXPECT_EQ(requests_sent_, 2u);
+  EXPECT_EQ(batches_sent_, 2u);
+  EXPECT_EQ(batch_methods_,
+            std::set<std::string>({"eth_call", "eth_getBalance"}));
+}
+
+}  // namespace brave_wallet
@@ -0,0 +1,191 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/json_rpc_response_cache.h"
+
+#include <iterator>
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/values.h"
+#include "brave/components/json/rs/src/lib.rs.h"
+#include "net/base/net_errors.h"
+
+namespace brave_wallet {
+
+namespace {
+
+// Keep a network with many accounts and tokens from growing the cache
+// unbounded between two chain heads. Most responses are small; large ones,
+// e.g. getTokenAccountsByOwner of a wallet with many tokens, aren't cached.
+constexpr size_t kMaxEntriesPerNetwork = 1000;
+constexpr size_t kMaxBytesPerNetwork = 2 * 1024 * 1024;
+constexpr size_t kMaxEntryBytes = 256 * 1024;
+
+// Calls are keyed by method and params, leaving out their id.
+absl::optional<std::string> GetCacheKey(const std::string& json_payload) {
+  absl::optional<base::Value> call = base::JSONReader::Read(json_payload);
+  if (!call || !call->is_dict()) {
+    return absl::nullopt;
+  }
+  const std::string* method = call->GetDict().FindString("method");
+  if (!method) {
+    return absl::nullopt;
+  }
+  std::string params;
+  if (const base::Value* params_value = call->GetDict().Find("params")) {
+    base::JSONWriter::Write(*params_value, &params);
+  }
+  return *method + ":" + params;
+}
+
+bool IsJsonRpcResult(const api_request_helper::APIRequestResult& result) {
+  if (!result.Is2XXResponseCode()) {
+    return false;
+  }
+  const base::Value& value_body = result.value_body();
+  if (value_body.is_dict()) {
+    const base::Value* json_rpc_result = value_body.GetDict().Find("result");
+    return json_rpc_result && !json_rpc_result->is_none() &&
+           !value_body.GetDict().Find("error");
+  }
+  // Unparsed responses are only skimmed over.
+  if (value_body.is_none() && !result.body().empty()) {
+    return json::is_json_rpc_result(rust::Slice<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(result.body().data()),
+        result.body().size()));
+  }
+  return false;
+}
+
+}  // namespace
+
+JsonRpcResponseCache::Entry::Entry(std::string body,
+                                   base::Value value_body,
+                                   int response_code,
+                                   base::TimeTicks expiry,
+                                   size_t bytes)
+    : body(std::move(body)),
+      value_body(std::move(value_body)),
+      response_code(response_code),
+      expiry(expiry),
+      bytes(bytes) {}
+JsonRpcResponseCache::Entry::~Entry() = default;
+JsonRpcResponseCache::Entry::Entry(Entry&&) = default;
+JsonRpcResponseCache::Entry& JsonRpcResponseCache::Entry::operator=(Entry&&) =
+    default;
+
+JsonRpcResponseCache::Network::Network() : entries(kMaxEntriesPerNetwork) {}
+JsonRpcResponseCache::Network::~Network() = default;
+
+void JsonRpcResponseCache::Network::Erase(
+    base::HashingLRUCache<std::string, Entry>::iterator it) {
+  bytes -= it->second.bytes;
+  entries.Erase(it);
+}
+
+JsonRpcResponseCache::JsonRpcResponseCache(base::TimeDelta ttl) : ttl_(ttl) {}
+
+JsonRpcResponseCache::~JsonRpcResponseCache() = default;
+
+absl::optional<api_request_helper::APIRequestResult> JsonRpcResponseCache::Get(
+    const GURL& network_url,
+    const std::string& json_payload) {
+  absl::optional<APIRequestResult> result;
+  auto network_it = networks_.find(network_url);
+  absl::optional<std::string> key = GetCacheKey(json_payload);
+  if (network_it != networks_.end() && key) {
+    Network& network = *network_it->second;
+    auto it = network.entries.Get(*key);
+    if (it != network.entries.end()) {
+      const Entry& entry = it->second;
+      if (entry.expiry > base::TimeTicks::Now()) {
+        result.emplace(entry.response_code, entry.body,
+                       entry.value_body.Clone(),
+                       base::flat_map<std::string, std::string>(), net::OK,
+                       GURL());
+      } else {
+        network.Erase(it);
+      }
+    }
+  }
+
+  if (result) {
+    ++hits_;
+  } else {
+    ++misses_;
+  }
+  DVLOG(2) << "JSON-RPC response cache " << (result ? "hit" : "miss") << ", "
+           << hits_ << " hits and " << misses_ << " misses so far";
+  return result;
+}
+
+void JsonRpcResponseCache::Put(const GURL& network_url,
+                               const std::string& json_payload,
+                               const APIRequestResult& api_request_result) {
+  if (!IsJsonRpcResult(api_request_result)) {
+    return;
+  }
+  absl::optional<std::string> key = GetCacheKey(json_payload);
+  if (!key) {
+    return;
+  }
+
+  const bool parsed = !api_request_result.value_body().is_none();
+  const size_t bytes =
+      key->size() + (parsed ? api_request_result.value_body()
+                                  .EstimateMemoryUsage()
+                            : api_request_result.body().size());
+  Network& network = GetNetwork(network_url);
+  auto existing = network.entries.Peek(*key);
+  if (existing != network.entries.end()) {
+    network.Erase(existing);
+  }
+  if (bytes > kMaxEntryBytes) {
+    return;
+  }
+
+  // Least recently used responses go first.
+  while (!network.entries.empty() &&
+         (network.bytes + bytes > kMaxBytesPerNetwork ||
+          network.entries.size() >= kMaxEntriesPerNetwork)) {
+    network.Erase(std::prev(network.entries.end()));
+  }
+  network.entries.Put(
+      std::move(*key),
+      Entry(parsed ? std::string() : api_request_result.body(),
+            parsed ? api_request_result.value_body().Clone() : base::Value(),
+            api_request_result.response_code(),
+            base::TimeTicks::Now() + ttl_, bytes));
+  network.bytes += bytes;
+}
+
+void JsonRpcResponseCache::OnChainHead(const GURL& network_url,
+                                       const std::string& head) {
+  Network& network = GetNetwork(network_url);
+  if (network.head == head) {
+    return;
+  }
+  network.head = head;
+  network.entries.Clear();
+  network.bytes = 0;
+}
+
+void JsonRpcResponseCache::Clear() {
+  networks_.clear();
+}
+
+JsonRpcResponseCache::Network& JsonRpcResponseCache::GetNetwork(
+    const GURL& network_url) {
+  std::unique_ptr<Network>& network = networks_[network_url];
+  if (!network) {
+    network = std::make_unique<Network>();
+  }
+  return *network;
+}
+
+}  // namespace brave_wallet
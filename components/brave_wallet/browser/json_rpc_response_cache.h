@@ -0,0 +1,99 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_JSON_RPC_RESPONSE_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_JSON_RPC_RESPONSE_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/containers/lru_cache.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "brave/components/api_request_helper/api_request_helper.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+
+namespace brave_wallet {
+
+// Caches successful responses to JSON-RPC read calls per network URL, keyed
+// by method and params, which include the block tag of Ethereum calls.
+// Responses of a network are dropped once a new chain head is seen for it,
+// and expire after |ttl| otherwise, as heads are only polled by the block
+// trackers while transactions are pending. Each network keeps its most
+// recently used responses, up to a number of entries and bytes; only the
+// payload of a response is kept, not its headers.
+class JsonRpcResponseCache {
+ public:
+  using APIRequestResult = api_request_helper::APIRequestResult;
+
+  explicit JsonRpcResponseCache(base::TimeDelta ttl);
+  ~JsonRpcResponseCache();
+  JsonRpcResponseCache(const JsonRpcResponseCache&) = delete;
+  JsonRpcResponseCache& operator=(const JsonRpcResponseCache&) = delete;
+
+  // Returns a copy of the cached response to |json_payload|, counting a hit
+  // or a miss.
+  absl::optional<APIRequestResult> Get(const GURL& network_url,
+                                       const std::string& json_payload);
+  // Caches |api_request_result| as the response to |json_payload| if it is a
+  // JSON-RPC result.
+  void Put(const GURL& network_url,
+           const std::string& json_payload,
+           const APIRequestResult& api_request_result);
+  // Drops the responses of |network_url| if |head|, a block number or hash,
+  // differs from the last head seen for it.
+  void OnChainHead(const GURL& network_url, const std::string& head);
+  void Clear();
+
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+ private:
+  struct Entry {
+    Entry(std::string body,
+          base::Value value_body,
+          int response_code,
+          base::TimeTicks expiry,
+          size_t bytes);
+    ~Entry();
+    Entry(Entry&&);
+    Entry& operator=(Entry&&);
+
+    // Only one of |body| and |value_body| is kept: the parsed response, or
+    // the raw one for responses left unparsed.
+    std::string body;
+    base::Value value_body;
+    int response_code;
+    base::TimeTicks expiry;
+    // Approximate memory used by the entry, including its key.
+    size_t bytes;
+  };
+
+  struct Network {
+    Network();
+    ~Network();
+    Network(const Network&) = delete;
+    Network& operator=(const Network&) = delete;
+
+    void Erase(base::HashingLRUCache<std::string, Entry>::iterator it);
+
+    std::string head;
+    base::HashingLRUCache<std::string, Entry> entries;
+    size_t bytes = 0;
+  };
+
+  Network& GetNetwork(const GURL& network_url);
+
+  const base::TimeDelta ttl_;
+  std::map<GURL, std::unique_ptr<Network>> networks_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+};
+
+}  // namespace brave_wallet
+
+#endif  // BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_JSON_RPC_RESPONSE_CACHE_H_
@@ -0,0 +1,174 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/json_rpc_response_cache.h"
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/test/values_test_util.h"
+#include "base/time/time.h"
+#include "brave/components/brave_wallet/browser/eth_requests.h"
+#include "net/base/net_errors.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_wallet {
+
+namespace {
+
+using api_request_helper::APIRequestResult;
+
+constexpr char kAddress[] = "0x3535353535353535353535353535353535353535";
+constexpr char kOtherAddress[] = "0x2f015c60e0be116b1f0cd534704db9c92118fb6a";
+
+APIRequestResult MakeResult(const std::string& body, int response_code = 200) {
+  return APIRequestResult(response_code, body, base::test::ParseJson(body), {},
+                          net::OK, GURL());
+}
+
+APIRequestResult MakeUnparsedResult(const std::string& body) {
+  return APIRequestResult(200, body, base::Value(), {}, net::OK, GURL());
+}
+
+}  // namespace
+
+class JsonRpcResponseCacheUnitTest : public testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  JsonRpcResponseCache cache_{base::Seconds(10)};
+  const GURL mainnet_{"https://mainnet.example.com/"};
+  const GURL polygon_{"https://polygon.example.com/"};
+};
+
+TEST_F(JsonRpcResponseCacheUnitTest, GetAndPut) {
+  const std::string balance = eth::eth_getBalance(kAddress, "latest");
+  EXPECT_FALSE(cache_.Get(mainnet_, balance));
+
+  const std::string response = R"({"jsonrpc":"2.0","id":1,"result":"0x1"})";
+  cache_.Put(mainnet_, balance, MakeResult(response));
+  auto cached = cache_.Get(mainnet_, balance);
+  ASSERT_TRUE(cached);
+  // Only the parsed payload is kept.
+  EXPECT_EQ(cached->response_code(), 200);
+  EXPECT_EQ(cached->value_body(), base::test::ParseJson(response));
+  EXPECT_TRUE(cached->body().empty());
+
+  // Calls are keyed by network, method and params, including the block tag.
+  EXPECT_FALSE(cache_.Get(polygon_, balance));
+  EXPECT_FALSE(cache_.Get(mainnet_, eth::eth_getBalance(kAddress, "0x10")));
+  EXPECT_FALSE(
+      cache_.Get(mainnet_, eth::eth_getBalance(kOtherAddress, "latest")));
+  EXPECT_FALSE(cache_.Get(mainnet_, eth::eth_getTransactionCount(kAddress,
+                                                                 "latest")));
+  // but not by id.
+  EXPECT_TRUE(cache_.Get(
+      mainnet_,
+      R"({"id":7,"jsonrpc":"2.0","method":"eth_getBalance",)"
+      R"("params":["0x3535353535353535353535353535353535353535","latest"]})"));
+
+  EXPECT_EQ(cache_.hits(), 2u);
+  EXPECT_EQ(cache_.misses(), 5u);
+
+  cache_.Clear();
+  EXPECT_FALSE(cache_.Get(mainnet_, balance));
+}
+
+TEST_F(JsonRpcResponseCacheUnitTest, OnlyCachesResults) {
+  const std::string balance = eth::eth_getBalance(kAddress, "latest");
+  cache_.Put(mainnet_, balance,
+             MakeResult(R"({"jsonrpc":"2.0","id":1,"result":"0x1"})", 500));
+  cache_.Put(mainnet_, balance,
+             MakeResult(R"({"jsonrpc":"2.0","id":1,"result":null})"));
+  cache_.Put(mainnet_, balance,
+             MakeResult(R"({"jsonrpc":"2.0","id":1,"error":{"code":-32000,)"
+                        R"("message":"header not found"}})"));
+  cache_.Put(mainnet_, "not json",
+             MakeResult(R"({"jsonrpc":"2.0","id":1,"result":"0x1"})"));
+  EXPECT_FALSE(cache_.Get(mainnet_, balance));
+  EXPECT_FALSE(cache_.Get(mainnet_, "not json"));
+
+  // Unparsed bodies are checked too.
+  cache_.Put(mainnet_, balance,
+             MakeUnparsedResult(R"({"jsonrpc":"2.0","id":1,"error":{)"
+                                R"("code":-32000,"message":"error"}})"));
+  EXPECT_FALSE(cache_.Get(mainnet_, balance));
+  cache_.Put(mainnet_, balance,
+             MakeUnparsedResult(R"({"jsonrpc":"2.0","id":1,"result":"0x1"})"));
+  auto cached = cache_.Get(mainnet_, balance);
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(cached->body(), R"({"jsonrpc":"2.0","id":1,"result":"0x1"})");
+}
+
+TEST_F(JsonRpcResponseCacheUnitTest, EvictsLeastRecentlyUsed) {
+  const std::string response = R"({"jsonrpc":"2.0","id":1,"result":"0x1"})";
+  auto balance_of = [](int account) {
+    return eth::eth_getBalance("0x" + base::NumberToString(account), "latest");
+  };
+  for (int i = 0; i < 1000; ++i) {
+    cache_.Put(mainnet_, balance_of(i), MakeResult(response));
+  }
+  // Reading the oldest response makes it the most recently used one.
+  EXPECT_TRUE(cache_.Get(mainnet_, balance_of(0)));
+  cache_.Put(mainnet_, balance_of(1000), MakeResult(response));
+
+  EXPECT_TRUE(cache_.Get(mainnet_, balance_of(0)));
+  EXPECT_FALSE(cache_.Get(mainnet_, balance_of(1)));
+  EXPECT_TRUE(cache_.Get(mainnet_, balance_of(2)));
+  EXPECT_TRUE(cache_.Get(mainnet_, balance_of(1000)));
+}
+
+TEST_F(JsonRpcResponseCacheUnitTest, CapsBytes) {
+  auto balance_of = [](int account) {
+    return eth::eth_getBalance("0x" + base::NumberToString(account), "latest");
+  };
+  auto response_of_size = [](size_t size) {
+    return MakeUnparsedResult(R"({"jsonrpc":"2.0","id":1,"result":")" +
+                              std::string(size, 'A') + R"("})");
+  };
+
+  // Responses too large on their own aren't cached.
+  cache_.Put(mainnet_, balance_of(0), response_of_size(300 * 1024));
+  EXPECT_FALSE(cache_.Get(mainnet_, balance_of(0)));
+
+  // Others are, up to a total size per network.
+  for (int i = 0; i < 11; ++i) {
+    cache_.Put(mainnet_, balance_of(i), response_of_size(200 * 1024));
+  }
+  EXPECT_FALSE(cache_.Get(mainnet_, balance_of(0)));
+  for (int i = 1; i < 11; ++i) {
+    EXPECT_TRUE(cache_.Get(mainnet_, balance_of(i)));
+  }
+  cache_.Put(polygon_, balance_of(0), response_of_size(200 * 1024));
+  EXPECT_TRUE(cache_.Get(polygon_, balance_of(0)));
+}
+
+TEST_F(JsonRpcResponseCacheUnitTest, Invalidation) {
+  const std::string balance = eth::eth_getBalance(kAddress, "latest");
+  const std::string response = R"({"jsonrpc":"2.0","id":1,"result":"0x1"})";
+  cache_.OnChainHead(mainnet_, "0x10");
+  cache_.Put(mainnet_, balance, MakeResult(response));
+  cache_.Put(polygon_, balance, MakeResult(response));
+
+  // The same head keeps responses.
+  cache_.OnChainHead(mainnet_, "0x10");
+  EXPECT_TRUE(cache_.Get(mainnet_, balance));
+
+  // A new head drops the responses of its network only.
+  cache_.OnChainHead(mainnet_, "0x11");
+  EXPECT_FALSE(cache_.Get(mainnet_, balance));
+  EXPECT_TRUE(cache_.Get(polygon_, balance));
+
+  // Responses expire after the TTL.
+  cache_.Put(mainnet_, balance, MakeResult(response));
+  task_environment_.FastForwardBy(base::Seconds(9));
+  EXPECT_TRUE(cache_.Get(mainnet_, balance));
+  task_environment_.FastForwardBy(base::Seconds(1));
+  EXPECT_FALSE(cache_.Get(mainnet_, balance));
+  EXPECT_FALSE(cache_.Get(polygon_, balance));
+}
+
+}  // namespace brave_wallet
@@ -16,6 +16,7 @@
 #include "base/notreached.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/sequenced_task_runner.h"
 #include "brave/components/brave_wallet/browser/blockchain_registry.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_prefs.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_service.h"
@@ -74,6 +75,11 @@ constexpr char kDomainPattern[] =
 constexpr char kUDPattern[] =
     "(?:[a-z0-9-]+)\\.(?:crypto|x|nft|dao|wallet|blockchain|bitcoin|zil)";
 
+// getTokenAccountsByOwner responses grow with the number of token accounts
+// of the owner, and are read straight from the body. Bodies over this size
+// are dropped while downloading.
+constexpr size_t kMaxSolanaTokenAccountsByOwnerResponseSize = 32 * 1024 * 1024;
+
 net::NetworkTrafficAnnotationTag GetNetworkTrafficAnnotationTag() {
   return net::DefineNetworkTrafficAnnotation("json_rpc_service", R"(
       semantics {
@@ -214,6 +220,16 @@ JsonRpcService::JsonRpcService(
       prefs_(prefs),
       local_state_prefs_(local_state_prefs),
       weak_ptr_factory_(this) {
+  if (base::FeatureList::IsEnabled(
+          features::kBraveWalletJsonRpcBatchingFeature)) {
+    json_rpc_request_batcher_ =
+        std::make_unique<JsonRpcRequestBatcher>(api_request_helper_.get());
+  }
+  if (base::FeatureList::IsEnabled(
+          features::kBraveWalletResponseCacheFeature)) {
+    response_cache_ = std::make_unique<JsonRpcResponseCache>(
+        features::kResponseCacheTtl.Get());
+  }
   if (!SetNetwork(GetCurrentChainId(prefs_, mojom::CoinType::ETH),
                   mojom::CoinType::ETH)) {
     LOG(ERROR) << "Could not set network from JsonRpcService() for ETH";
@@ -248,6 +264,10 @@ void JsonRpcService::SetAPIRequestHelperForTesting(
     scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory) {
   api_request_helper_ = std::make_unique<APIRequestHelper>(
       GetNetworkTrafficAnnotationTag(), url_loader_factory);
+  if (json_rpc_request_batcher_) {
+    json_rpc_request_batcher_ =
+        std::make_unique<JsonRpcRequestBatcher>(api_request_helper_.get());
+  }
   if (EnsL2FeatureEnabled()) {
     api_request_helper_ens_offchain_ = std::make_unique<APIRequestHelper>(
         GetENSOffchainNetworkTrafficAnnotationTag(), url_loader_factory);
@@ -366,6 +386,50 @@ void JsonRpcService::RequestInternal(
                                std::move(conversion_callback));
 }
 
+void JsonRpcService::RequestBatched(const std::string& json_payload,
+                                    bool auto_retry_on_network_change,
+                                    const GURL& network_url,
+                                    RequestIntermediateCallback callback) {
+  if (!json_rpc_request_batcher_) {
+    RequestInternal(json_payload, auto_retry_on_network_change, network_url,
+                    std::move(callback));
+    return;
+  }
+  json_rpc_request_batcher_->Request(network_url, json_payload,
+                                     auto_retry_on_network_change,
+                                     std::move(callback));
+}
+
+bool JsonRpcService::RespondFromCache(const GURL& network_url,
+                                      const std::string& json_payload,
+                                      RequestIntermediateCallback* callback) {
+  if (!response_cache_) {
+    return false;
+  }
+
+  absl::optional<APIRequestResult> cached_result =
+      response_cache_->Get(network_url, json_payload);
+  if (cached_result) {
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE,
+        base::BindOnce(std::move(*callback), std::move(*cached_result)));
+    return true;
+  }
+
+  *callback = base::BindOnce(&JsonRpcService::OnCacheableResponse,
+                             weak_ptr_factory_.GetWeakPtr(), network_url,
+                             json_payload, std::move(*callback));
+  return false;
+}
+
+void JsonRpcService::OnCacheableResponse(const GURL& network_url,
+                                         const std::string& json_payload,
+                                         RequestIntermediateCallback callback,
+                                         APIRequestResult api_request_result) {
+  response_cache_->Put(network_url, json_payload, api_request_result);
+  std::move(callback).Run(std::move(api_request_result));
+}
+
 void JsonRpcService::Request(const std::string& json_payload,
                              bool auto_retry_on_network_change,
                              base::Value id,
@@ -723,11 +787,11 @@ void JsonRpcService::SetCustomNetworkForTesting(const std::string& chain_id,
 }
 
 void JsonRpcService::GetBlockNumber(GetBlockNumberCallback callback) {
-  auto internal_callback =
-      base::BindOnce(&JsonRpcService::OnGetBlockNumber,
-                     weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(eth::eth_blockNumber(), true,
-                  network_urls_[mojom::CoinType::ETH],
+  const GURL network_url = network_urls_[mojom::CoinType::ETH];
+  auto internal_callback = base::BindOnce(&JsonRpcService::OnGetBlockNumber,
+                                          weak_ptr_factory_.GetWeakPtr(),
+                                          network_url, std::move(callback));
+  RequestInternal(eth::eth_blockNumber(), true, network_url,
                   std::move(internal_callback));
 }
 
@@ -775,7 +839,8 @@ void JsonRpcService::OnGetFilStateSearchMsgLimited(
                           "");
 }
 
-void JsonRpcService::OnGetBlockNumber(GetBlockNumberCallback callback,
+void JsonRpcService::OnGetBlockNumber(const GURL& network_url,
+                                      GetBlockNumberCallback callback,
                                       APIRequestResult api_request_result) {
   if (!api_request_result.Is2XXResponseCode()) {
     std::move(callback).Run(
@@ -794,6 +859,9 @@ void JsonRpcService::OnGetBlockNumber(GetBlockNumberCallback callback,
     return;
   }
 
+  if (response_cache_) {
+    response_cache_->OnChainHead(network_url, Uint256ValueToHex(block_number));
+  }
   std::move(callback).Run(block_number, mojom::ProviderError::kSuccess, "");
 }
 
@@ -855,8 +923,12 @@ void JsonRpcService::GetBalance(const std::string& address,
     auto internal_callback =
         base::BindOnce(&JsonRpcService::OnEthGetBalance,
                        weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-    RequestInternal(eth::eth_getBalance(address, kEthereumBlockTagLatest), true,
-                    network_url, std::move(internal_callback));
+    const std::string json_payload =
+        eth::eth_getBalance(address, kEthereumBlockTagLatest);
+    if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+      RequestBatched(json_payload, true, network_url,
+                     std::move(internal_callback));
+    }
     return;
   } else if (coin == mojom::CoinType::FIL) {
     auto internal_callback =
@@ -1001,7 +1073,7 @@ void JsonRpcService::GetEthTransactionCount(const std::string& address,
       base::BindOnce(&JsonRpcService::OnEthGetTransactionCount,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
 
-  RequestInternal(
+  RequestBatched(
       eth::eth_getTransactionCount(address, kEthereumBlockTagLatest), true,
       network_url, std::move(internal_callback));
 }
@@ -1057,9 +1129,9 @@ void JsonRpcService::GetTransactionReceipt(const std::string& tx_hash,
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnGetTransactionReceipt,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(eth::eth_getTransactionReceipt(tx_hash), true,
-                  network_urls_[mojom::CoinType::ETH],
-                  std::move(internal_callback));
+  RequestBatched(eth::eth_getTransactionReceipt(tx_hash), true,
+                 network_urls_[mojom::CoinType::ETH],
+                 std::move(internal_callback));
 }
 
 void JsonRpcService::OnGetTransactionReceipt(
@@ -1134,9 +1206,12 @@ void JsonRpcService::GetERC20TokenBalance(
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnGetERC20TokenBalance,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(
-      eth::eth_call("", contract, "", "", "", data, kEthereumBlockTagLatest),
-      true, network_url, std::move(internal_callback));
+  const std::string json_payload =
+      eth::eth_call("", contract, "", "", "", data, kEthereumBlockTagLatest);
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestBatched(json_payload, true, network_url,
+                   std::move(internal_callback));
+  }
 }
 
 void JsonRpcService::OnGetERC20TokenBalance(
@@ -1286,9 +1361,12 @@ void JsonRpcService::GetERC20TokenBalances(
   auto internal_callback = base::BindOnce(
       &JsonRpcService::OnGetERC20TokenBalances, weak_ptr_factory_.GetWeakPtr(),
       token_contract_addresses, std::move(callback));
-  RequestInternal(
-      eth::eth_call(balance_scanner_contract_address, calldata.value()), true,
-      network_url, std::move(internal_callback));
+  const std::string json_payload =
+      eth::eth_call(balance_scanner_contract_address, calldata.value());
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestInternal(json_payload, true, network_url,
+                    std::move(internal_callback));
+  }
 }
 
 void JsonRpcService::OnGetERC20TokenBalances(
@@ -1357,9 +1435,13 @@ void JsonRpcService::EnsRegistryGetResolver(const std::string& domain,
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnEnsRegistryGetResolver,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(eth::eth_call("", contract_address, "", "", "", data,
-                                kEthereumBlockTagLatest),
-                  true, GetEnsRpcUrl(), std::move(internal_callback));
+  const GURL network_url = GetEnsRpcUrl();
+  const std::string json_payload = eth::eth_call(
+      "", contract_address, "", "", "", data, kEthereumBlockTagLatest);
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestInternal(json_payload, true, network_url,
+                    std::move(internal_callback));
+  }
 }
 
 void JsonRpcService::OnEnsRegistryGetResolver(
@@ -1445,9 +1527,13 @@ void JsonRpcService::ContinueEnsGetContentHash(
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnEnsGetContentHash,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(eth::eth_call("", resolver_address, "", "", "", data,
-                                kEthereumBlockTagLatest),
-                  true, GetEnsRpcUrl(), std::move(internal_callback));
+  const GURL network_url = GetEnsRpcUrl();
+  const std::string json_payload = eth::eth_call(
+      "", resolver_address, "", "", "", data, kEthereumBlockTagLatest);
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestInternal(json_payload, true, network_url,
+                    std::move(internal_callback));
+  }
 }
 
 void JsonRpcService::OnEnsGetContentHash(EnsGetContentHashCallback callback,
@@ -1778,9 +1864,13 @@ void JsonRpcService::ContinueEnsGetEthAddr(const std::string& domain,
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnEnsGetEthAddr,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(eth::eth_call("", resolver_address, "", "", "", data,
-                                kEthereumBlockTagLatest),
-                  true, GetEnsRpcUrl(), std::move(internal_callback));
+  const GURL network_url = GetEnsRpcUrl();
+  const std::string json_payload = eth::eth_call(
+      "", resolver_address, "", "", "", data, kEthereumBlockTagLatest);
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestInternal(json_payload, true, network_url,
+                    std::move(internal_callback));
+  }
 }
 
 void JsonRpcService::OnEnsGetEthAddr(EnsGetEthAddrCallback callback,
@@ -1846,9 +1936,11 @@ void JsonRpcService::UnstoppableDomainsResolveDns(
     auto eth_call = eth::eth_call(
         "", GetUnstoppableDomainsProxyReaderContractAddress(chain_id), "", "",
         "", *data, kEthereumBlockTagLatest);
-    RequestInternal(std::move(eth_call), true,
-                    GetUnstoppableDomainsRpcUrl(chain_id),
-                    std::move(internal_callback));
+    const GURL network_url = GetUnstoppableDomainsRpcUrl(chain_id);
+    if (!RespondFromCache(network_url, eth_call, &internal_callback)) {
+      RequestInternal(std::move(eth_call), true, network_url,
+                      std::move(internal_callback));
+    }
   }
 }
 
@@ -1912,9 +2004,11 @@ void JsonRpcService::UnstoppableDomainsGetWalletAddr(
     auto eth_call =
         eth::eth_call(GetUnstoppableDomainsProxyReaderContractAddress(chain_id),
                       ToHex(call_data));
-    RequestInternal(std::move(eth_call), true,
-                    GetUnstoppableDomainsRpcUrl(chain_id),
-                    std::move(internal_callback));
+    const GURL network_url = GetUnstoppableDomainsRpcUrl(chain_id);
+    if (!RespondFromCache(network_url, eth_call, &internal_callback)) {
+      RequestInternal(std::move(eth_call), true, network_url,
+                      std::move(internal_callback));
+    }
   }
 }
 
@@ -2189,9 +2283,12 @@ void JsonRpcService::GetERC721OwnerOf(const std::string& contract,
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnGetERC721OwnerOf,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(
-      eth::eth_call("", contract, "", "", "", data, kEthereumBlockTagLatest),
-      true, network_url, std::move(internal_callback));
+  const std::string json_payload =
+      eth::eth_call("", contract, "", "", "", data, kEthereumBlockTagLatest);
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestInternal(json_payload, true, network_url,
+                    std::move(internal_callback));
+  }
 }
 
 void JsonRpcService::OnGetERC721OwnerOf(GetERC721OwnerOfCallback callback,
@@ -2397,9 +2494,12 @@ void JsonRpcService::GetERC1155TokenBalance(
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnEthGetBalance,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(eth::eth_call("", contract_address, "", "", "", data,
-                                kEthereumBlockTagLatest),
-                  true, network_url, std::move(internal_callback));
+  const std::string json_payload = eth::eth_call(
+      "", contract_address, "", "", "", data, kEthereumBlockTagLatest);
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestInternal(json_payload, true, network_url,
+                    std::move(internal_callback));
+  }
 }
 
 void JsonRpcService::EthGetLogs(const std::string& chain_id,
@@ -2584,6 +2684,9 @@ void JsonRpcService::Reset() {
   SetNetwork(GetCurrentChainId(prefs_, mojom::CoinType::ETH),
              mojom::CoinType::ETH);
 
+  if (response_cache_) {
+    response_cache_->Clear();
+  }
   add_chain_pending_requests_.clear();
   switch_chain_requests_.clear();
   // Reject pending suggest token requests when network changed.
@@ -2614,9 +2717,12 @@ void JsonRpcService::GetSolanaBalance(const std::string& pubkey,
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnGetSolanaBalance,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(solana::getBalance(pubkey), true, network_url,
-                  std::move(internal_callback),
-                  base::BindOnce(&ConvertUint64ToString, "/result/value"));
+  const std::string json_payload = solana::getBalance(pubkey);
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestInternal(json_payload, true, network_url,
+                    std::move(internal_callback),
+                    base::BindOnce(&ConvertUint64ToString, "/result/value"));
+  }
 }
 
 void JsonRpcService::GetSPLTokenAccountBalance(
@@ -2645,8 +2751,12 @@ void JsonRpcService::GetSPLTokenAccountBalance(
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnGetSPLTokenAccountBalance,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(solana::getTokenAccountBalance(*associated_token_account),
-                  true, network_url, std::move(internal_callback));
+  const std::string json_payload =
+      solana::getTokenAccountBalance(*associated_token_account);
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    RequestInternal(json_payload, true, network_url,
+                    std::move(internal_callback));
+  }
 }
 
 void JsonRpcService::OnGetSolanaBalance(GetSolanaBalanceCallback callback,
@@ -2806,17 +2916,19 @@ void JsonRpcService::OnSendSolanaTransaction(
 
 void JsonRpcService::GetSolanaLatestBlockhash(
     GetSolanaLatestBlockhashCallback callback) {
+  const GURL network_url = network_urls_[mojom::CoinType::SOL];
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnGetSolanaLatestBlockhash,
-                     weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(solana::getLatestBlockhash(), true,
-                  network_urls_[mojom::CoinType::SOL],
+                     weak_ptr_factory_.GetWeakPtr(), network_url,
+                     std::move(callback));
+  RequestInternal(solana::getLatestBlockhash(), true, network_url,
                   std::move(internal_callback),
                   base::BindOnce(&ConvertUint64ToString,
                                  "/result/value/lastValidBlockHeight"));
 }
 
 void JsonRpcService::OnGetSolanaLatestBlockhash(
+    const GURL& network_url,
     GetSolanaLatestBlockhashCallback callback,
     APIRequestResult api_request_result) {
   if (!api_request_result.Is2XXResponseCode()) {
@@ -2838,6 +2950,9 @@ void JsonRpcService::OnGetSolanaLatestBlockhash(
     return;
   }
 
+  if (response_cache_) {
+    response_cache_->OnChainHead(network_url, blockhash);
+  }
   std::move(callback).Run(blockhash, last_valid_block_height,
                           mojom::SolanaProviderError::kSuccess, "");
 }
@@ -3002,12 +3117,15 @@ void JsonRpcService::GetSolanaTokenAccountsByOwner(
   auto internal_callback =
       base::BindOnce(&JsonRpcService::OnGetSolanaTokenAccountsByOwner,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback));
-  RequestInternal(
-      solana::getTokenAccountsByOwner(pubkey.ToBase58()), true,
-      network_urls_[mojom::CoinType::SOL], std::move(internal_callback),
-      base::BindOnce(&ConvertMultiUint64InObjectArrayToString, "/result/value",
-                     "/account",
-                     std::vector<std::string>({"lamports", "rentEpoch"})));
+  const GURL network_url = network_urls_[mojom::CoinType::SOL];
+  const std::string json_payload =
+      solana::getTokenAccountsByOwner(pubkey.ToBase58());
+  if (!RespondFromCache(network_url, json_payload, &internal_callback)) {
+    api_request_helper_->RequestUnparsed(
+        "POST", network_url, json_payload, "application/json", true,
+        std::move(internal_callback), MakeCommonJsonRpcHeaders(json_payload),
+        kMaxSolanaTokenAccountsByOwnerResponseSize);
+  }
 }
 
 void JsonRpcService::OnGetSolanaTokenAccountsByOwner(
@@ -3021,12 +3139,11 @@ void JsonRpcService::OnGetSolanaTokenAccountsByOwner(
   }
 
   std::vector<SolanaAccountInfo> token_accounts;
-  if (!solana::ParseGetTokenAccountsByOwner(api_request_result.value_body(),
-                                            &token_accounts)) {
-    mojom::SolanaProviderError error;
-    std::string error_message;
-    ParseErrorResult<mojom::SolanaProviderError>(
-        api_request_result.value_body(), &error, &error_message);
+  mojom::SolanaProviderError error;
+  std::string error_message;
+  if (!solana::ParseGetTokenAccountsByOwner(api_request_result.body(),
+                                            &token_accounts, &error,
+                                            &error_message)) {
     std::move(callback).Run(std::vector<SolanaAccountInfo>(), error,
                             error_message);
     return;
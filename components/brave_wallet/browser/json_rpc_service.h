@@ -19,6 +19,8 @@
 #include "brave/components/api_request_helper/api_request_helper.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/browser/ens_resolver_task.h"
+#include "brave/components/brave_wallet/browser/json_rpc_request_batcher.h"
+#include "brave/components/brave_wallet/browser/json_rpc_response_cache.h"
 #include "brave/components/brave_wallet/browser/nft_metadata_fetcher.h"
 #include "brave/components/brave_wallet/browser/sns_resolver_task.h"
 #include "brave/components/brave_wallet/browser/solana_transaction.h"
@@ -454,7 +456,8 @@ class JsonRpcService : public KeyedService, public mojom::JsonRpcService {
       APIRequestResult api_request_result);
   void OnGetFilBlockHeight(GetFilBlockHeightCallback callback,
                            APIRequestResult api_request_result);
-  void OnGetBlockNumber(GetBlockNumberCallback callback,
+  void OnGetBlockNumber(const GURL& network_url,
+                        GetBlockNumberCallback callback,
                         APIRequestResult api_request_result);
   void OnGetFeeHistory(GetFeeHistoryCallback callback,
                        APIRequestResult api_request_result);
@@ -545,6 +548,24 @@ class JsonRpcService : public KeyedService, public mojom::JsonRpcService {
       const GURL& network_url,
       RequestIntermediateCallback callback,
       APIRequestHelper::ResponseConversionCallback conversion_callback);
+  // Like RequestInternal, but sent in one batch request with the other calls
+  // to |network_url| made in the same task, unless batching is disabled by
+  // kBraveWalletJsonRpcBatchingFeature.
+  void RequestBatched(const std::string& json_payload,
+                      bool auto_retry_on_network_change,
+                      const GURL& network_url,
+                      RequestIntermediateCallback callback);
+  // Runs |callback| with the cached response to |json_payload| and returns
+  // true if there is one. Otherwise wraps |callback| to cache the response it
+  // gets and returns false, for the caller to send the request. Only used for
+  // read calls whose result can only change with the chain head.
+  bool RespondFromCache(const GURL& network_url,
+                        const std::string& json_payload,
+                        RequestIntermediateCallback* callback);
+  void OnCacheableResponse(const GURL& network_url,
+                           const std::string& json_payload,
+                           RequestIntermediateCallback callback,
+                           APIRequestResult api_request_result);
   void OnEthChainIdValidatedForOrigin(const std::string& chain_id,
                                       const GURL& rpc_url,
                                       APIRequestResult api_request_result);
@@ -584,7 +605,8 @@ class JsonRpcService : public KeyedService, public mojom::JsonRpcService {
                                    APIRequestResult api_request_result);
   void OnSendSolanaTransaction(SendSolanaTransactionCallback callback,
                                APIRequestResult api_request_result);
-  void OnGetSolanaLatestBlockhash(GetSolanaLatestBlockhashCallback callback,
+  void OnGetSolanaLatestBlockhash(const GURL& network_url,
+                                  GetSolanaLatestBlockhashCallback callback,
                                   APIRequestResult api_request_result);
   void OnGetSolanaSignatureStatuses(GetSolanaSignatureStatusesCallback callback,
                                     APIRequestResult api_request_result);
@@ -601,6 +623,9 @@ class JsonRpcService : public KeyedService, public mojom::JsonRpcService {
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
   std::unique_ptr<APIRequestHelper> api_request_helper_;
   std::unique_ptr<APIRequestHelper> api_request_helper_ens_offchain_;
+  std::unique_ptr<JsonRpcRequestBatcher> json_rpc_request_batcher_;
+  // Null unless the response cache feature is enabled.
+  std::unique_ptr<JsonRpcResponseCache> response_cache_;
   base::flat_map<mojom::CoinType, GURL> network_urls_;
   // <mojom::CoinType, chain_id>
   base::flat_map<mojom::CoinType, std::string> chain_ids_;
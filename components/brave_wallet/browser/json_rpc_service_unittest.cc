@@ -6300,4 +6300,84 @@ TEST_F(JsonRpcServiceUnitTest, GetEthTokenUri) {
                      mojom::ProviderError::kSuccess, "");
 }
 
+class ResponseCacheJsonRpcServiceUnitTest : public JsonRpcServiceUnitTest {
+ public:
+  ResponseCacheJsonRpcServiceUnitTest() = default;
+
+ protected:
+  // Answers eth_blockNumber with |block_number_| and other calls with a
+  // balance, counting requests.
+  void SetUp() override {
+    JsonRpcServiceUnitTest::SetUp();
+    url_loader_factory_.SetInterceptor(base::BindLambdaForTesting(
+        [&](const network::ResourceRequest& request) {
+          ++requests_sent_;
+          std::string method;
+          request.headers.GetHeader("X-Eth-Method", &method);
+          const std::string result =
+              method == "eth_blockNumber" ? block_number_ : "0xb539d5";
+          url_loader_factory_.ClearResponses();
+          url_loader_factory_.AddResponse(
+              request.url.spec(),
+              R"({"jsonrpc":"2.0","id":1,"result":")" + result + R"("})");
+        }));
+  }
+
+  void GetBalance() {
+    bool callback_called = false;
+    json_rpc_service_->GetBalance(
+        "0x4e02f254184E904300e0775E4b8eeCB1", mojom::CoinType::ETH,
+        mojom::kLocalhostChainId,
+        base::BindOnce(&OnStringResponse, &callback_called,
+                       mojom::ProviderError::kSuccess, "", "0xb539d5"));
+    base::RunLoop().RunUntilIdle();
+    EXPECT_TRUE(callback_called);
+  }
+
+  void GetBlockNumber() {
+    base::RunLoop run_loop;
+    json_rpc_service_->GetBlockNumber(base::BindLambdaForTesting(
+        [&](uint256_t block_number, mojom::ProviderError error,
+            const std::string& error_message) {
+          EXPECT_EQ(error, mojom::ProviderError::kSuccess);
+          run_loop.Quit();
+        }));
+    run_loop.Run();
+  }
+
+  size_t requests_sent_ = 0;
+  std::string block_number_ = "0x10";
+
+ private:
+  base::test::ScopedFeatureList feature_list_{
+      features::kBraveWalletResponseCacheFeature};
+};
+
+TEST_F(ResponseCacheJsonRpcServiceUnitTest, ServesReadsUntilNewBlock) {
+  GetBlockNumber();
+  EXPECT_EQ(requests_sent_, 1u);
+  GetBalance();
+  EXPECT_EQ(requests_sent_, 2u);
+  GetBalance();
+  EXPECT_EQ(requests_sent_, 2u);
+
+  // The same block keeps the cached balance.
+  GetBlockNumber();
+  GetBalance();
+  EXPECT_EQ(requests_sent_, 3u);
+
+  // A new block drops it.
+  block_number_ = "0x11";
+  GetBlockNumber();
+  GetBalance();
+  EXPECT_EQ(requests_sent_, 5u);
+  GetBalance();
+  EXPECT_EQ(requests_sent_, 5u);
+
+  // Reset clears the cache.
+  json_rpc_service_->Reset();
+  GetBalance();
+  EXPECT_EQ(requests_sent_, 6u);
+}
+
 }  // namespace brave_wallet
@@ -11,12 +11,15 @@
 #include "base/base64.h"
 #include "base/check_op.h"
 #include "base/command_line.h"
+#include "base/functional/barrier_callback.h"
+#include "base/functional/bind.h"
 #include "base/logging.h"
 #include "base/notreached.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/thread_pool.h"
 #include "base/value_iterators.h"
 #include "base/values.h"
 #include "brave/components/brave_wallet/browser/bitcoin_keyring.h"
@@ -39,6 +42,7 @@
 #include "components/prefs/pref_service.h"
 #include "components/prefs/scoped_user_pref_update.h"
 #include "crypto/random.h"
+#include "mojo/public/cpp/bindings/callback_helpers.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/re2/src/re2/re2.h"
 #include "ui/base/l10n/l10n_util.h"
@@ -157,6 +161,44 @@ std::string GetRootPath(const std::string& keyring_id) {
   return "";
 }
 
+std::unique_ptr<std::vector<uint8_t>> GetKeyringSeed(
+    const std::string& mnemonic,
+    bool is_legacy_brave_wallet) {
+  auto seed = is_legacy_brave_wallet ? MnemonicToEntropy(mnemonic)
+                                     : MnemonicToSeed(mnemonic, "");
+  if (!seed) {
+    return nullptr;
+  }
+  if (is_legacy_brave_wallet && seed->size() != 32) {
+    VLOG(1) << __func__
+            << "mnemonic for legacy brave wallet must be 24 words which will "
+               "produce 32 bytes seed";
+    return nullptr;
+  }
+  return seed;
+}
+
+std::unique_ptr<HDKeyring> ConstructKeyring(const std::string& keyring_id,
+                                            const std::vector<uint8_t>& seed) {
+  std::unique_ptr<HDKeyring> keyring;
+  if (keyring_id == mojom::kDefaultKeyringId) {
+    keyring = std::make_unique<EthereumKeyring>();
+  } else if (IsFilecoinKeyringId(keyring_id)) {
+    keyring = std::make_unique<FilecoinKeyring>(GetFilecoinChainId(keyring_id));
+  } else if (keyring_id == mojom::kSolanaKeyringId) {
+    keyring = std::make_unique<SolanaKeyring>();
+  } else if (keyring_id == mojom::kBitcoinKeyringId) {
+    keyring = std::make_unique<BitcoinKeyring>();
+  }
+  DCHECK(keyring) << "No HDKeyring for " << keyring_id;
+  if (keyring) {
+    // TODO(apaymyshev): Keyring creation is always followed by this method
+    // call. Should be moved into ctor.
+    keyring->ConstructRootHDKey(seed, GetRootPath(keyring_id));
+  }
+  return keyring;
+}
+
 static base::span<const uint8_t> ToSpan(base::StringPiece sp) {
   return base::as_bytes(base::make_span(sp));
 }
@@ -626,6 +668,14 @@ HDKeyring* KeyringService::ResumeKeyring(const std::string& keyring_id,
     keyring->AddAccounts(account_no);
   }
 
+  RestoreImportedAccounts(keyring_id, keyring);
+
+  return keyring;
+}
+
+void KeyringService::RestoreImportedAccounts(const std::string& keyring_id,
+                                             HDKeyring* keyring) {
+  DCHECK(keyring);
   for (const auto& imported_account_info :
        GetImportedAccountsForKeyring(profile_prefs_, keyring_id)) {
     auto private_key = encryptors_[keyring_id]->Decrypt(
@@ -645,8 +695,6 @@ HDKeyring* KeyringService::ResumeKeyring(const std::string& keyring_id,
       keyring->ImportAccount(*private_key);
     }
   }
-
-  return keyring;
 }
 
 HDKeyring* KeyringService::RestoreKeyring(const std::string& keyring_id,
@@ -1781,6 +1829,8 @@ absl::optional<std::string> KeyringService::GetFilecoinSelectedAccount(
 }
 
 void KeyringService::Lock() {
+  // Drops the keys of an unlock still deriving them.
+  pending_unlock_id_.reset();
   if (IsLockedSync()) {
     return;
   }
@@ -1806,47 +1856,150 @@ bool KeyringService::IsHardwareAccount(const std::string& keyring_id,
   return false;
 }
 
+KeyringService::DerivedKeyring::DerivedKeyring() = default;
+KeyringService::DerivedKeyring::~DerivedKeyring() = default;
+KeyringService::DerivedKeyring::DerivedKeyring(DerivedKeyring&&) = default;
+KeyringService::DerivedKeyring& KeyringService::DerivedKeyring::operator=(
+    DerivedKeyring&&) = default;
+
 void KeyringService::Unlock(const std::string& password,
                             KeyringService::UnlockCallback callback) {
-  if (!ResumeKeyring(mojom::kDefaultKeyringId, password)) {
-    encryptors_.erase(mojom::kDefaultKeyringId);
+  // Keyrings of a concurrent unlock would be installed twice.
+  if (password.empty() || pending_unlock_id_) {
     std::move(callback).Run(false);
     return;
   }
+  pending_unlock_id_ = ++last_unlock_id_;
 
+  // Added 08.08.2022
+  MaybeMigratePBKDF2Iterations(password);
+
+  std::vector<std::string> keyring_ids = {mojom::kDefaultKeyringId};
   if (IsFilecoinEnabled()) {
-    if (!ResumeKeyring(mojom::kFilecoinKeyringId, password)) {
-      // If Filecoin keyring doesnt exist we keep encryptor pre-created
-      // to be able to lazily create keyring later
-      if (IsKeyringExist(mojom::kFilecoinKeyringId)) {
-        VLOG(1) << __func__ << " Unable to unlock filecoin keyring";
-        encryptors_.erase(mojom::kFilecoinKeyringId);
-        std::move(callback).Run(false);
-        return;
-      }
+    keyring_ids.push_back(mojom::kFilecoinKeyringId);
+    keyring_ids.push_back(mojom::kFilecoinTestnetKeyringId);
+  }
+  if (IsSolanaEnabled()) {
+    keyring_ids.push_back(mojom::kSolanaKeyringId);
+  }
+  if (IsBitcoinEnabled()) {
+    keyring_ids.push_back(mojom::kBitcoinKeyringId);
+  }
+
+  // Each keyring runs PBKDF2 and derives its accounts on a worker of its own,
+  // so unlocking takes as long as the slowest keyring rather than all of them.
+  auto barrier_callback = base::BarrierCallback<DerivedKeyring>(
+      keyring_ids.size(),
+      base::BindOnce(&KeyringService::OnKeyringsDerived,
+                     weak_ptr_factory_.GetWeakPtr(), *pending_unlock_id_,
+                     mojo::WrapCallbackWithDefaultInvokeIfNotRun(
+                         std::move(callback), false)));
+  for (const auto& keyring_id : keyring_ids) {
+    auto encrypted_mnemonic = GetPrefInBytesForKeyring(
+        *profile_prefs_, kEncryptedMnemonic, keyring_id);
+    std::vector<uint8_t> nonce;
+    if (encrypted_mnemonic) {
+      nonce = GetOrCreateNonceForKeyring(keyring_id);
     }
-
-    if (!ResumeKeyring(mojom::kFilecoinTestnetKeyringId, password)) {
-      if (IsKeyringExist(mojom::kFilecoinTestnetKeyringId)) {
-        VLOG(1) << __func__ << " Unable to unlock filecoin testnet keyring";
-        encryptors_.erase(mojom::kFilecoinTestnetKeyringId);
-        std::move(callback).Run(false);
-        return;
-      }
+    bool is_legacy_brave_wallet = false;
+    if (auto* value = GetPrefForKeyring(*profile_prefs_, kLegacyBraveWallet,
+                                        keyring_id)) {
+      is_legacy_brave_wallet = value->GetBool();
     }
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE, {base::TaskPriority::USER_BLOCKING},
+        base::BindOnce(
+            &KeyringService::DeriveKeyring, keyring_id, password,
+            GetPbkdf2Iterations(), GetOrCreateSaltForKeyring(keyring_id),
+            std::move(nonce), std::move(encrypted_mnemonic),
+            is_legacy_brave_wallet,
+            GetDerivedAccountsNumberForKeyring(profile_prefs_, keyring_id)),
+        base::BindOnce(barrier_callback));
+  }
+}
+
+// static
+KeyringService::DerivedKeyring KeyringService::DeriveKeyring(
+    const std::string& keyring_id,
+    const std::string& password,
+    int pbkdf2_iterations,
+    const std::vector<uint8_t>& salt,
+    const std::vector<uint8_t>& nonce,
+    absl::optional<std::vector<uint8_t>> encrypted_mnemonic,
+    bool is_legacy_brave_wallet,
+    size_t accounts_number) {
+  DerivedKeyring result;
+  result.keyring_id = keyring_id;
+  result.encryptor = PasswordEncryptor::DeriveKeyFromPasswordUsingPbkdf2(
+      password, salt, pbkdf2_iterations, kPbkdf2KeySize);
+  result.encrypted_mnemonic = std::move(encrypted_mnemonic);
+  if (!result.encryptor || !result.encrypted_mnemonic) {
+    return result;
+  }
+
+  auto mnemonic = result.encryptor->Decrypt(*result.encrypted_mnemonic, nonce);
+  if (!mnemonic) {
+    return result;
+  }
+  auto seed = GetKeyringSeed(std::string(mnemonic->begin(), mnemonic->end()),
+                             is_legacy_brave_wallet);
+  if (!seed) {
+    return result;
+  }
+  result.keyring = ConstructKeyring(keyring_id, *seed);
+  if (result.keyring && accounts_number) {
+    result.keyring->AddAccounts(accounts_number);
   }
+  return result;
+}
 
-  if (IsSolanaEnabled() && !ResumeKeyring(mojom::kSolanaKeyringId, password)) {
-    if (IsKeyringExist(mojom::kSolanaKeyringId)) {
-      VLOG(1) << __func__ << " Unable to unlock Solana keyring";
-      encryptors_.erase(mojom::kSolanaKeyringId);
+void KeyringService::OnKeyringsDerived(
+    uint64_t unlock_id,
+    UnlockCallback callback,
+    std::vector<DerivedKeyring> derived_keyrings) {
+  // The wallet got locked or reset while the keys were being derived.
+  if (pending_unlock_id_ != unlock_id) {
+    std::move(callback).Run(false);
+    return;
+  }
+  pending_unlock_id_.reset();
+
+  // Keyrings are derived in any order but resumed in the order they used to
+  // be unlocked in, the default keyring first.
+  base::flat_map<std::string, DerivedKeyring> derived_keyrings_by_id;
+  for (auto& derived_keyring : derived_keyrings) {
+    const std::string keyring_id = derived_keyring.keyring_id;
+    derived_keyrings_by_id[keyring_id] = std::move(derived_keyring);
+  }
+
+  if (!ResumeDerivedKeyring(
+          std::move(derived_keyrings_by_id[mojom::kDefaultKeyringId]))) {
+    encryptors_.erase(mojom::kDefaultKeyringId);
+    std::move(callback).Run(false);
+    return;
+  }
+
+  for (const auto* keyring_id :
+       {mojom::kFilecoinKeyringId, mojom::kFilecoinTestnetKeyringId,
+        mojom::kSolanaKeyringId}) {
+    auto it = derived_keyrings_by_id.find(keyring_id);
+    if (it == derived_keyrings_by_id.end()) {
+      continue;
+    }
+    // If the keyring doesnt exist we keep its encryptor pre-created to be
+    // able to lazily create the keyring later.
+    if (!ResumeDerivedKeyring(std::move(it->second)) &&
+        IsKeyringExist(keyring_id)) {
+      VLOG(1) << __func__ << " Unable to unlock " << keyring_id << " keyring";
+      encryptors_.erase(keyring_id);
       std::move(callback).Run(false);
       return;
     }
   }
 
-  if (IsBitcoinEnabled()) {
-    auto* bitcoin_keyring = ResumeKeyring(mojom::kBitcoinKeyringId, password);
+  auto it = derived_keyrings_by_id.find(mojom::kBitcoinKeyringId);
+  if (it != derived_keyrings_by_id.end()) {
+    auto* bitcoin_keyring = ResumeDerivedKeyring(std::move(it->second));
     DCHECK(bitcoin_keyring);
   }
 
@@ -1860,6 +2013,26 @@ void KeyringService::Unlock(const std::string& password,
   std::move(callback).Run(true);
 }
 
+HDKeyring* KeyringService::ResumeDerivedKeyring(
+    DerivedKeyring derived_keyring) {
+  const std::string& keyring_id = derived_keyring.keyring_id;
+  // Keys derived before the wallet got reset or restored are stale.
+  if (GetPrefInBytesForKeyring(*profile_prefs_, kEncryptedMnemonic,
+                               keyring_id) !=
+      derived_keyring.encrypted_mnemonic) {
+    return nullptr;
+  }
+
+  encryptors_[keyring_id] = std::move(derived_keyring.encryptor);
+  if (!encryptors_[keyring_id] || !derived_keyring.keyring) {
+    return nullptr;
+  }
+  auto* keyring = derived_keyring.keyring.get();
+  keyrings_[keyring_id] = std::move(derived_keyring.keyring);
+  RestoreImportedAccounts(keyring_id, keyring);
+  return keyring;
+}
+
 void KeyringService::OnAutoLockFired() {
   Lock();
 }
@@ -1869,6 +2042,7 @@ void KeyringService::IsLocked(IsLockedCallback callback) {
 }
 
 void KeyringService::Reset(bool notify_observer) {
+  pending_unlock_id_.reset();
   StopAutoLockTimer();
   encryptors_.clear();
   keyrings_.clear();
@@ -2070,17 +2244,10 @@ HDKeyring* KeyringService::CreateKeyringInternal(const std::string& keyring_id,
     return nullptr;
   }
 
-  auto seed = is_legacy_brave_wallet ? MnemonicToEntropy(mnemonic)
-                                     : MnemonicToSeed(mnemonic, "");
+  auto seed = GetKeyringSeed(mnemonic, is_legacy_brave_wallet);
   if (!seed) {
     return nullptr;
   }
-  if (is_legacy_brave_wallet && seed->size() != 32) {
-    VLOG(1) << __func__
-            << "mnemonic for legacy brave wallet must be 24 words which will "
-               "produce 32 bytes seed";
-    return nullptr;
-  }
 
   std::vector<uint8_t> encrypted_mnemonic = encryptors_[keyring_id]->Encrypt(
       ToSpan(mnemonic), GetOrCreateNonceForKeyring(keyring_id));
@@ -2090,27 +2257,15 @@ HDKeyring* KeyringService::CreateKeyringInternal(const std::string& keyring_id,
   SetPrefForKeyring(profile_prefs_, kLegacyBraveWallet,
                     base::Value(is_legacy_brave_wallet), keyring_id);
 
-  if (keyring_id == mojom::kDefaultKeyringId) {
-    keyrings_[mojom::kDefaultKeyringId] = std::make_unique<EthereumKeyring>();
-  } else if (IsFilecoinKeyringId(keyring_id)) {
-    keyrings_[keyring_id] =
-        std::make_unique<FilecoinKeyring>(GetFilecoinChainId(keyring_id));
-  } else if (keyring_id == mojom::kSolanaKeyringId) {
-    keyrings_[mojom::kSolanaKeyringId] = std::make_unique<SolanaKeyring>();
-  } else if (keyring_id == mojom::kBitcoinKeyringId) {
-    keyrings_[mojom::kBitcoinKeyringId] = std::make_unique<BitcoinKeyring>();
-  }
-  auto* keyring = GetHDKeyringById(keyring_id);
-  DCHECK(keyring) << "No HDKeyring for " << keyring_id;
-  if (keyring) {
-    // TODO(apaymyshev): Keyring creation is always followed by this method
-    // call. Should be moved into ctor.
-    keyring->ConstructRootHDKey(*seed, GetRootPath(keyring_id));
+  auto keyring = ConstructKeyring(keyring_id, *seed);
+  if (!keyring) {
+    return nullptr;
   }
+  keyrings_[keyring_id] = std::move(keyring);
 
   UpdateLastUnlockPref(local_state_);
 
-  return keyring;
+  return GetHDKeyringById(keyring_id);
 }
 
 bool KeyringService::IsKeyringCreated(const std::string& keyring_id) const {
@@ -250,6 +250,7 @@ class KeyringService : public KeyedService, public mojom::KeyringService {
   FRIEND_TEST_ALL_PREFIXES(KeyringServiceUnitTest,
                            GetMnemonicForDefaultKeyring);
   FRIEND_TEST_ALL_PREFIXES(KeyringServiceUnitTest, LockAndUnlock);
+  FRIEND_TEST_ALL_PREFIXES(KeyringServiceUnitTest, UnlockWithManyAccounts);
   FRIEND_TEST_ALL_PREFIXES(KeyringServiceUnitTest, Reset);
   FRIEND_TEST_ALL_PREFIXES(KeyringServiceUnitTest, AccountMetasForKeyring);
   FRIEND_TEST_ALL_PREFIXES(KeyringServiceUnitTest, CreateAndRestoreWallet);
@@ -355,6 +356,36 @@ class KeyringService : public KeyedService, public mojom::KeyringService {
   // It's used to reconstruct same default keyring between browser relaunch
   HDKeyring* ResumeKeyring(const std::string& keyring_id,
                            const std::string& password);
+  void RestoreImportedAccounts(const std::string& keyring_id,
+                               HDKeyring* keyring);
+
+  // Encryptor and keyring with its derived accounts, derived on the thread
+  // pool when unlocking.
+  struct DerivedKeyring {
+    DerivedKeyring();
+    ~DerivedKeyring();
+    DerivedKeyring(DerivedKeyring&&);
+    DerivedKeyring& operator=(DerivedKeyring&&);
+
+    std::string keyring_id;
+    // Mnemonic the keyring was derived from, as encrypted in prefs.
+    absl::optional<std::vector<uint8_t>> encrypted_mnemonic;
+    std::unique_ptr<PasswordEncryptor> encryptor;
+    std::unique_ptr<HDKeyring> keyring;
+  };
+  static DerivedKeyring DeriveKeyring(
+      const std::string& keyring_id,
+      const std::string& password,
+      int pbkdf2_iterations,
+      const std::vector<uint8_t>& salt,
+      const std::vector<uint8_t>& nonce,
+      absl::optional<std::vector<uint8_t>> encrypted_mnemonic,
+      bool is_legacy_brave_wallet,
+      size_t accounts_number);
+  void OnKeyringsDerived(uint64_t unlock_id,
+                         UnlockCallback callback,
+                         std::vector<DerivedKeyring> derived_keyrings);
+  HDKeyring* ResumeDerivedKeyring(DerivedKeyring derived_keyring);
 
   void MaybeMigratePBKDF2Iterations(const std::string& password);
 
@@ -387,6 +418,10 @@ class KeyringService : public KeyedService, public mojom::KeyringService {
   std::unique_ptr<PrefChangeRegistrar> pref_change_registrar_;
   base::flat_map<std::string, std::unique_ptr<HDKeyring>> keyrings_;
   base::flat_map<std::string, std::unique_ptr<PasswordEncryptor>> encryptors_;
+  // Id of the unlock deriving keys on the thread pool, if any. Lock() and
+  // Reset() clear it so that its keys are dropped once derived.
+  absl::optional<uint64_t> pending_unlock_id_;
+  uint64_t last_unlock_id_ = 0;
 
   raw_ptr<JsonRpcService> json_rpc_service_;
   raw_ptr<PrefService> profile_prefs_ = nullptr;
@@ -397,6 +432,7 @@ class KeyringService : public KeyedService, public mojom::KeyringService {
   mojo::ReceiverSet<mojom::KeyringService> receivers_;
 
   base::WeakPtrFactory<KeyringService> discovery_weak_factory_{this};
+  base::WeakPtrFactory<KeyringService> weak_ptr_factory_{this};
 
   KeyringService(const KeyringService&) = delete;
   KeyringService& operator=(const KeyringService&) = delete;
@@ -15,6 +15,8 @@
 #include "brave/components/brave_wallet/browser/json_rpc_response_parser.h"
 #include "brave/components/brave_wallet/common/brave_wallet_types.h"
 #include "brave/components/json/rs/src/lib.rs.h"
+#include "components/grit/brave_components_strings.h"
+#include "ui/base/l10n/l10n_util.h"
 
 namespace brave_wallet {
 
@@ -274,38 +276,59 @@ bool ParseGetBlockHeight(const base::Value& json_value,
   return base::StringToUint64(*block_height_string, block_height);
 }
 
-bool ParseGetTokenAccountsByOwner(const base::Value& json_value,
-                                  std::vector<SolanaAccountInfo>* accounts) {
+bool ParseGetTokenAccountsByOwner(const std::string& raw_response,
+                                  std::vector<SolanaAccountInfo>* accounts,
+                                  mojom::SolanaProviderError* error,
+                                  std::string* error_message) {
   DCHECK(accounts);
-
-  auto result = ParseResultDict(json_value);
-  if (!result)
+  DCHECK(error);
+  DCHECK(error_message);
+
+  // The message is only looked up on failure, so that successful parses
+  // don't need the resource bundle.
+  const auto set_parsing_error = [error, error_message]() {
+    *error = mojom::SolanaProviderError::kParsingError;
+    *error_message = l10n_util::GetStringUTF8(IDS_WALLET_PARSING_ERROR);
     return false;
+  };
+
+  json::SolanaTokenAccountsByOwnerResponse response = {};
+  if (!json::parse_solana_token_accounts_by_owner(
+          rust::Slice<const uint8_t>(
+              reinterpret_cast<const uint8_t*>(raw_response.data()),
+              raw_response.size()),
+          response)) {
+    return set_parsing_error();
+  }
 
-  const auto* account_dicts_list = result->FindList("value");
-  if (!account_dicts_list)
+  if (response.has_error) {
+    *error = static_cast<mojom::SolanaProviderError>(
+        static_cast<int32_t>(response.error_code));
+    if (!mojom::IsKnownEnumValue(*error)) {
+      *error = mojom::SolanaProviderError::kUnknown;
+    }
+    *error_message = std::string(response.error_message);
     return false;
+  }
 
-  // For each account dict, get the "account" key and parse the value as an
-  // SolanaAccountInfo
-  for (const auto& account_dict : *account_dicts_list) {
-    const auto* account_dict_value = account_dict.GetIfDict();
-    if (!account_dict_value)
-      return false;
-
-    const auto* account_value = account_dict_value->Find("account");
-    if (!account_value)
-      return false;
-
-    absl::optional<SolanaAccountInfo> account_info;
-    if (!ParseGetAccountInfoPayload(account_value->GetDict(), &account_info))
-      return false;
-
-    if (account_info.has_value()) {
-      accounts->push_back(std::move(*account_info));
+  std::vector<SolanaAccountInfo> parsed_accounts;
+  parsed_accounts.reserve(response.accounts.size());
+  for (const auto& account : response.accounts) {
+    std::string data(account.data);
+    if (std::string(account.data_encoding) != "base64" ||
+        !base::Base64Decode(data)) {
+      return set_parsing_error();
     }
+    SolanaAccountInfo account_info;
+    account_info.lamports = account.lamports;
+    account_info.owner = std::string(account.owner);
+    account_info.data = std::move(data);
+    account_info.executable = account.executable;
+    account_info.rent_epoch = account.rent_epoch;
+    parsed_accounts.push_back(std::move(account_info));
   }
 
+  *accounts = std::move(parsed_accounts);
   return true;
 }
 
@@ -11,6 +11,7 @@
 
 #include "base/functional/callback.h"
 #include "base/values.h"
+#include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 // TODO(apaymyshev): refactor utility methods to return absl::optional instead
@@ -42,8 +43,14 @@ bool ParseGetAccountInfoPayload(
     absl::optional<SolanaAccountInfo>* account_info_out);
 bool ParseGetFeeForMessage(const base::Value& json_value, uint64_t* fee);
 bool ParseGetBlockHeight(const base::Value& json_value, uint64_t* block_height);
-bool ParseGetTokenAccountsByOwner(const base::Value& json_value,
-                                  std::vector<SolanaAccountInfo>* accounts);
+// Parses the raw body of a getTokenAccountsByOwner response, which can be
+// several megabytes, without building a base::Value tree of it. On failure
+// |error| and |error_message| are set from the JSON-RPC error of the
+// response, or to a parsing error.
+bool ParseGetTokenAccountsByOwner(const std::string& raw_response,
+                                  std::vector<SolanaAccountInfo>* accounts,
+                                  mojom::SolanaProviderError* error,
+                                  std::string* error_message);
 
 base::OnceCallback<absl::optional<std::string>(const std::string& raw_response)>
 ConverterForGetAccountInfo();
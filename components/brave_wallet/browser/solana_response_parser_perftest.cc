@@ -0,0 +1,131 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/solana_response_parser.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/json/json_reader.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/components/brave_wallet/browser/json_rpc_response_parser.h"
+#include "brave/components/brave_wallet/common/brave_wallet_types.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace brave_wallet {
+
+namespace solana {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "SolanaTokenAccountsByOwner.";
+constexpr char kMetricTimePerResponse[] = "time_per_response";
+// Bytes of the converted body and base::Value tree built by the previous path.
+// Parsing the raw body builds neither, so it reports 0.
+constexpr char kMetricIntermediateBytes[] = "intermediate_bytes";
+
+// A token account as returned by the RPC, with 165 bytes of base64 data.
+std::string MakeResponse(size_t account_count) {
+  std::string json =
+      R"({"jsonrpc":"2.0","id":1,"result":{"context":{"slot":1},"value":[)";
+  for (size_t i = 0; i < account_count; ++i) {
+    if (i) {
+      json += ",";
+    }
+    json += R"({"account":{"data":[")" + std::string(220, 'A') +
+            R"(","base64"],"executable":false,"lamports":2039280,)"
+            R"("owner":"TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA",)"
+            R"("rentEpoch":361},"pubkey":")" +
+            base::NumberToString(i) + R"("})";
+  }
+  json += "]}}";
+  return json;
+}
+
+// Parses |json| the way other responses are parsed: amounts are converted to
+// strings, a base::Value tree is built and then walked. Returns the bytes
+// held in the intermediate copies.
+size_t ParseThroughValueTree(const std::string& json,
+                             std::vector<SolanaAccountInfo>* accounts) {
+  absl::optional<std::string> converted =
+      ConvertMultiUint64InObjectArrayToString("/result/value", "/account",
+                                              {"lamports", "rentEpoch"}, json);
+  EXPECT_TRUE(converted);
+  if (!converted) {
+    return 0;
+  }
+  absl::optional<base::Value> value = base::JSONReader::Read(*converted);
+  EXPECT_TRUE(value);
+  if (!value) {
+    return 0;
+  }
+  for (const auto& item :
+       *value->GetDict().FindListByDottedPath("result.value")) {
+    absl::optional<SolanaAccountInfo> account_info;
+    EXPECT_TRUE(ParseGetAccountInfoPayload(*item.GetDict().FindDict("account"),
+                                           &account_info));
+    if (account_info) {
+      accounts->push_back(std::move(*account_info));
+    }
+  }
+  return converted->size() + value->EstimateMemoryUsage();
+}
+
+// Parses |json| from the raw body, as JsonRpcService does now. Only the typed
+// accounts are built, so there is no intermediate copy to report.
+size_t ParseFromRawBody(const std::string& json,
+                        std::vector<SolanaAccountInfo>* accounts) {
+  mojom::SolanaProviderError error;
+  std::string error_message;
+  EXPECT_TRUE(
+      ParseGetTokenAccountsByOwner(json, accounts, &error, &error_message));
+  return 0;
+}
+
+}  // namespace
+
+// Compares parsing large getTokenAccountsByOwner responses from the raw body
+// against going through a base::Value tree.
+class SolanaResponseParserPerfTest : public ::testing::Test {
+ protected:
+  template <typename ParseFunction>
+  void Run(const std::string& story_prefix, ParseFunction parse_function) {
+    for (size_t account_count : {1000u, 10000u, 50000u}) {
+      const std::string json = MakeResponse(account_count);
+
+      std::vector<SolanaAccountInfo> accounts;
+      const base::ElapsedTimer timer;
+      const size_t intermediate_bytes = parse_function(json, &accounts);
+      const base::TimeDelta elapsed = timer.Elapsed();
+      EXPECT_EQ(account_count, accounts.size());
+
+      perf_test::PerfResultReporter reporter(
+          kMetricPrefix,
+          story_prefix + "_" + base::NumberToString(account_count) +
+              "_accounts");
+      reporter.RegisterImportantMetric(kMetricTimePerResponse, "ms");
+      reporter.RegisterImportantMetric(kMetricIntermediateBytes, "bytes");
+      reporter.AddResult(kMetricTimePerResponse, elapsed);
+      reporter.AddResult(kMetricIntermediateBytes, intermediate_bytes);
+    }
+  }
+};
+
+TEST_F(SolanaResponseParserPerfTest, ValueTree) {
+  Run("value_tree", &ParseThroughValueTree);
+}
+
+TEST_F(SolanaResponseParserPerfTest, RawBody) {
+  Run("raw_body", &ParseFromRawBody);
+}
+
+}  // namespace solana
+
+}  // namespace brave_wallet
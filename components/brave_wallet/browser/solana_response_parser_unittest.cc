@@ -6,11 +6,18 @@
 #include "brave/components/brave_wallet/browser/solana_response_parser.h"
 
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "base/json/json_reader.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/test/gtest_util.h"
 #include "base/test/values_test_util.h"
+#include "brave/components/brave_wallet/browser/json_rpc_response_parser.h"
 #include "brave/components/brave_wallet/common/brave_wallet_types.h"
+#include "components/grit/brave_components_strings.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "ui/base/l10n/l10n_util.h"
 
 using base::test::ParseJson;
 
@@ -372,9 +379,9 @@ TEST(SolanaResponseParserUnitTest, ParseGetTokenAccountsByOwner) {
               "base64"
             ],
             "executable": false,
-            "lamports": "2039280",
+            "lamports": 2039280,
             "owner": "TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA",
-            "rentEpoch": "361"
+            "rentEpoch": 18446744073709551615
           },
           "pubkey": "81ZdQjbr7FhEPmcyGJtG8BAUyWxAjb2iSiWFEQn8i8Da"
         },
@@ -384,10 +391,10 @@ TEST(SolanaResponseParserUnitTest, ParseGetTokenAccountsByOwner) {
               "z6cxAUoRHIupvmezOL4EAsTLlwKTgwxzCg/xcNWSEu42kEWUG3BArj8SJRSnd1faFt2Tm0Ey/qtGnPdOOlQlugEAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA",
               "base64"
             ],
-            "executable": false,
-            "lamports": "2039280",
+            "executable": true,
+            "lamports": 18446744073709551615,
             "owner": "TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA",
-            "rentEpoch": "361"
+            "rentEpoch": 361
           },
           "pubkey": "5gjGaTE41sPVS1Dzwg43ipdj9NTtApZLcK55ihRuVb6Y"
         }
@@ -397,8 +404,116 @@ TEST(SolanaResponseParserUnitTest, ParseGetTokenAccountsByOwner) {
   })";
 
   std::vector<SolanaAccountInfo> token_accounts;
-  EXPECT_TRUE(ParseGetTokenAccountsByOwner(ParseJson(json), &token_accounts));
-  EXPECT_EQ(token_accounts.size(), 2u);
+  mojom::SolanaProviderError error;
+  std::string error_message;
+  EXPECT_TRUE(ParseGetTokenAccountsByOwner(json, &token_accounts, &error,
+                                           &error_message));
+  ASSERT_EQ(token_accounts.size(), 2u);
+  EXPECT_EQ(token_accounts[0].lamports, 2039280u);
+  EXPECT_EQ(token_accounts[0].rent_epoch, UINT64_MAX);
+  EXPECT_EQ(token_accounts[0].owner,
+            "TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA");
+  EXPECT_FALSE(token_accounts[0].executable);
+  EXPECT_EQ(token_accounts[0].data.substr(0, 8), "afxiYbRC");
+  EXPECT_EQ(token_accounts[1].lamports, UINT64_MAX);
+  EXPECT_EQ(token_accounts[1].rent_epoch, 361u);
+  EXPECT_TRUE(token_accounts[1].executable);
+
+  json = R"({"jsonrpc":"2.0","id":1,"result":{"context":{},"value":[]}})";
+  EXPECT_TRUE(ParseGetTokenAccountsByOwner(json, &token_accounts, &error,
+                                           &error_message));
+  EXPECT_TRUE(token_accounts.empty());
+
+  // JSON-RPC error.
+  json = R"({"jsonrpc":"2.0","id":1,
+             "error":{"code":-32601,"message":"method does not exist"}})";
+  EXPECT_FALSE(ParseGetTokenAccountsByOwner(json, &token_accounts, &error,
+                                            &error_message));
+  EXPECT_EQ(error, mojom::SolanaProviderError::kMethodNotFound);
+  EXPECT_EQ(error_message, "method does not exist");
+
+  json = R"({"jsonrpc":"2.0","id":1,"error":{"code":123}})";
+  EXPECT_FALSE(ParseGetTokenAccountsByOwner(json, &token_accounts, &error,
+                                            &error_message));
+  EXPECT_EQ(error, mojom::SolanaProviderError::kUnknown);
+  EXPECT_EQ(error_message, "");
+
+  // Malformed responses.
+  for (const std::string& malformed : {
+           std::string(""),
+           std::string("{"),
+           std::string(R"({"jsonrpc":"2.0","id":1})"),
+           std::string(R"({"jsonrpc":"2.0","result":{"value":[]}})"),
+           std::string(R"({"jsonrpc":"2.0","id":1,"result":{"value":{}}})"),
+           // Amounts converted to strings.
+           std::string(R"({"jsonrpc":"2.0","id":1,"result":{"value":[
+               {"account":{"data":["","base64"],"executable":false,
+                "lamports":"1","owner":"o","rentEpoch":1}}]}})"),
+           // Amounts over uint64.
+           std::string(R"({"jsonrpc":"2.0","id":1,"result":{"value":[
+               {"account":{"data":["","base64"],"executable":false,
+                "lamports":18446744073709551616,"owner":"o",
+                "rentEpoch":1}}]}})"),
+           // Not base64 data.
+           std::string(R"({"jsonrpc":"2.0","id":1,"result":{"value":[
+               {"account":{"data":["","base58"],"executable":false,
+                "lamports":1,"owner":"o","rentEpoch":1}}]}})"),
+           std::string(R"({"jsonrpc":"2.0","id":1,"result":{"value":[
+               {"account":{"data":["!!","base64"],"executable":false,
+                "lamports":1,"owner":"o","rentEpoch":1}}]}})"),
+       }) {
+    SCOPED_TRACE(malformed);
+    error = mojom::SolanaProviderError::kSuccess;
+    EXPECT_FALSE(ParseGetTokenAccountsByOwner(malformed, &token_accounts,
+                                              &error, &error_message));
+    EXPECT_EQ(error, mojom::SolanaProviderError::kParsingError);
+    EXPECT_EQ(error_message,
+              l10n_util::GetStringUTF8(IDS_WALLET_PARSING_ERROR));
+  }
+}
+
+// Parsing a large getTokenAccountsByOwner response from the raw body gives the
+// same accounts as parsing it the way other responses are parsed, converting
+// amounts to strings, building a base::Value tree and walking it.
+TEST(SolanaResponseParserUnitTest,
+     ParseGetTokenAccountsByOwnerMatchesValueTree) {
+  constexpr size_t kAccounts = 1000;
+  std::string json =
+      R"({"jsonrpc":"2.0","id":1,"result":{"context":{"slot":1},"value":[)";
+  for (size_t i = 0; i < kAccounts; ++i) {
+    if (i) {
+      json += ",";
+    }
+    json += R"({"account":{"data":[")" + std::string(220, 'A') +
+            R"(","base64"],"executable":false,"lamports":2039280,)"
+            R"("owner":"TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA",)"
+            R"("rentEpoch":361},"pubkey":")" +
+            base::NumberToString(i) + R"("})";
+  }
+  json += "]}}";
+
+  absl::optional<std::string> converted =
+      ConvertMultiUint64InObjectArrayToString("/result/value", "/account",
+                                              {"lamports", "rentEpoch"}, json);
+  ASSERT_TRUE(converted);
+  absl::optional<base::Value> value = base::JSONReader::Read(*converted);
+  ASSERT_TRUE(value);
+  std::vector<SolanaAccountInfo> value_accounts;
+  for (const auto& item : *value->GetDict().FindListByDottedPath(
+           "result.value")) {
+    absl::optional<SolanaAccountInfo> account_info;
+    ASSERT_TRUE(ParseGetAccountInfoPayload(
+        *item.GetDict().FindDict("account"), &account_info));
+    value_accounts.push_back(std::move(*account_info));
+  }
+
+  std::vector<SolanaAccountInfo> raw_accounts;
+  mojom::SolanaProviderError error;
+  std::string error_message;
+  ASSERT_TRUE(ParseGetTokenAccountsByOwner(json, &raw_accounts, &error,
+                                           &error_message));
+  EXPECT_EQ(raw_accounts.size(), kAccounts);
+  EXPECT_EQ(raw_accounts, value_accounts);
 }
 
 TEST(SolanaResponseParserUnitTest, ConverterForGetAccountInfo) {
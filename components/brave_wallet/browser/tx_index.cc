@@ -0,0 +1,228 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/tx_index.h"
+
+#include <iterator>
+#include <utility>
+
+#include "base/containers/cxx20_erase_map.h"
+#include "base/json/values_util.h"
+#include "base/ranges/algorithm.h"
+#include "brave/components/brave_wallet/browser/tx_meta.h"
+
+namespace brave_wallet {
+
+TxIndex::Chain::Chain() = default;
+TxIndex::Chain::~Chain() = default;
+TxIndex::Chain::Chain(Chain&&) = default;
+TxIndex::Chain& TxIndex::Chain::operator=(Chain&&) = default;
+
+void TxIndex::Chain::Put(const std::string& id, Entry entry) {
+  Remove(id);
+  ids_by_status[entry.status].insert(id);
+  ids_by_from[entry.from].insert(id);
+  entries.emplace(id, std::move(entry));
+}
+
+void TxIndex::Chain::Remove(const std::string& id) {
+  auto it = entries.find(id);
+  if (it == entries.end()) {
+    return;
+  }
+  auto status_it = ids_by_status.find(it->second.status);
+  status_it->second.erase(id);
+  if (status_it->second.empty()) {
+    ids_by_status.erase(status_it);
+  }
+  auto from_it = ids_by_from.find(it->second.from);
+  from_it->second.erase(id);
+  if (from_it->second.empty()) {
+    ids_by_from.erase(from_it);
+  }
+  entries.erase(it);
+}
+
+bool TxIndex::Chain::Matches(const base::Value::Dict* chain_dict) const {
+  size_t count = 0;
+  if (chain_dict) {
+    for (const auto [id, value] : *chain_dict) {
+      absl::optional<Entry> entry = EntryFromValue(value);
+      if (!entry) {
+        continue;
+      }
+      auto it = entries.find(id);
+      if (it == entries.end() || it->second != *entry) {
+        return false;
+      }
+      ++count;
+    }
+  }
+  return count == entries.size();
+}
+
+// static
+absl::optional<TxIndex::Entry> TxIndex::EntryFromValue(
+    const base::Value& value) {
+  const base::Value::Dict* tx = value.GetIfDict();
+  if (!tx) {
+    return absl::nullopt;
+  }
+  absl::optional<int> status = tx->FindInt("status");
+  const std::string* from = tx->FindString("from");
+  const base::Value* created_time = tx->Find("created_time");
+  const base::Value* confirmed_time = tx->Find("confirmed_time");
+  if (!status || !from || !created_time || !confirmed_time) {
+    return absl::nullopt;
+  }
+  absl::optional<base::Time> created_time_from_value =
+      base::ValueToTime(created_time);
+  absl::optional<base::Time> confirmed_time_from_value =
+      base::ValueToTime(confirmed_time);
+  if (!created_time_from_value || !confirmed_time_from_value) {
+    return absl::nullopt;
+  }
+  return Entry{static_cast<mojom::TransactionStatus>(*status), *from,
+               *created_time_from_value, *confirmed_time_from_value};
+}
+
+TxIndex::TxIndex() = default;
+TxIndex::~TxIndex() = default;
+
+bool TxIndex::HasChain(const std::string& chain) const {
+  return chains_.contains(chain);
+}
+
+void TxIndex::LoadChain(const std::string& chain,
+                        const base::Value::Dict* chain_dict) {
+  Chain& indexed_chain = chains_[chain] = Chain();
+  if (!chain_dict) {
+    return;
+  }
+
+  for (const auto [id, value] : *chain_dict) {
+    absl::optional<Entry> entry = EntryFromValue(value);
+    if (entry) {
+      indexed_chain.Put(id, std::move(*entry));
+    }
+  }
+}
+
+void TxIndex::RemoveChain(const std::string& chain) {
+  chains_.erase(chain);
+}
+
+void TxIndex::RemoveStaleChains(const base::Value::Dict& transactions) {
+  base::EraseIf(chains_, [&](const auto& indexed_chain) {
+    return !indexed_chain.second.Matches(
+        transactions.FindDictByDottedPath(indexed_chain.first));
+  });
+}
+
+void TxIndex::Clear() {
+  chains_.clear();
+}
+
+void TxIndex::AddOrUpdateTx(const std::string& chain, const TxMeta& meta) {
+  chains_[chain].Put(meta.id(), {meta.status(), meta.from(),
+                                 meta.created_time(), meta.confirmed_time()});
+}
+
+void TxIndex::DeleteTx(const std::string& chain, const std::string& id) {
+  auto it = chains_.find(chain);
+  if (it != chains_.end()) {
+    it->second.Remove(id);
+  }
+}
+
+std::vector<std::string> TxIndex::FindTxIds(
+    const std::string& chain,
+    absl::optional<mojom::TransactionStatus> status,
+    const absl::optional<std::string>& from) const {
+  std::vector<std::string> ids;
+  auto chain_it = chains_.find(chain);
+  if (chain_it == chains_.end()) {
+    return ids;
+  }
+  const Chain& indexed_chain = chain_it->second;
+
+  if (!status && !from) {
+    ids.reserve(indexed_chain.entries.size());
+    for (const auto& entry : indexed_chain.entries) {
+      ids.push_back(entry.first);
+    }
+    return ids;
+  }
+
+  const std::set<std::string>* status_ids = nullptr;
+  if (status) {
+    auto it = indexed_chain.ids_by_status.find(*status);
+    if (it == indexed_chain.ids_by_status.end()) {
+      return ids;
+    }
+    status_ids = &it->second;
+  }
+  const std::set<std::string>* from_ids = nullptr;
+  if (from) {
+    auto it = indexed_chain.ids_by_from.find(*from);
+    if (it == indexed_chain.ids_by_from.end()) {
+      return ids;
+    }
+    from_ids = &it->second;
+  }
+
+  if (status_ids && from_ids) {
+    base::ranges::set_intersection(*status_ids, *from_ids,
+                                   std::back_inserter(ids));
+  } else {
+    const std::set<std::string>& matching_ids =
+        status_ids ? *status_ids : *from_ids;
+    ids.assign(matching_ids.begin(), matching_ids.end());
+  }
+  return ids;
+}
+
+size_t TxIndex::CountTxsByStatus(const std::string& chain,
+                                 mojom::TransactionStatus status) const {
+  auto chain_it = chains_.find(chain);
+  if (chain_it == chains_.end()) {
+    return 0;
+  }
+  auto it = chain_it->second.ids_by_status.find(status);
+  return it == chain_it->second.ids_by_status.end() ? 0 : it->second.size();
+}
+
+absl::optional<std::string> TxIndex::FindOldestTxId(
+    const std::string& chain,
+    mojom::TransactionStatus status) const {
+  auto chain_it = chains_.find(chain);
+  if (chain_it == chains_.end()) {
+    return absl::nullopt;
+  }
+  const Chain& indexed_chain = chain_it->second;
+  auto status_it = indexed_chain.ids_by_status.find(status);
+  if (status_it == indexed_chain.ids_by_status.end()) {
+    return absl::nullopt;
+  }
+
+  auto time_of = [&](const std::string& id) {
+    const Entry& entry = indexed_chain.entries.at(id);
+    return status == mojom::TransactionStatus::Confirmed ? entry.confirmed_time
+                                                         : entry.created_time;
+  };
+  // The first of equally old transactions wins, as ids are visited in order.
+  const std::string* oldest_id = nullptr;
+  base::Time oldest_time;
+  for (const std::string& id : status_it->second) {
+    const base::Time time = time_of(id);
+    if (!oldest_id || time < oldest_time) {
+      oldest_id = &id;
+      oldest_time = time;
+    }
+  }
+  return *oldest_id;
+}
+
+}  // namespace brave_wallet
@@ -0,0 +1,102 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_TX_INDEX_H_
+#define BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_TX_INDEX_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/time/time.h"
+#include "base/values.h"
+#include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace brave_wallet {
+
+class TxMeta;
+
+// In-memory index of the stored transactions of each network, keyed by the
+// transaction pref path prefix of the network (ex: ethereum.mainnet). Only
+// the fields transactions are looked up by are kept, so finding transactions
+// by status or from address doesn't need to deserialize every TxMeta of the
+// network. Ids are always returned in the order they are stored in prefs.
+class TxIndex {
+ public:
+  TxIndex();
+  ~TxIndex();
+  TxIndex(const TxIndex&) = delete;
+  TxIndex& operator=(const TxIndex&) = delete;
+
+  bool HasChain(const std::string& chain) const;
+
+  // Indexes the transactions of |chain| as they are stored in prefs.
+  // |chain_dict| is null when |chain| has no transactions yet. Malformed
+  // transactions are skipped.
+  void LoadChain(const std::string& chain,
+                 const base::Value::Dict* chain_dict);
+  void RemoveChain(const std::string& chain);
+  // Removes the indexed chains whose transactions in |transactions|, the
+  // value of the transactions pref, no longer match the index. Chains only
+  // differing in fields that aren't indexed are kept.
+  void RemoveStaleChains(const base::Value::Dict& transactions);
+  void Clear();
+
+  void AddOrUpdateTx(const std::string& chain, const TxMeta& meta);
+  void DeleteTx(const std::string& chain, const std::string& id);
+
+  // Returns the ids of the transactions of |chain| with |status| and |from|,
+  // either of which matches any transaction when not given.
+  std::vector<std::string> FindTxIds(
+      const std::string& chain,
+      absl::optional<mojom::TransactionStatus> status,
+      const absl::optional<std::string>& from) const;
+  size_t CountTxsByStatus(const std::string& chain,
+                          mojom::TransactionStatus status) const;
+  // Returns the id of the oldest transaction of |chain| with |status|.
+  // Confirmed transactions are ordered by confirmed time and all others by
+  // created time.
+  absl::optional<std::string> FindOldestTxId(
+      const std::string& chain,
+      mojom::TransactionStatus status) const;
+
+ private:
+  struct Entry {
+    mojom::TransactionStatus status;
+    std::string from;
+    base::Time created_time;
+    base::Time confirmed_time;
+
+    friend bool operator==(const Entry&, const Entry&) = default;
+  };
+
+  // Returns the indexed fields of a transaction as stored in prefs, or
+  // nullopt if it is malformed.
+  static absl::optional<Entry> EntryFromValue(const base::Value& value);
+
+  struct Chain {
+    Chain();
+    ~Chain();
+    Chain(Chain&&);
+    Chain& operator=(Chain&&);
+
+    void Put(const std::string& id, Entry entry);
+    void Remove(const std::string& id);
+    // Whether |chain_dict| holds exactly the indexed transactions.
+    bool Matches(const base::Value::Dict* chain_dict) const;
+
+    std::map<std::string, Entry> entries;
+    std::map<mojom::TransactionStatus, std::set<std::string>> ids_by_status;
+    std::map<std::string, std::set<std::string>> ids_by_from;
+  };
+
+  std::map<std::string, Chain> chains_;
+};
+
+}  // namespace brave_wallet
+
+#endif  // BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_TX_INDEX_H_
@@ -0,0 +1,193 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/tx_index.h"
+
+#include <string>
+#include <vector>
+
+#include "base/time/time.h"
+#include "base/values.h"
+#include "brave/components/brave_wallet/browser/eth_tx_meta.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_wallet {
+
+namespace {
+
+constexpr char kChain[] = "ethereum.mainnet";
+constexpr char kOtherChain[] = "ethereum.goerli";
+constexpr char kFrom1[] = "0x3535353535353535353535353535353535353535";
+constexpr char kFrom2[] = "0x2f015c60e0be116b1f0cd534704db9c92118fb6a";
+
+EthTxMeta MakeTxMeta(const std::string& id,
+                     mojom::TransactionStatus status,
+                     const std::string& from) {
+  EthTxMeta meta;
+  meta.set_id(id);
+  meta.set_status(status);
+  meta.set_from(from);
+  return meta;
+}
+
+}  // namespace
+
+TEST(TxIndexUnitTest, FindTxIds) {
+  TxIndex index;
+  EXPECT_FALSE(index.HasChain(kChain));
+  index.AddOrUpdateTx(
+      kChain, MakeTxMeta("3", mojom::TransactionStatus::Submitted, kFrom1));
+  index.AddOrUpdateTx(
+      kChain, MakeTxMeta("1", mojom::TransactionStatus::Submitted, kFrom2));
+  index.AddOrUpdateTx(
+      kChain, MakeTxMeta("2", mojom::TransactionStatus::Confirmed, kFrom1));
+  index.AddOrUpdateTx(
+      kOtherChain,
+      MakeTxMeta("4", mojom::TransactionStatus::Submitted, kFrom1));
+  EXPECT_TRUE(index.HasChain(kChain));
+
+  using Ids = std::vector<std::string>;
+  EXPECT_EQ(index.FindTxIds(kChain, absl::nullopt, absl::nullopt),
+            Ids({"1", "2", "3"}));
+  EXPECT_EQ(index.FindTxIds(kChain, mojom::TransactionStatus::Submitted,
+                            absl::nullopt),
+            Ids({"1", "3"}));
+  EXPECT_EQ(index.FindTxIds(kChain, absl::nullopt, std::string(kFrom1)),
+            Ids({"2", "3"}));
+  EXPECT_EQ(index.FindTxIds(kChain, mojom::TransactionStatus::Submitted,
+                            std::string(kFrom1)),
+            Ids({"3"}));
+  EXPECT_TRUE(index
+                  .FindTxIds(kChain, mojom::TransactionStatus::Rejected,
+                             absl::nullopt)
+                  .empty());
+  EXPECT_EQ(index.FindTxIds(kOtherChain, absl::nullopt, absl::nullopt),
+            Ids({"4"}));
+
+  // Updates move the transaction between indexes.
+  index.AddOrUpdateTx(
+      kChain, MakeTxMeta("3", mojom::TransactionStatus::Confirmed, kFrom1));
+  EXPECT_EQ(index.FindTxIds(kChain, mojom::TransactionStatus::Submitted,
+                            absl::nullopt),
+            Ids({"1"}));
+  EXPECT_EQ(index.CountTxsByStatus(kChain, mojom::TransactionStatus::Confirmed),
+            2u);
+
+  index.DeleteTx(kChain, "1");
+  EXPECT_EQ(index.FindTxIds(kChain, absl::nullopt, std::string(kFrom2)),
+            Ids());
+  EXPECT_EQ(index.CountTxsByStatus(kChain, mojom::TransactionStatus::Submitted),
+            0u);
+
+  index.RemoveChain(kChain);
+  EXPECT_FALSE(index.HasChain(kChain));
+  EXPECT_TRUE(index.HasChain(kOtherChain));
+  index.Clear();
+  EXPECT_FALSE(index.HasChain(kOtherChain));
+}
+
+TEST(TxIndexUnitTest, LoadChain) {
+  base::Value::Dict chain_dict;
+  chain_dict.Set(
+      "1",
+      MakeTxMeta("1", mojom::TransactionStatus::Submitted, kFrom1).ToValue());
+  chain_dict.Set(
+      "2",
+      MakeTxMeta("2", mojom::TransactionStatus::Rejected, kFrom2).ToValue());
+  base::Value::Dict malformed =
+      MakeTxMeta("3", mojom::TransactionStatus::Submitted, kFrom1).ToValue();
+  malformed.Remove("created_time");
+  chain_dict.Set("3", std::move(malformed));
+  chain_dict.Set("4", "not a transaction");
+
+  TxIndex index;
+  index.LoadChain(kChain, &chain_dict);
+  EXPECT_EQ(index.FindTxIds(kChain, absl::nullopt, absl::nullopt),
+            std::vector<std::string>({"1", "2"}));
+  EXPECT_EQ(index.FindTxIds(kChain, mojom::TransactionStatus::Rejected,
+                            std::string(kFrom2)),
+            std::vector<std::string>({"2"}));
+
+  index.LoadChain(kOtherChain, nullptr);
+  EXPECT_TRUE(index.HasChain(kOtherChain));
+  EXPECT_TRUE(
+      index.FindTxIds(kOtherChain, absl::nullopt, absl::nullopt).empty());
+}
+
+TEST(TxIndexUnitTest, RemoveStaleChains) {
+  EthTxMeta meta1 =
+      MakeTxMeta("1", mojom::TransactionStatus::Submitted, kFrom1);
+  EthTxMeta meta2 =
+      MakeTxMeta("2", mojom::TransactionStatus::Submitted, kFrom2);
+  base::Value::Dict transactions;
+  transactions.SetByDottedPath("ethereum.mainnet.1", meta1.ToValue());
+  transactions.SetByDottedPath("ethereum.goerli.2", meta2.ToValue());
+
+  TxIndex index;
+  index.AddOrUpdateTx(kChain, meta1);
+  index.AddOrUpdateTx(kOtherChain, meta2);
+  index.LoadChain("ethereum.sepolia", nullptr);
+  index.RemoveStaleChains(transactions);
+  EXPECT_TRUE(index.HasChain(kChain));
+  EXPECT_TRUE(index.HasChain(kOtherChain));
+  EXPECT_TRUE(index.HasChain("ethereum.sepolia"));
+
+  // Fields that aren't indexed don't make a chain stale.
+  transactions.SetByDottedPath("ethereum.mainnet.1.tx_hash", "0x1234");
+  index.RemoveStaleChains(transactions);
+  EXPECT_TRUE(index.HasChain(kChain));
+
+  // Only the chain whose transactions changed is dropped.
+  meta2.set_status(mojom::TransactionStatus::Confirmed);
+  transactions.SetByDottedPath("ethereum.goerli.2", meta2.ToValue());
+  index.RemoveStaleChains(transactions);
+  EXPECT_TRUE(index.HasChain(kChain));
+  EXPECT_FALSE(index.HasChain(kOtherChain));
+
+  // As is one with transactions added or removed.
+  transactions.SetByDottedPath("ethereum.sepolia.3", meta1.ToValue());
+  transactions.RemoveByDottedPath("ethereum.mainnet.1");
+  index.RemoveStaleChains(transactions);
+  EXPECT_FALSE(index.HasChain(kChain));
+  EXPECT_FALSE(index.HasChain("ethereum.sepolia"));
+}
+
+TEST(TxIndexUnitTest, FindOldestTxId) {
+  TxIndex index;
+  EXPECT_FALSE(
+      index.FindOldestTxId(kChain, mojom::TransactionStatus::Confirmed));
+
+  const base::Time now = base::Time::Now();
+  EthTxMeta confirmed1 =
+      MakeTxMeta("1", mojom::TransactionStatus::Confirmed, kFrom1);
+  confirmed1.set_created_time(now - base::Days(3));
+  confirmed1.set_confirmed_time(now);
+  EthTxMeta confirmed2 =
+      MakeTxMeta("2", mojom::TransactionStatus::Confirmed, kFrom1);
+  confirmed2.set_created_time(now);
+  confirmed2.set_confirmed_time(now - base::Days(1));
+  EthTxMeta rejected3 =
+      MakeTxMeta("3", mojom::TransactionStatus::Rejected, kFrom1);
+  rejected3.set_created_time(now);
+  EthTxMeta rejected4 =
+      MakeTxMeta("4", mojom::TransactionStatus::Rejected, kFrom1);
+  rejected4.set_created_time(now - base::Days(1));
+  EthTxMeta rejected5 =
+      MakeTxMeta("5", mojom::TransactionStatus::Rejected, kFrom1);
+  rejected5.set_created_time(now - base::Days(1));
+  for (const auto* meta :
+       {&confirmed1, &confirmed2, &rejected3, &rejected4, &rejected5}) {
+    index.AddOrUpdateTx(kChain, *meta);
+  }
+
+  // Confirmed transactions are ordered by confirmed time.
+  EXPECT_EQ(index.FindOldestTxId(kChain, mojom::TransactionStatus::Confirmed),
+            "2");
+  // Others by created time, the first id winning a tie.
+  EXPECT_EQ(index.FindOldestTxId(kChain, mojom::TransactionStatus::Rejected),
+            "4");
+}
+
+}  // namespace brave_wallet
@@ -7,6 +7,8 @@
 
 #include <utility>
 
+#include "base/auto_reset.h"
+#include "base/functional/bind.h"
 #include "base/json/values_util.h"
 #include "base/values.h"
 #include "brave/components/brave_wallet/browser/pref_names.h"
@@ -22,6 +24,11 @@ namespace {
 constexpr size_t kMaxConfirmedTxNum = 10;
 constexpr size_t kMaxRejectedTxNum = 10;
 
+// The chain whose transactions a TxStateManager is writing to prefs, if any.
+// Writes made by one manager only need to be checked against that chain by
+// the others.
+const std::string* g_chain_being_written = nullptr;
+
 }  // namespace
 
 // static
@@ -92,18 +99,31 @@ TxStateManager::TxStateManager(PrefService* prefs,
                                JsonRpcService* json_rpc_service)
     : prefs_(prefs), json_rpc_service_(json_rpc_service), weak_factory_(this) {
   DCHECK(json_rpc_service_);
+  pref_change_registrar_.Init(prefs_);
+  pref_change_registrar_.Add(
+      kBraveWalletTransactions,
+      base::BindRepeating(&TxStateManager::OnTransactionsPrefChanged,
+                          base::Unretained(this)));
 }
 
 TxStateManager::~TxStateManager() = default;
 
 void TxStateManager::AddOrUpdateTx(const TxMeta& meta) {
-  ScopedDictPrefUpdate update(prefs_, kBraveWalletTransactions);
-  base::Value::Dict& dict = update.Get();
-  const std::string path =
-      base::JoinString({GetTxPrefPathPrefix(), meta.id()}, ".");
-
-  bool is_add = dict.FindByDottedPath(path) == nullptr;
-  dict.SetByDottedPath(path, meta.ToValue());
+  const std::string chain = GetTxPrefPathPrefix();
+  EnsureChainIndexed(chain);
+  bool is_add = false;
+  {
+    base::AutoReset<bool> updating_prefs(&updating_prefs_, true);
+    base::AutoReset<const std::string*> chain_being_written(
+        &g_chain_being_written, &chain);
+    ScopedDictPrefUpdate update(prefs_, kBraveWalletTransactions);
+    base::Value::Dict& dict = update.Get();
+    const std::string path = base::JoinString({chain, meta.id()}, ".");
+
+    is_add = dict.FindByDottedPath(path) == nullptr;
+    dict.SetByDottedPath(path, meta.ToValue());
+  }
+  tx_index_.AddOrUpdateTx(chain, meta);
   if (!is_add) {
     for (auto& observer : observers_)
       observer.OnTransactionStatusChanged(meta.ToTransactionInfo());
@@ -129,36 +149,51 @@ std::unique_ptr<TxMeta> TxStateManager::GetTx(const std::string& id) {
 }
 
 void TxStateManager::DeleteTx(const std::string& id) {
-  ScopedDictPrefUpdate update(prefs_, kBraveWalletTransactions);
-  update->RemoveByDottedPath(
-      base::JoinString({GetTxPrefPathPrefix(), id}, "."));
+  const std::string chain = GetTxPrefPathPrefix();
+  {
+    base::AutoReset<bool> updating_prefs(&updating_prefs_, true);
+    base::AutoReset<const std::string*> chain_being_written(
+        &g_chain_being_written, &chain);
+    ScopedDictPrefUpdate update(prefs_, kBraveWalletTransactions);
+    update->RemoveByDottedPath(base::JoinString({chain, id}, "."));
+  }
+  tx_index_.DeleteTx(chain, id);
 }
 
 void TxStateManager::WipeTxs() {
-  ScopedDictPrefUpdate update(prefs_, kBraveWalletTransactions);
-  update->RemoveByDottedPath(GetTxPrefPathPrefix());
+  const std::string chain = GetTxPrefPathPrefix();
+  {
+    base::AutoReset<bool> updating_prefs(&updating_prefs_, true);
+    base::AutoReset<const std::string*> chain_being_written(
+        &g_chain_being_written, &chain);
+    ScopedDictPrefUpdate update(prefs_, kBraveWalletTransactions);
+    update->RemoveByDottedPath(chain);
+  }
+  tx_index_.RemoveChain(chain);
 }
 
 std::vector<std::unique_ptr<TxMeta>> TxStateManager::GetTransactionsByStatus(
     absl::optional<mojom::TransactionStatus> status,
     absl::optional<std::string> from) {
   std::vector<std::unique_ptr<TxMeta>> result;
+  const std::string chain = GetTxPrefPathPrefix();
+  EnsureChainIndexed(chain);
   const auto& dict = prefs_->GetDict(kBraveWalletTransactions);
-  const base::Value::Dict* network_dict =
-      dict.FindDictByDottedPath(GetTxPrefPathPrefix());
+  const base::Value::Dict* network_dict = dict.FindDictByDottedPath(chain);
   if (!network_dict)
     return result;
 
-  for (const auto it : *network_dict) {
-    std::unique_ptr<TxMeta> meta = ValueToTxMeta(it.second.GetDict());
-    if (!meta) {
+  // Only the matching transactions are deserialized.
+  for (const std::string& id : tx_index_.FindTxIds(chain, status, from)) {
+    const base::Value::Dict* value = network_dict->FindDict(id);
+    if (!value) {
       continue;
     }
-    if (!status.has_value() || meta->status() == *status) {
-      if (from.has_value() && meta->from() != *from)
-        continue;
-      result.push_back(std::move(meta));
+    std::unique_ptr<TxMeta> meta = ValueToTxMeta(*value);
+    if (!meta) {
+      continue;
     }
+    result.push_back(std::move(meta));
   }
   return result;
 }
@@ -168,25 +203,37 @@ void TxStateManager::RetireTxByStatus(mojom::TransactionStatus status,
   if (status != mojom::TransactionStatus::Confirmed &&
       status != mojom::TransactionStatus::Rejected)
     return;
-  auto tx_metas = GetTransactionsByStatus(status, absl::nullopt);
-  if (tx_metas.size() > max_num) {
-    TxMeta* oldest_meta = nullptr;
-    for (const auto& tx_meta : tx_metas) {
-      if (!oldest_meta) {
-        oldest_meta = tx_meta.get();
-      } else {
-        if (tx_meta->status() == mojom::TransactionStatus::Confirmed &&
-            tx_meta->confirmed_time() < oldest_meta->confirmed_time()) {
-          oldest_meta = tx_meta.get();
-        } else if (tx_meta->status() == mojom::TransactionStatus::Rejected &&
-                   tx_meta->created_time() < oldest_meta->created_time()) {
-          oldest_meta = tx_meta.get();
-        }
-      }
-    }
-    DCHECK(oldest_meta);
-    DeleteTx(oldest_meta->id());
+  const std::string chain = GetTxPrefPathPrefix();
+  EnsureChainIndexed(chain);
+  if (tx_index_.CountTxsByStatus(chain, status) > max_num) {
+    absl::optional<std::string> oldest_id =
+        tx_index_.FindOldestTxId(chain, status);
+    DCHECK(oldest_id);
+    DeleteTx(*oldest_id);
+  }
+}
+
+void TxStateManager::EnsureChainIndexed(const std::string& chain) {
+  if (tx_index_.HasChain(chain)) {
+    return;
+  }
+  tx_index_.LoadChain(chain, prefs_->GetDict(kBraveWalletTransactions)
+                                 .FindDictByDottedPath(chain));
+}
+
+void TxStateManager::OnTransactionsPrefChanged() {
+  if (updating_prefs_) {
+    return;
+  }
+  if (g_chain_being_written) {
+    // Another manager changed the transactions of a single chain, usually of
+    // another coin type and so not indexed here.
+    tx_index_.RemoveChain(*g_chain_being_written);
+    return;
   }
+  // Changes made outside of any manager, e.g. by a wallet reset, may affect
+  // any chain, so only the chains that actually changed are indexed again.
+  tx_index_.RemoveStaleChains(prefs_->GetDict(kBraveWalletTransactions));
 }
 
 void TxStateManager::AddObserver(TxStateManager::Observer* observer) {
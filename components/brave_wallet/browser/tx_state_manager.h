@@ -15,7 +15,9 @@
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "base/observer_list_types.h"
+#include "brave/components/brave_wallet/browser/tx_index.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
+#include "components/prefs/pref_change_registrar.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 class PrefService;
@@ -63,8 +65,16 @@ class TxStateManager {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(TxStateManagerUnitTest, TxOperations);
+  FRIEND_TEST_ALL_PREFIXES(TxStateManagerUnitTest,
+                           IndexedLookupMatchesDeserializingAll);
+  FRIEND_TEST_ALL_PREFIXES(TxStateManagerUnitTest,
+                           OtherManagersOnlyInvalidateTheirChain);
   void RetireTxByStatus(mojom::TransactionStatus status, size_t max_num);
 
+  // Indexes the transactions of |chain| from prefs if they aren't yet.
+  void EnsureChainIndexed(const std::string& chain);
+  void OnTransactionsPrefChanged();
+
   // Each derived class should implement its own ValueToTxMeta to create a
   // specific type of tx meta (ex: EthTxMeta) from a value. TxMeta
   // properties can be filled via the protected ValueToTxMeta function above.
@@ -79,6 +89,14 @@ class TxStateManager {
 
   base::ObserverList<Observer> observers_;
 
+  // Prefs remain the storage of transactions, |tx_index_| is kept in sync with
+  // every write made here. When another manager writes the pref, the chain it
+  // wrote is dropped from it. When the pref is changed elsewhere, e.g. by a
+  // wallet reset, the chains whose transactions changed are dropped from it.
+  TxIndex tx_index_;
+  PrefChangeRegistrar pref_change_registrar_;
+  bool updating_prefs_ = false;
+
   base::WeakPtrFactory<TxStateManager> weak_factory_;
 };
 
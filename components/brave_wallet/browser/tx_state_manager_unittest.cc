@@ -4,10 +4,13 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "brave/components/brave_wallet/browser/tx_state_manager.h"
 
 #include "base/run_loop.h"
+#include "base/strings/strcat.h"
 #include "base/test/bind.h"
 #include "base/test/task_environment.h"
 #include "base/time/time.h"
@@ -20,6 +23,7 @@
 #include "brave/components/brave_wallet/browser/pref_names.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
 #include "components/prefs/pref_service.h"
+#include "components/prefs/scoped_user_pref_update.h"
 #include "components/sync_preferences/testing_pref_service_syncable.h"
 #include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
 #include "services/network/test/test_url_loader_factory.h"
@@ -384,4 +388,119 @@ TEST_F(TxStateManagerUnitTest, Observer) {
   observer.Reset();
 }
 
+TEST_F(TxStateManagerUnitTest, FollowsExternalPrefChanges) {
+  prefs_.ClearPref(kBraveWalletTransactions);
+
+  EthTxMeta meta;
+  meta.set_id("001");
+  meta.set_status(mojom::TransactionStatus::Submitted);
+  tx_state_manager_->AddOrUpdateTx(meta);
+  EXPECT_EQ(tx_state_manager_
+                ->GetTransactionsByStatus(mojom::TransactionStatus::Submitted,
+                                          absl::nullopt)
+                .size(),
+            1u);
+
+  // Transactions written to prefs by someone else are found.
+  meta.set_id("002");
+  {
+    ScopedDictPrefUpdate update(&prefs_, kBraveWalletTransactions);
+    update->SetByDottedPath("ethereum.mainnet.002", meta.ToValue());
+  }
+  EXPECT_EQ(tx_state_manager_
+                ->GetTransactionsByStatus(mojom::TransactionStatus::Submitted,
+                                          absl::nullopt)
+                .size(),
+            2u);
+
+  // And cleared transactions are gone.
+  prefs_.ClearPref(kBraveWalletTransactions);
+  EXPECT_TRUE(
+      tx_state_manager_->GetTransactionsByStatus(absl::nullopt, absl::nullopt)
+          .empty());
+}
+
+TEST_F(TxStateManagerUnitTest, OtherManagersOnlyInvalidateTheirChain) {
+  prefs_.ClearPref(kBraveWalletTransactions);
+  EthTxStateManager other_tx_state_manager(&prefs_, json_rpc_service_.get());
+
+  EthTxMeta meta;
+  meta.set_id("001");
+  meta.set_status(mojom::TransactionStatus::Submitted);
+  tx_state_manager_->AddOrUpdateTx(meta);
+  SetNetwork("0x5", mojom::CoinType::ETH);
+  meta.set_id("002");
+  tx_state_manager_->AddOrUpdateTx(meta);
+  const std::string mainnet = "ethereum.mainnet";
+  const std::string goerli = tx_state_manager_->GetTxPrefPathPrefix();
+  ASSERT_NE(mainnet, goerli);
+  EXPECT_TRUE(tx_state_manager_->tx_index_.HasChain(mainnet));
+  EXPECT_TRUE(tx_state_manager_->tx_index_.HasChain(goerli));
+
+  // Only the chain written by the other manager is dropped from the index.
+  meta.set_id("003");
+  other_tx_state_manager.AddOrUpdateTx(meta);
+  EXPECT_TRUE(tx_state_manager_->tx_index_.HasChain(mainnet));
+  EXPECT_FALSE(tx_state_manager_->tx_index_.HasChain(goerli));
+  EXPECT_EQ(tx_state_manager_
+                ->GetTransactionsByStatus(mojom::TransactionStatus::Submitted,
+                                          absl::nullopt)
+                .size(),
+            2u);
+}
+
+// Looking up the pending transactions of a network among many historical
+// transactions across networks through the index finds the same transactions
+// as deserializing every transaction of the network.
+TEST_F(TxStateManagerUnitTest, IndexedLookupMatchesDeserializingAll) {
+  constexpr size_t kTxsPerNetwork = 300;
+  constexpr size_t kPendingTxsPerNetwork = kTxsPerNetwork / 50;
+  const std::string from[] = {"0x3535353535353535353535353535353535353535",
+                              "0x2f015c60e0be116b1f0cd534704db9c92118fb6a"};
+
+  // Written straight to prefs, as transactions stored by earlier versions.
+  prefs_.ClearPref(kBraveWalletTransactions);
+  {
+    ScopedDictPrefUpdate update(&prefs_, kBraveWalletTransactions);
+    for (const char* network : {"mainnet", "goerli", "sepolia"}) {
+      for (size_t i = 0; i < kTxsPerNetwork; ++i) {
+        EthTxMeta meta;
+        meta.set_id(base::NumberToString(i));
+        meta.set_from(from[i % 2]);
+        meta.set_status(i % 50 == 0 ? mojom::TransactionStatus::Submitted
+                                    : mojom::TransactionStatus::Confirmed);
+        meta.set_confirmed_time(base::Time::Now());
+        update->SetByDottedPath(
+            base::StrCat({"ethereum.", network, ".", meta.id()}),
+            meta.ToValue());
+      }
+    }
+  }
+
+  std::vector<std::string> expected_ids;
+  const base::Value::Dict* network_dict =
+      prefs_.GetDict(kBraveWalletTransactions)
+          .FindDictByDottedPath("ethereum.mainnet");
+  ASSERT_TRUE(network_dict);
+  for (const auto it : *network_dict) {
+    auto meta = tx_state_manager_->ValueToTxMeta(it.second.GetDict());
+    if (meta && meta->status() == mojom::TransactionStatus::Submitted) {
+      expected_ids.push_back(meta->id());
+    }
+  }
+  EXPECT_EQ(kPendingTxsPerNetwork, expected_ids.size());
+
+  std::vector<std::string> indexed_ids;
+  for (const auto& meta : tx_state_manager_->GetTransactionsByStatus(
+           mojom::TransactionStatus::Submitted, absl::nullopt)) {
+    indexed_ids.push_back(meta->id());
+  }
+  EXPECT_EQ(expected_ids, indexed_ids);
+  EXPECT_EQ(tx_state_manager_
+                ->GetTransactionsByStatus(mojom::TransactionStatus::Submitted,
+                                          from[0])
+                .size(),
+            kPendingTxsPerNetwork);
+}
+
 }  // namespace brave_wallet
@@ -60,5 +60,15 @@ BASE_FEATURE(kBraveWalletBitcoinFeature,
              "BraveWalletBitcoin",
              base::FEATURE_DISABLED_BY_DEFAULT);
 
+BASE_FEATURE(kBraveWalletJsonRpcBatchingFeature,
+             "BraveWalletJsonRpcBatching",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+BASE_FEATURE(kBraveWalletResponseCacheFeature,
+             "BraveWalletResponseCache",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+const base::FeatureParam<base::TimeDelta> kResponseCacheTtl{
+    &kBraveWalletResponseCacheFeature, "ttl", base::Seconds(15)};
+
 }  // namespace features
 }  // namespace brave_wallet
@@ -24,6 +24,9 @@ BASE_DECLARE_FEATURE(kBraveWalletDappsSupportFeature);
 BASE_DECLARE_FEATURE(kBraveWalletENSL2Feature);
 BASE_DECLARE_FEATURE(kBraveWalletSnsFeature);
 BASE_DECLARE_FEATURE(kBraveWalletBitcoinFeature);
+BASE_DECLARE_FEATURE(kBraveWalletJsonRpcBatchingFeature);
+BASE_DECLARE_FEATURE(kBraveWalletResponseCacheFeature);
+extern const base::FeatureParam<base::TimeDelta> kResponseCacheTtl;
 
 }  // namespace features
 }  // namespace brave_wallet
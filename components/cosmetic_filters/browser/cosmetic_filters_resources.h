@@ -38,7 +38,8 @@ class CosmeticFiltersResources final
 
   // Sends back to renderer a response about rules that has to be applied
   // for the specified selectors.
-  void HiddenClassIdSelectors(const std::string& input,
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids,
                               const std::vector<std::string>& exceptions,
                               HiddenClassIdSelectorsCallback callback) override;
 
@@ -49,6 +50,9 @@ class CosmeticFiltersResources final
                             bool aggressive_blocking,
                             UrlCosmeticResourcesCallback callback) override;
 
+  void GetResourcesCacheGenerationRegion(
+      GetResourcesCacheGenerationRegionCallback callback) override;
+
  private:
   raw_ptr<brave_shields::AdBlockService> ad_block_service_ =
       nullptr;  // Not owned
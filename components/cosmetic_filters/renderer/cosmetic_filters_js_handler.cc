@@ -17,11 +17,14 @@
 #include "base/trace_event/trace_event.h"
 #include "brave/components/brave_shields/common/features.h"
 #include "brave/components/content_settings/renderer/brave_content_settings_agent_impl.h"
+#include "brave/components/cosmetic_filters/renderer/unmatched_class_id_cache.h"
+#include "brave/components/cosmetic_filters/renderer/url_cosmetic_resources_cache.h"
 #include "brave/components/cosmetic_filters/resources/grit/cosmetic_filters_generated_map.h"
 #include "components/content_settings/renderer/content_settings_agent_impl.h"
 #include "content/public/renderer/render_frame.h"
 #include "gin/arguments.h"
 #include "gin/function_template.h"
+#include "mojo/public/cpp/bindings/callback_helpers.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "third_party/blink/public/common/browser_interface_broker_proxy.h"
 #include "third_party/blink/public/common/web_preferences/web_preferences.h"
@@ -160,6 +163,8 @@ namespace cosmetic_filters {
 // brave://tracing & brave://histograms.
 class CosmeticFilterPerfTracker {
  public:
+  ~CosmeticFilterPerfTracker() { OnPageEnd(); }
+
   int OnHandleMutationsBegin() {
     const auto event_id = MakeUniquePerfId();
     TRACE_EVENT_NESTABLE_ASYNC_BEGIN0(
@@ -187,6 +192,33 @@ class CosmeticFilterPerfTracker {
         TRACE_CATEGORY, "QuerySelectors",
         TRACE_ID_WITH_SCOPE("QuerySelectors", event_id));
   }
+
+  // Counts the class and id queries made on the current page, and how many of
+  // them were answered without an IPC.
+  void OnClassIdSelectorsQuery(bool sent_ipc) {
+    if (sent_ipc) {
+      class_id_ipc_count_++;
+    } else {
+      class_id_skipped_ipc_count_++;
+    }
+    TRACE_COUNTER2(TRACE_CATEGORY, "ClassIdSelectorsQueries", "ipc",
+                   class_id_ipc_count_, "skipped", class_id_skipped_ipc_count_);
+  }
+
+  void OnPageEnd() {
+    if (class_id_ipc_count_ == 0 && class_id_skipped_ipc_count_ == 0) {
+      return;
+    }
+    UMA_HISTOGRAM_COUNTS_1000(
+        "Brave.CosmeticFilters.HiddenClassIdSelectorsIpcsPerPage",
+        class_id_ipc_count_);
+    class_id_ipc_count_ = 0;
+    class_id_skipped_ipc_count_ = 0;
+  }
+
+ private:
+  int class_id_ipc_count_ = 0;
+  int class_id_skipped_ipc_count_ = 0;
 };
 
 CosmeticFiltersJSHandler::CosmeticFiltersJSHandler(
@@ -207,14 +239,39 @@ CosmeticFiltersJSHandler::CosmeticFiltersJSHandler(
 CosmeticFiltersJSHandler::~CosmeticFiltersJSHandler() = default;
 
 void CosmeticFiltersJSHandler::HiddenClassIdSelectors(
-    const std::string& input) {
+    std::vector<std::string> classes,
+    std::vector<std::string> ids) {
   if (!EnsureConnected())
     return;
 
+  // The unmatched classes and ids are only reported by the browser when it
+  // has a cosmetic resources cache, whose generation also validates them.
+  absl::optional<uint32_t> generation;
+  if (base::FeatureList::IsEnabled(
+          brave_shields::features::kCosmeticFilteringResourcesCache) &&
+      base::FeatureList::IsEnabled(
+          brave_shields::features::kCosmeticFilteringUnmatchedClassIdCache)) {
+    generation = UrlCosmeticResourcesCache::GetInstance()->GetGeneration();
+  }
+
+  // Leave out the classes and ids that are already known not to match.
+  if (generation &&
+      UnmatchedClassIdCache::GetInstance()->RemoveUnmatched(*generation,
+                                                            classes, ids) &&
+      classes.empty() && ids.empty()) {
+    if (perf_tracker_) {
+      perf_tracker_->OnClassIdSelectorsQuery(/*sent_ipc=*/false);
+    }
+    return;
+  }
+
+  if (perf_tracker_) {
+    perf_tracker_->OnClassIdSelectorsQuery(/*sent_ipc=*/true);
+  }
   cosmetic_filters_resources_->HiddenClassIdSelectors(
-      input, exceptions_,
+      classes, ids, exceptions_,
       base::BindOnce(&CosmeticFiltersJSHandler::OnHiddenClassIdSelectors,
-                     base::Unretained(this)));
+                     base::Unretained(this), generation));
 }
 
 bool CosmeticFiltersJSHandler::OnIsFirstParty(const std::string& url_string) {
@@ -342,6 +399,9 @@ bool CosmeticFiltersJSHandler::ProcessURL(
   resources_dict_ = absl::nullopt;
   url_ = url;
   enabled_1st_party_cf_ = false;
+  if (perf_tracker_) {
+    perf_tracker_->OnPageEnd();
+  }
 
   // Trivially, don't make exceptions for malformed URLs.
   if (!EnsureConnected() || url_.is_empty() || !url_.is_valid())
@@ -362,6 +422,43 @@ bool CosmeticFiltersJSHandler::ProcessURL(
       render_frame_->GetWebFrame()->IsCrossOriginToOutermostMainFrame() ||
       content_settings->IsFirstPartyCosmeticFilteringEnabled(url_);
 
+  // Other frames in this renderer may already have fetched the resources for
+  // this URL, in which case there's no need to ask the browser.
+  // The generation region is also used by the unmatched class and id cache.
+  auto* cache = UrlCosmeticResourcesCache::GetInstance();
+  if (base::FeatureList::IsEnabled(
+          ::brave_shields::features::kCosmeticFilteringResourcesCache) &&
+      cache->ShouldRequestGenerationRegion()) {
+    // Runs with an invalid region if the pipe disconnects first, so that the
+    // request isn't left pending forever.
+    cosmetic_filters_resources_->GetResourcesCacheGenerationRegion(
+        mojo::WrapCallbackWithDefaultInvokeIfNotRun(
+            base::BindOnce(&UrlCosmeticResourcesCache::SetGenerationRegion,
+                           base::Unretained(cache)),
+            base::ReadOnlySharedMemoryRegion()));
+  }
+
+  absl::optional<uint32_t> cache_generation;
+  std::string cache_key;
+  if (base::FeatureList::IsEnabled(
+          ::brave_shields::features::kCosmeticFilteringResourcesCache)) {
+    cache_generation = cache->GetGeneration();
+    if (cache_generation) {
+      cache_key =
+          UrlCosmeticResourcesCache::MakeKey(url_, enabled_1st_party_cf_);
+      resources_dict_ = cache->Get(cache_key);
+      UMA_HISTOGRAM_BOOLEAN(
+          "Brave.CosmeticFilters.UrlCosmeticResourcesCacheHit",
+          resources_dict_.has_value());
+      if (resources_dict_) {
+        if (callback.has_value()) {
+          std::move(callback.value()).Run();
+        }
+        return true;
+      }
+    }
+  }
+
   if (callback.has_value()) {
     SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
         "Brave.CosmeticFilters.UrlCosmeticResources");
@@ -369,7 +466,8 @@ bool CosmeticFiltersJSHandler::ProcessURL(
     cosmetic_filters_resources_->UrlCosmeticResources(
         url_.spec(), enabled_1st_party_cf_,
         base::BindOnce(&CosmeticFiltersJSHandler::OnUrlCosmeticResources,
-                       base::Unretained(this), std::move(callback.value())));
+                       base::Unretained(this), std::move(callback.value()),
+                       std::move(cache_key), cache_generation));
   } else {
     TRACE_EVENT1("brave.adblock", "UrlCosmeticResourcesSync", "url",
                  url_.spec());
@@ -380,8 +478,13 @@ bool CosmeticFiltersJSHandler::ProcessURL(
         url_.spec(), enabled_1st_party_cf_, &result);
 
     auto* dict = result.GetIfDict();
-    if (dict)
+    if (dict) {
+      if (cache_generation) {
+        UrlCosmeticResourcesCache::GetInstance()->Put(
+            cache_key, *cache_generation, *dict);
+      }
       resources_dict_ = std::move(*dict);
+    }
   }
 
   return true;
@@ -389,13 +492,20 @@ bool CosmeticFiltersJSHandler::ProcessURL(
 
 void CosmeticFiltersJSHandler::OnUrlCosmeticResources(
     base::OnceClosure callback,
+    const std::string& cache_key,
+    absl::optional<uint32_t> cache_generation,
     base::Value result) {
   if (!EnsureConnected())
     return;
 
   auto* dict = result.GetIfDict();
-  if (dict)
+  if (dict) {
+    if (cache_generation) {
+      UrlCosmeticResourcesCache::GetInstance()->Put(cache_key,
+                                                    *cache_generation, *dict);
+    }
     resources_dict_ = std::move(*dict);
+  }
 
   std::move(callback).Run();
 }
@@ -528,7 +638,12 @@ void CosmeticFiltersJSHandler::CSSRulesRoutine(
 }
 
 void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(
+    absl::optional<uint32_t> generation,
     base::Value::Dict result) {
+  if (generation) {
+    UnmatchedClassIdCache::GetInstance()->AddUnmatched(*generation, result);
+  }
+
   if (generichide_) {
     return;
   }
@@ -6,6 +6,8 @@
 #ifndef BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_COSMETIC_FILTERS_JS_HANDLER_H_
 #define BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_COSMETIC_FILTERS_JS_HANDLER_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -60,12 +62,20 @@ class CosmeticFiltersJSHandler {
   void CreateWorkerObject(v8::Isolate* isolate, v8::Local<v8::Context> context);
 
   // A function to be called from JS
-  void HiddenClassIdSelectors(const std::string& input);
+  void HiddenClassIdSelectors(std::vector<std::string> classes,
+                              std::vector<std::string> ids);
 
+  // |cache_generation| is set if the result should be stored in the renderer's
+  // cosmetic resources cache under |cache_key|.
   void OnUrlCosmeticResources(base::OnceClosure callback,
+                              const std::string& cache_key,
+                              absl::optional<uint32_t> cache_generation,
                               base::Value result);
   void CSSRulesRoutine(const base::Value::Dict& resources_dict);
-  void OnHiddenClassIdSelectors(base::Value::Dict result);
+  // |generation| is set if the unmatched classes and ids in |result| should
+  // be recorded.
+  void OnHiddenClassIdSelectors(absl::optional<uint32_t> generation,
+                                base::Value::Dict result);
   bool OnIsFirstParty(const std::string& url_string);
   int OnEventBegin(const std::string& event_name);
   void OnEventEnd(const std::string& event_name, int);
@@ -0,0 +1,85 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/cosmetic_filters/renderer/unmatched_class_id_cache.h"
+
+#include "base/containers/contains.h"
+#include "base/containers/cxx20_erase_vector.h"
+#include "base/no_destructor.h"
+
+namespace cosmetic_filters {
+
+namespace {
+
+// Pages that generate class names can produce an unbounded number of them, so
+// each set is simply cleared once it reaches this size.
+constexpr size_t kMaxEntries = 20000;
+
+size_t RemoveKnown(const std::unordered_set<std::string>& known,
+                   std::vector<std::string>& tokens) {
+  if (known.empty()) {
+    return 0;
+  }
+  return base::EraseIf(tokens, [&known](const std::string& token) {
+    return base::Contains(known, token);
+  });
+}
+
+void AddAll(const base::Value::List* tokens,
+            std::unordered_set<std::string>& known) {
+  if (!tokens) {
+    return;
+  }
+  for (const auto& token : *tokens) {
+    const std::string* token_string = token.GetIfString();
+    if (!token_string) {
+      continue;
+    }
+    if (known.size() >= kMaxEntries) {
+      known.clear();
+    }
+    known.insert(*token_string);
+  }
+}
+
+}  // namespace
+
+// static
+UnmatchedClassIdCache* UnmatchedClassIdCache::GetInstance() {
+  static base::NoDestructor<UnmatchedClassIdCache> instance;
+  return instance.get();
+}
+
+UnmatchedClassIdCache::UnmatchedClassIdCache() = default;
+
+UnmatchedClassIdCache::~UnmatchedClassIdCache() = default;
+
+size_t UnmatchedClassIdCache::RemoveUnmatched(
+    uint32_t generation,
+    std::vector<std::string>& classes,
+    std::vector<std::string>& ids) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  ResetForGeneration(generation);
+  return RemoveKnown(classes_, classes) + RemoveKnown(ids_, ids);
+}
+
+void UnmatchedClassIdCache::AddUnmatched(uint32_t generation,
+                                         const base::Value::Dict& result) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  ResetForGeneration(generation);
+  AddAll(result.FindList("unmatched_classes"), classes_);
+  AddAll(result.FindList("unmatched_ids"), ids_);
+}
+
+void UnmatchedClassIdCache::ResetForGeneration(uint32_t generation) {
+  if (generation == generation_) {
+    return;
+  }
+  generation_ = generation;
+  classes_.clear();
+  ids_.clear();
+}
+
+}  // namespace cosmetic_filters
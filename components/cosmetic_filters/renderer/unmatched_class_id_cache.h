@@ -0,0 +1,62 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_UNMATCHED_CLASS_ID_CACHE_H_
+#define BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_UNMATCHED_CLASS_ID_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "base/threading/thread_checker.h"
+#include "base/values.h"
+
+namespace cosmetic_filters {
+
+// Renderer-wide record of the classes and ids that the browser reported as
+// having no generic hide rules, so that `HiddenClassIdSelectors` is only sent
+// for those that might match. The content script already avoids querying the
+// same class or id twice on a page; this extends that across pages and frames.
+//
+// The record is only valid for the generation of the adblock engines it was
+// built from (see `UrlCosmeticResourcesCache::GetGeneration`), and is dropped
+// as soon as a different generation is seen.
+class UnmatchedClassIdCache {
+ public:
+  static UnmatchedClassIdCache* GetInstance();
+
+  // Use `GetInstance` outside of tests.
+  UnmatchedClassIdCache();
+  ~UnmatchedClassIdCache();
+
+  UnmatchedClassIdCache(const UnmatchedClassIdCache&) = delete;
+  UnmatchedClassIdCache& operator=(const UnmatchedClassIdCache&) = delete;
+
+  // Removes the entries of |classes| and |ids| that are known not to match in
+  // |generation|, returning the number of entries removed.
+  size_t RemoveUnmatched(uint32_t generation,
+                         std::vector<std::string>& classes,
+                         std::vector<std::string>& ids);
+
+  // Records the "unmatched_classes" and "unmatched_ids" of a
+  // `HiddenClassIdSelectors` result requested in |generation|.
+  void AddUnmatched(uint32_t generation, const base::Value::Dict& result);
+
+ private:
+  // Drops all entries if they were recorded in another generation.
+  void ResetForGeneration(uint32_t generation);
+
+  THREAD_CHECKER(thread_checker_);
+
+  uint32_t generation_ = 0;
+  std::unordered_set<std::string> classes_;
+  std::unordered_set<std::string> ids_;
+};
+
+}  // namespace cosmetic_filters
+
+#endif  // BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_UNMATCHED_CLASS_ID_CACHE_H_
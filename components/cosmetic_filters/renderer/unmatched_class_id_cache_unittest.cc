@@ -0,0 +1,108 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/cosmetic_filters/renderer/unmatched_class_id_cache.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cosmetic_filters {
+
+namespace {
+
+base::Value::Dict MakeResult(const std::vector<std::string>& classes,
+                             const std::vector<std::string>& ids) {
+  base::Value::List class_list;
+  for (const auto& item : classes) {
+    class_list.Append(item);
+  }
+  base::Value::List id_list;
+  for (const auto& item : ids) {
+    id_list.Append(item);
+  }
+  base::Value::Dict result;
+  result.Set("unmatched_classes", std::move(class_list));
+  result.Set("unmatched_ids", std::move(id_list));
+  return result;
+}
+
+}  // namespace
+
+TEST(UnmatchedClassIdCacheTest, RemovesUnmatched) {
+  UnmatchedClassIdCache cache;
+  cache.AddUnmatched(1, MakeResult({"content", "nav"}, {"main"}));
+
+  std::vector<std::string> classes = {"ad", "content", "nav"};
+  std::vector<std::string> ids = {"main", "promo"};
+  EXPECT_EQ(3U, cache.RemoveUnmatched(1, classes, ids));
+  EXPECT_EQ(std::vector<std::string>({"ad"}), classes);
+  EXPECT_EQ(std::vector<std::string>({"promo"}), ids);
+}
+
+TEST(UnmatchedClassIdCacheTest, KeepsClassesAndIdsApart) {
+  UnmatchedClassIdCache cache;
+  cache.AddUnmatched(1, MakeResult({"content"}, {"main"}));
+
+  std::vector<std::string> classes = {"main"};
+  std::vector<std::string> ids = {"content"};
+  EXPECT_EQ(0U, cache.RemoveUnmatched(1, classes, ids));
+  EXPECT_EQ(std::vector<std::string>({"main"}), classes);
+  EXPECT_EQ(std::vector<std::string>({"content"}), ids);
+}
+
+TEST(UnmatchedClassIdCacheTest, ResetsOnGenerationChange) {
+  UnmatchedClassIdCache cache;
+  cache.AddUnmatched(1, MakeResult({"content"}, {"main"}));
+
+  std::vector<std::string> classes = {"content"};
+  std::vector<std::string> ids = {"main"};
+  EXPECT_EQ(0U, cache.RemoveUnmatched(2, classes, ids));
+  EXPECT_EQ(1U, classes.size());
+  EXPECT_EQ(1U, ids.size());
+
+  // A late result from the old generation is dropped as soon as the new
+  // generation is seen again.
+  cache.AddUnmatched(1, MakeResult({"content"}, {}));
+  EXPECT_EQ(0U, cache.RemoveUnmatched(2, classes, ids));
+  EXPECT_EQ(1U, classes.size());
+}
+
+TEST(UnmatchedClassIdCacheTest, IgnoresMissingAndNonStringEntries) {
+  UnmatchedClassIdCache cache;
+  base::Value::Dict result;
+  base::Value::List class_list;
+  class_list.Append(1);
+  class_list.Append("content");
+  result.Set("unmatched_classes", std::move(class_list));
+  cache.AddUnmatched(1, result);
+
+  std::vector<std::string> classes = {"content", "1"};
+  std::vector<std::string> ids = {"content"};
+  EXPECT_EQ(1U, cache.RemoveUnmatched(1, classes, ids));
+  EXPECT_EQ(std::vector<std::string>({"1"}), classes);
+  EXPECT_EQ(std::vector<std::string>({"content"}), ids);
+}
+
+TEST(UnmatchedClassIdCacheTest, ClearsWhenFull) {
+  UnmatchedClassIdCache cache;
+  std::vector<std::string> many_classes;
+  for (int i = 0; i < 20000; ++i) {
+    many_classes.push_back("class" + base::NumberToString(i));
+  }
+  cache.AddUnmatched(1, MakeResult(many_classes, {}));
+  cache.AddUnmatched(1, MakeResult({"content"}, {}));
+
+  std::vector<std::string> classes = {"class0", "content"};
+  std::vector<std::string> ids;
+  EXPECT_EQ(1U, cache.RemoveUnmatched(1, classes, ids));
+  EXPECT_EQ(std::vector<std::string>({"class0"}), classes);
+}
+
+}  // namespace cosmetic_filters
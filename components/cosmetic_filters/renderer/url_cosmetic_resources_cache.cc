@@ -0,0 +1,119 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/cosmetic_filters/renderer/url_cosmetic_resources_cache.h"
+
+#include <atomic>
+#include <utility>
+
+#include "base/strings/strcat.h"
+#include "url/gurl.h"
+
+namespace cosmetic_filters {
+
+namespace {
+
+// Cached results can include scriptlets and many selectors, so only the most
+// recently used sites are kept.
+constexpr size_t kMaxEntries = 32;
+
+}  // namespace
+
+UrlCosmeticResourcesCache::Entry::Entry(uint32_t generation,
+                                        base::Value::Dict resources)
+    : generation(generation), resources(std::move(resources)) {}
+
+UrlCosmeticResourcesCache::Entry::Entry(Entry&&) = default;
+
+UrlCosmeticResourcesCache::Entry& UrlCosmeticResourcesCache::Entry::operator=(
+    Entry&&) = default;
+
+UrlCosmeticResourcesCache::Entry::~Entry() = default;
+
+// static
+UrlCosmeticResourcesCache* UrlCosmeticResourcesCache::GetInstance() {
+  static base::NoDestructor<UrlCosmeticResourcesCache> instance;
+  return instance.get();
+}
+
+UrlCosmeticResourcesCache::UrlCosmeticResourcesCache()
+    : entries_(kMaxEntries) {}
+
+UrlCosmeticResourcesCache::~UrlCosmeticResourcesCache() = default;
+
+// static
+std::string UrlCosmeticResourcesCache::MakeKey(const GURL& url,
+                                               bool aggressive_blocking) {
+  return base::StrCat(
+      {aggressive_blocking ? "1" : "0", "|", url.GetWithoutRef().spec()});
+}
+
+bool UrlCosmeticResourcesCache::ShouldRequestGenerationRegion() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (generation_region_requested_) {
+    return false;
+  }
+  generation_region_requested_ = true;
+  return true;
+}
+
+void UrlCosmeticResourcesCache::SetGenerationRegion(
+    base::ReadOnlySharedMemoryRegion region) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  base::ReadOnlySharedMemoryMapping mapping;
+  if (region.IsValid()) {
+    mapping = region.Map();
+  }
+  if (!mapping.IsValid() || mapping.size() < sizeof(std::atomic<uint32_t>)) {
+    // Let a later frame ask again.
+    generation_region_requested_ = false;
+    return;
+  }
+  generation_mapping_ = std::move(mapping);
+}
+
+absl::optional<uint32_t> UrlCosmeticResourcesCache::GetGeneration() const {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (!generation_mapping_.IsValid()) {
+    return absl::nullopt;
+  }
+
+  return static_cast<const std::atomic<uint32_t>*>(
+             generation_mapping_.memory())
+      ->load(std::memory_order_acquire);
+}
+
+absl::optional<base::Value::Dict> UrlCosmeticResourcesCache::Get(
+    const std::string& key) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  const absl::optional<uint32_t> generation = GetGeneration();
+  if (!generation) {
+    return absl::nullopt;
+  }
+
+  auto it = entries_.Get(key);
+  if (it == entries_.end()) {
+    return absl::nullopt;
+  }
+  if (it->second.generation != *generation) {
+    entries_.Erase(it);
+    return absl::nullopt;
+  }
+
+  return it->second.resources.Clone();
+}
+
+void UrlCosmeticResourcesCache::Put(const std::string& key,
+                                    uint32_t generation,
+                                    const base::Value::Dict& resources) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (GetGeneration() != generation) {
+    return;
+  }
+
+  entries_.Put(key, Entry(generation, resources.Clone()));
+}
+
+}  // namespace cosmetic_filters
@@ -0,0 +1,88 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_URL_COSMETIC_RESOURCES_CACHE_H_
+#define BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_URL_COSMETIC_RESOURCES_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/containers/lru_cache.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/no_destructor.h"
+#include "base/threading/thread_checker.h"
+#include "base/values.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+class GURL;
+
+namespace cosmetic_filters {
+
+// Renderer-wide cache of `UrlCosmeticResources` results, shared by the
+// cosmetic filters of every frame in the process so that subframes and repeat
+// visits don't need to ask the browser again.
+//
+// Entries are tagged with the browser's cache generation at the time they were
+// requested, read from a shared memory region that the browser bumps whenever
+// the adblock engines change. An entry is only used while the generation is
+// unchanged. Until the region has been received, nothing is cached.
+class UrlCosmeticResourcesCache {
+ public:
+  static UrlCosmeticResourcesCache* GetInstance();
+
+  UrlCosmeticResourcesCache(const UrlCosmeticResourcesCache&) = delete;
+  UrlCosmeticResourcesCache& operator=(const UrlCosmeticResourcesCache&) =
+      delete;
+
+  // Matches `AdBlockCosmeticResourcesCache::MakeKey` in the browser. Keys
+  // are per URL rather than per host because `$generichide` exceptions may
+  // match only some paths of a site.
+  static std::string MakeKey(const GURL& url, bool aggressive_blocking);
+
+  // Returns true if the generation region should be requested from the
+  // browser, which is the case unless a request is in flight or has succeeded.
+  bool ShouldRequestGenerationRegion();
+  // An invalid |region| ends the request without enabling caching, so that
+  // the region is requested again.
+  void SetGenerationRegion(base::ReadOnlySharedMemoryRegion region);
+
+  // Returns the current generation, or absl::nullopt if caching is not
+  // available.
+  absl::optional<uint32_t> GetGeneration() const;
+
+  absl::optional<base::Value::Dict> Get(const std::string& key);
+  // Stores |resources| unless the generation changed since |generation|.
+  void Put(const std::string& key,
+           uint32_t generation,
+           const base::Value::Dict& resources);
+
+ private:
+  friend class base::NoDestructor<UrlCosmeticResourcesCache>;
+
+  struct Entry {
+    Entry(uint32_t generation, base::Value::Dict resources);
+    Entry(Entry&&);
+    Entry& operator=(Entry&&);
+    ~Entry();
+
+    uint32_t generation;
+    base::Value::Dict resources;
+  };
+
+  UrlCosmeticResourcesCache();
+  ~UrlCosmeticResourcesCache();
+
+  THREAD_CHECKER(thread_checker_);
+
+  bool generation_region_requested_ = false;
+  base::ReadOnlySharedMemoryMapping generation_mapping_;
+
+  base::HashingLRUCache<std::string, Entry> entries_;
+};
+
+}  // namespace cosmetic_filters
+
+#endif  // BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_URL_COSMETIC_RESOURCES_CACHE_H_
@@ -173,10 +173,7 @@ const fetchNewClassIdRules = () => {
   }
   // Callback to c++ renderer process
   // @ts-expect-error
-  cf_worker.hiddenClassIdSelectors(
-      JSON.stringify({
-        classes: notYetQueriedClasses, ids: notYetQueriedIds
-      }))
+  cf_worker.hiddenClassIdSelectors(notYetQueriedClasses, notYetQueriedIds)
   notYetQueriedClasses = []
   notYetQueriedIds = []
 }
@@ -0,0 +1,387 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/de_amp/browser/amp_detector.h"
+
+#include "base/check.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+
+namespace de_amp {
+
+namespace {
+
+// Names of interest are all short, so longer ones are truncated.
+constexpr size_t kMaxNameLength = 16;
+// Values longer than this are ignored, which for a canonical link means that
+// it is not used.
+constexpr size_t kMaxAttributeValueLength = 8192;
+
+// https://amp.dev/documentation/guides-and-tutorials/learn/spec/amphtml/?format=websites#ampd
+constexpr char kAmpAttribute[] = "amp";
+constexpr char kAmpEmojiAttribute[] = "\xE2\x9A\xA1";  // ⚡
+
+bool IsHTMLWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+}
+
+bool IsRawTextTag(const std::string& tag_name) {
+  return tag_name == "script" || tag_name == "style" || tag_name == "title";
+}
+
+}  // namespace
+
+AmpDetector::AmpDetector() = default;
+
+AmpDetector::~AmpDetector() = default;
+
+AmpDetector::Result AmpDetector::Write(base::StringPiece chunk) {
+  size_t i = 0;
+  while (i < chunk.size() && result_ == Result::kNeedMoreData) {
+    // Text between tags is skipped in bulk.
+    if (state_ == State::kData) {
+      const size_t tag_start = chunk.find('<', i);
+      if (tag_start == base::StringPiece::npos) {
+        bytes_scanned_ += chunk.size() - i;
+        break;
+      }
+      bytes_scanned_ += tag_start - i;
+      i = tag_start;
+    }
+    Consume(chunk[i]);
+    ++i;
+    ++bytes_scanned_;
+  }
+  return result_;
+}
+
+// Follows https://html.spec.whatwg.org/multipage/parsing.html#tokenization
+// loosely, without character references, DOCTYPEs or error recovery beyond
+// what is needed to not mistake text for tags.
+void AmpDetector::Consume(char c) {
+  switch (state_) {
+    case State::kData:
+      if (c == '<') {
+        state_ = State::kTagOpen;
+      }
+      return;
+    case State::kTagOpen:
+      if (c == '!') {
+        dashes_ = 0;
+        state_ = State::kMarkupDeclarationOpen;
+      } else if (c == '/') {
+        state_ = State::kEndTagOpen;
+      } else if (c == '?') {
+        state_ = State::kBogusComment;
+      } else if (base::IsAsciiAlpha(c)) {
+        tag_name_.assign(1, base::ToLowerASCII(c));
+        is_end_tag_ = false;
+        state_ = State::kTagName;
+      } else if (c != '<') {
+        state_ = State::kData;
+      }
+      return;
+    case State::kMarkupDeclarationOpen:
+      if (c == '-') {
+        if (++dashes_ == 2) {
+          dashes_ = 0;
+          state_ = State::kComment;
+        }
+      } else {
+        state_ = c == '>' ? State::kData : State::kBogusComment;
+      }
+      return;
+    case State::kComment:
+      if (c == '-') {
+        dashes_++;
+      } else if (c == '>' && dashes_ >= 2) {
+        state_ = State::kData;
+      } else {
+        dashes_ = 0;
+      }
+      return;
+    case State::kBogusComment:
+      if (c == '>') {
+        state_ = State::kData;
+      }
+      return;
+    case State::kEndTagOpen:
+      if (base::IsAsciiAlpha(c)) {
+        tag_name_.assign(1, base::ToLowerASCII(c));
+        is_end_tag_ = true;
+        state_ = State::kTagName;
+      } else {
+        state_ = c == '>' ? State::kData : State::kBogusComment;
+      }
+      return;
+    case State::kTagName:
+      if (IsHTMLWhitespace(c)) {
+        OnTagNameEnd();
+        state_ = State::kBeforeAttributeName;
+      } else if (c == '/') {
+        OnTagNameEnd();
+        state_ = State::kSelfClosingStartTag;
+      } else if (c == '>') {
+        OnTagNameEnd();
+        OnTagEnd();
+      } else if (tag_name_.size() < kMaxNameLength) {
+        tag_name_ += base::ToLowerASCII(c);
+      }
+      return;
+    case State::kBeforeAttributeName:
+      if (IsHTMLWhitespace(c)) {
+        return;
+      }
+      if (c == '/') {
+        state_ = State::kSelfClosingStartTag;
+      } else if (c == '>') {
+        OnTagEnd();
+      } else {
+        StartAttribute();
+        AppendToAttributeName(c);
+        state_ = State::kAttributeName;
+      }
+      return;
+    case State::kAttributeName:
+      if (IsHTMLWhitespace(c)) {
+        state_ = State::kAfterAttributeName;
+      } else if (c == '/') {
+        OnAttributeEnd();
+        state_ = State::kSelfClosingStartTag;
+      } else if (c == '=') {
+        state_ = State::kBeforeAttributeValue;
+      } else if (c == '>') {
+        OnAttributeEnd();
+        OnTagEnd();
+      } else {
+        AppendToAttributeName(c);
+      }
+      return;
+    case State::kAfterAttributeName:
+      if (IsHTMLWhitespace(c)) {
+        return;
+      }
+      if (c == '/') {
+        OnAttributeEnd();
+        state_ = State::kSelfClosingStartTag;
+      } else if (c == '=') {
+        state_ = State::kBeforeAttributeValue;
+      } else if (c == '>') {
+        OnAttributeEnd();
+        OnTagEnd();
+      } else {
+        OnAttributeEnd();
+        StartAttribute();
+        AppendToAttributeName(c);
+        state_ = State::kAttributeName;
+      }
+      return;
+    case State::kBeforeAttributeValue:
+      if (IsHTMLWhitespace(c)) {
+        return;
+      }
+      attribute_has_value_ = true;
+      if (c == '"') {
+        state_ = State::kAttributeValueDoubleQuoted;
+      } else if (c == '\'') {
+        state_ = State::kAttributeValueSingleQuoted;
+      } else if (c == '>') {
+        OnAttributeEnd();
+        OnTagEnd();
+      } else {
+        state_ = State::kAttributeValueUnquoted;
+        Consume(c);
+      }
+      return;
+    case State::kAttributeValueDoubleQuoted:
+      if (c == '"') {
+        OnAttributeEnd();
+        state_ = State::kAfterAttributeValueQuoted;
+      } else {
+        AppendToAttributeValue(c);
+      }
+      return;
+    case State::kAttributeValueSingleQuoted:
+      if (c == '\'') {
+        OnAttributeEnd();
+        state_ = State::kAfterAttributeValueQuoted;
+      } else {
+        AppendToAttributeValue(c);
+      }
+      return;
+    case State::kAttributeValueUnquoted:
+      if (IsHTMLWhitespace(c)) {
+        OnAttributeEnd();
+        state_ = State::kBeforeAttributeName;
+      } else if (c == '>') {
+        // Unlike the spec, treat a trailing slash as closing the tag, as in
+        // <link rel=canonical href=https://example.com/>.
+        if (base::EndsWith(attribute_value_, "/")) {
+          attribute_value_.pop_back();
+        }
+        OnAttributeEnd();
+        OnTagEnd();
+      } else {
+        AppendToAttributeValue(c);
+      }
+      return;
+    case State::kAfterAttributeValueQuoted:
+      if (IsHTMLWhitespace(c)) {
+        state_ = State::kBeforeAttributeName;
+      } else if (c == '/') {
+        state_ = State::kSelfClosingStartTag;
+      } else if (c == '>') {
+        OnTagEnd();
+      } else {
+        state_ = State::kBeforeAttributeName;
+        Consume(c);
+      }
+      return;
+    case State::kSelfClosingStartTag:
+      if (c == '>') {
+        OnTagEnd();
+      } else {
+        state_ = State::kBeforeAttributeName;
+        Consume(c);
+      }
+      return;
+    case State::kRawText: {
+      // Look for "</" followed by the name of the tag that started the text.
+      const size_t end_tag_length = raw_text_tag_name_.size() + 2;
+      char expected = '<';
+      if (raw_text_end_tag_matched_ == 1) {
+        expected = '/';
+      } else if (raw_text_end_tag_matched_ > 1) {
+        expected = raw_text_tag_name_[raw_text_end_tag_matched_ - 2];
+      }
+      if (base::ToLowerASCII(c) == expected) {
+        if (++raw_text_end_tag_matched_ == end_tag_length) {
+          tag_name_ = raw_text_tag_name_;
+          is_end_tag_ = true;
+          state_ = State::kTagName;
+        }
+      } else {
+        raw_text_end_tag_matched_ = c == '<' ? 1 : 0;
+      }
+      return;
+    }
+  }
+}
+
+void AmpDetector::OnTagNameEnd() {
+  tag_ = Tag::kOther;
+  if (is_end_tag_) {
+    return;
+  }
+
+  if (!seen_html_tag_) {
+    if (tag_name_ == "html") {
+      tag_ = Tag::kHtml;
+    } else if (tag_name_ == "head" || tag_name_ == "body") {
+      // The <html> tag was omitted, so the page can't be AMP.
+      result_ = Result::kNotAmp;
+    }
+    return;
+  }
+
+  // Past this point the page is known to be AMP, as otherwise a result would
+  // have been reached at the end of the <html> tag.
+  DCHECK(is_amp_);
+  if (tag_name_ == "body") {
+    result_ = Result::kNoCanonicalUrl;
+  } else if (tag_name_ == "link") {
+    tag_ = Tag::kLink;
+    link_is_canonical_ = false;
+    link_has_href_ = false;
+    link_href_.clear();
+  }
+}
+
+void AmpDetector::StartAttribute() {
+  attribute_name_.clear();
+  attribute_value_.clear();
+  attribute_has_value_ = false;
+  attribute_value_truncated_ = false;
+}
+
+void AmpDetector::AppendToAttributeName(char c) {
+  if (tag_ != Tag::kOther && attribute_name_.size() < kMaxNameLength) {
+    attribute_name_ += base::ToLowerASCII(c);
+  }
+}
+
+void AmpDetector::AppendToAttributeValue(char c) {
+  if (tag_ == Tag::kOther) {
+    return;
+  }
+  if (attribute_value_.size() < kMaxAttributeValueLength) {
+    attribute_value_ += c;
+  } else {
+    attribute_value_truncated_ = true;
+  }
+}
+
+void AmpDetector::OnAttributeEnd() {
+  if (tag_ == Tag::kOther || attribute_value_truncated_) {
+    return;
+  }
+
+  const base::StringPiece value =
+      base::TrimWhitespaceASCII(attribute_value_, base::TRIM_ALL);
+  if (tag_ == Tag::kHtml) {
+    if ((attribute_name_ == kAmpAttribute ||
+         attribute_name_ == kAmpEmojiAttribute) &&
+        (value.empty() || base::EqualsCaseInsensitiveASCII(value, "true"))) {
+      is_amp_ = true;
+    }
+    return;
+  }
+
+  DCHECK_EQ(Tag::kLink, tag_);
+  if (attribute_name_ == "rel") {
+    for (const auto& rel :
+         base::SplitStringPiece(value, base::kWhitespaceASCII,
+                                base::TRIM_WHITESPACE,
+                                base::SPLIT_WANT_NONEMPTY)) {
+      if (base::EqualsCaseInsensitiveASCII(rel, "canonical")) {
+        link_is_canonical_ = true;
+      }
+    }
+  } else if (attribute_name_ == "href" && attribute_has_value_) {
+    link_has_href_ = true;
+    link_href_.assign(value.data(), value.size());
+  }
+}
+
+void AmpDetector::OnTagEnd() {
+  state_ = State::kData;
+  if (is_end_tag_) {
+    return;
+  }
+
+  switch (tag_) {
+    case Tag::kHtml:
+      seen_html_tag_ = true;
+      if (!is_amp_) {
+        result_ = Result::kNotAmp;
+      }
+      return;
+    case Tag::kLink:
+      if (link_is_canonical_ && link_has_href_) {
+        canonical_url_ = link_href_;
+        result_ = Result::kCanonicalUrlFound;
+      }
+      return;
+    case Tag::kOther:
+      if (IsRawTextTag(tag_name_)) {
+        raw_text_tag_name_ = tag_name_;
+        raw_text_end_tag_matched_ = 0;
+        state_ = State::kRawText;
+      }
+      return;
+  }
+}
+
+}  // namespace de_amp
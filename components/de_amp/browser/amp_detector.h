@@ -0,0 +1,120 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_DE_AMP_BROWSER_AMP_DETECTOR_H_
+#define BRAVE_COMPONENTS_DE_AMP_BROWSER_AMP_DETECTOR_H_
+
+#include <string>
+
+#include "base/strings/string_piece.h"
+
+namespace de_amp {
+
+// Incrementally scans the start of an HTML document for the AMP attribute on
+// the <html> tag and then for the canonical <link> tag. Each call to Write()
+// resumes where the previous one stopped, so the body is only scanned once
+// however it is split into chunks, and nothing is copied except the names and
+// values of the few attributes that matter.
+//
+// Only as much of the HTML tokenizer is implemented as is needed to find tags
+// and attributes: comments, <!...> declarations, end tags and the contents of
+// <script> and <style> are skipped.
+class AmpDetector {
+ public:
+  enum class Result {
+    // Nothing has been decided yet.
+    kNeedMoreData,
+    // The <html> tag has no AMP attribute, or wasn't found before <head> or
+    // <body>.
+    kNotAmp,
+    // The page is AMP and canonical_url() is set.
+    kCanonicalUrlFound,
+    // The page is AMP, but <body> started before a canonical link was found.
+    kNoCanonicalUrl,
+  };
+
+  AmpDetector();
+  ~AmpDetector();
+
+  AmpDetector(const AmpDetector&) = delete;
+  AmpDetector& operator=(const AmpDetector&) = delete;
+
+  // Scans the next chunk of the body. Once a result other than kNeedMoreData
+  // has been returned, further chunks are ignored.
+  Result Write(base::StringPiece chunk);
+
+  Result result() const { return result_; }
+  // Whether the <html> tag has been seen and has the AMP attribute.
+  bool is_amp() const { return seen_html_tag_ && is_amp_; }
+  // Number of bytes consumed before reaching the current result.
+  size_t bytes_scanned() const { return bytes_scanned_; }
+  const std::string& canonical_url() const { return canonical_url_; }
+
+ private:
+  enum class State {
+    kData,
+    kTagOpen,
+    kMarkupDeclarationOpen,
+    kComment,
+    kBogusComment,
+    kEndTagOpen,
+    kTagName,
+    kBeforeAttributeName,
+    kAttributeName,
+    kAfterAttributeName,
+    kBeforeAttributeValue,
+    kAttributeValueDoubleQuoted,
+    kAttributeValueSingleQuoted,
+    kAttributeValueUnquoted,
+    kAfterAttributeValueQuoted,
+    kSelfClosingStartTag,
+    kRawText,
+  };
+
+  enum class Tag { kOther, kHtml, kLink };
+
+  void Consume(char c);
+  void OnTagNameEnd();
+  void OnAttributeEnd();
+  void OnTagEnd();
+  void StartAttribute();
+  void AppendToAttributeName(char c);
+  void AppendToAttributeValue(char c);
+
+  State state_ = State::kData;
+  Result result_ = Result::kNeedMoreData;
+  size_t bytes_scanned_ = 0;
+
+  bool seen_html_tag_ = false;
+  bool is_amp_ = false;
+
+  // The current tag, lowercased. Long names are truncated, as only short ones
+  // are of interest.
+  std::string tag_name_;
+  Tag tag_ = Tag::kOther;
+  bool is_end_tag_ = false;
+
+  // The current attribute, with the name lowercased.
+  std::string attribute_name_;
+  std::string attribute_value_;
+  bool attribute_has_value_ = false;
+  bool attribute_value_truncated_ = false;
+
+  // State of the current <link> tag.
+  bool link_is_canonical_ = false;
+  bool link_has_href_ = false;
+  std::string link_href_;
+
+  // Used to find the end of comments and of <script> and <style> contents.
+  size_t dashes_ = 0;
+  std::string raw_text_tag_name_;
+  size_t raw_text_end_tag_matched_ = 0;
+
+  std::string canonical_url_;
+};
+
+}  // namespace de_amp
+
+#endif  // BRAVE_COMPONENTS_DE_AMP_BROWSER_AMP_DETECTOR_H_
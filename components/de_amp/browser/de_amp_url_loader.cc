@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/body_sniffer/body_sniffer_url_loader.h"
 #include "brave/components/de_amp/browser/de_amp_throttle.h"
 #include "brave/components/de_amp/browser/de_amp_util.h"
@@ -68,23 +69,36 @@ void DeAmpURLLoader::OnBodyReadable(MojoResult) {
     ForwardBodyToClient();
     return;
   }
-  if (!CheckBufferedBody(kMaxBytesToCheck - buffered_body_.size())) {
+  base::StringPiece new_data;
+  if (!CheckBufferedBody(kMaxBytesToCheck - buffered_body_.size(),
+                         &new_data)) {
     return;
   }
-  if (MaybeRedirectToCanonicalLink()) {
-    // Only abort if we know we're successfully going to the canonical URL
-    Abort();
-    return;
-  }
-  // If we were not redirected and we didn't find AMP, or
-  // if we did find AMP previously and we've already read more bytes than
-  // max, complete the load.
-  if (!found_amp_ || read_bytes_ >= kMaxBytesToCheck) {
-    found_amp_ = false;  // reset
-    CompleteLoading(std::move(buffered_body_));
-    return;
+
+  // Only the newly read bytes are scanned, the detector keeps track of
+  // where it was in the document.
+  switch (amp_detector_.Write(new_data)) {
+    case AmpDetector::Result::kCanonicalUrlFound:
+      if (MaybeRedirectToCanonicalLink()) {
+        // Only abort if we know we're successfully going to the canonical URL
+        Abort();
+        return;
+      }
+      break;
+    case AmpDetector::Result::kNotAmp:
+    case AmpDetector::Result::kNoCanonicalUrl:
+      break;
+    case AmpDetector::Result::kNeedMoreData:
+      if (read_bytes_ < kMaxBytesToCheck) {
+        body_consumer_watcher_.ArmOrNotify();
+        return;
+      }
+      break;
   }
-  body_consumer_watcher_.ArmOrNotify();
+
+  // Release what was read so far and forward the rest of the body as it
+  // arrives.
+  CompleteLoading(std::move(buffered_body_));
 }
 
 bool DeAmpURLLoader::MaybeRedirectToCanonicalLink() {
@@ -92,42 +106,26 @@ bool DeAmpURLLoader::MaybeRedirectToCanonicalLink() {
     return false;
   }
 
-  // If we are not already on an AMP page, check if this chunk has the AMP HTML
-  if (!found_amp_ && !CheckIfAmpPage(buffered_body_)) {
+  const GURL canonical_url(amp_detector_.canonical_url());
+  // Validate the found canonical AMP URL
+  if (!VerifyCanonicalAmpUrl(canonical_url, response_url_)) {
+    VLOG(2) << __func__ << " canonical link verification failed "
+            << canonical_url;
     return false;
   }
 
-  found_amp_ = true;  // If we get to this point, we know we have an AMP page
-
-  auto canonical_link = FindCanonicalAmpUrl(buffered_body_);
-  if (!canonical_link.has_value()) {
-    VLOG(2) << __func__ << canonical_link.error();
+  // Attempt to go to the canonical URL
+  VLOG(2) << __func__ << " de-amping and loading " << canonical_url;
+  if (!de_amp_throttle_->OpenCanonicalURL(canonical_url, response_url_)) {
+    VLOG(2) << __func__ << " failed to open canonical url: " << canonical_url;
     return false;
   }
-
-  bool redirected = false;
-  const GURL canonical_url(canonical_link.value());
-  // Validate the found canonical AMP URL
-  if (VerifyCanonicalAmpUrl(canonical_url, response_url_)) {
-    // Attempt to go to the canonical URL
-    VLOG(2) << __func__ << " de-amping and loading " << canonical_url;
-    if (de_amp_throttle_->OpenCanonicalURL(canonical_url, response_url_)) {
-      redirected = true;
-    } else {
-      VLOG(2) << __func__ << " failed to open canonical url: " << canonical_url;
-    }
-  } else {
-    VLOG(2) << __func__ << " canonical link verification failed "
-            << canonical_url;
-  }
-  // At this point we've either redirected, or we should stop trying
-  found_amp_ = false;
-  return redirected;
+  return true;
 }
 
 void DeAmpURLLoader::OnBodyWritable(MojoResult r) {
   DCHECK_EQ(State::kSending, state_);
-  if (bytes_remaining_in_buffer_ > 0) {
+  if (buffered_body_.HasUnsentData()) {
     SendBufferedBodyToClient();
   } else {
     ForwardBodyToClient();
@@ -136,7 +134,7 @@ void DeAmpURLLoader::OnBodyWritable(MojoResult r) {
 
 // No buffered data to be sent, read and forward data to producer
 void DeAmpURLLoader::ForwardBodyToClient() {
-  DCHECK_EQ(0u, bytes_remaining_in_buffer_);
+  DCHECK(!buffered_body_.HasUnsentData());
   // Send the body from the consumer to the producer.
   const void* buffer;
   uint32_t buffer_size = 0;
@@ -16,11 +16,11 @@ namespace de_amp {
 // Check feature flag and user pref
 bool IsDeAmpEnabled(PrefService* prefs);
 
-// Run a regex against a string to check if AMP page
+// Check if the <html> tag of |body| marks an AMP page. See AmpDetector for
+// scanning a body incrementally.
 bool CheckIfAmpPage(const std::string& body);
 
 // Find canonical link in body or return error
-// Caller makes sure that body is AMP page
 base::expected<std::string, std::string> FindCanonicalAmpUrl(
     const std::string& body);
 
@@ -0,0 +1,214 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/de_amp/browser/amp_detector.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace de_amp {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "AmpDetector.";
+constexpr char kMetricTimePerPage[] = "time_per_page";
+// Bytes handed to the scanners per page, counting a byte again each time it
+// is rescanned.
+constexpr char kMetricBytesScanned[] = "bytes_scanned";
+
+// Match DeAmpURLLoader.
+constexpr size_t kReadBufferSize = 65536;
+constexpr size_t kMaxBytesToCheck = kReadBufferSize * 3;
+
+// Repeats each page so that short runs are still measurable.
+constexpr int kIterations = 20;
+
+constexpr char kCanonicalUrl[] =
+    "https://news.example/2023/05/example-story.html";
+
+// The expressions DeAmpURLLoader used before AmpDetector, kept as the
+// baseline.
+constexpr char kGetHtmlTagPattern[] = "(<\\s*?html\\s.*?>)";
+constexpr char kDetectAmpPattern[] =
+    "(?:<.*?\\s.*?(amp|⚡|⚡=\"(?:true|\\s*)\"|⚡=\'(?:true|\\s*)\'|amp=\"(?:true|"
+    "\\s*)\"|amp='(?:true|\\s*)')(?:\\s.*?>|>|/>))";
+constexpr char kFindCanonicalLinkTagPattern[] =
+    "(<\\s*?link\\s[^>]*?rel=(?:\"|')?canonical(?:\"|')?(?:\\s[^>]*?>|>|/>))";
+constexpr char kFindCanonicalHrefInTagPattern[] =
+    "href=(?:\"|')?(.*?)(?:\"|')?(?:\\s[^>]*?>|>|/>)";
+
+class RegexAmpScanner {
+ public:
+  RegexAmpScanner()
+      : get_html_tag_(kGetHtmlTagPattern, MakeOptions()),
+        detect_amp_(kDetectAmpPattern, MakeOptions()),
+        find_canonical_link_tag_(kFindCanonicalLinkTagPattern, MakeOptions()),
+        find_canonical_href_in_tag_(kFindCanonicalHrefInTagPattern,
+                                    MakeOptions()) {}
+
+  bool CheckIfAmpPage(const std::string& body) const {
+    std::string html_tag;
+    return RE2::PartialMatch(body, get_html_tag_, &html_tag) &&
+           RE2::PartialMatch(html_tag, detect_amp_);
+  }
+
+  bool FindCanonicalAmpUrl(const std::string& body,
+                           std::string* canonical_url) const {
+    std::string link_tag;
+    return RE2::PartialMatch(body, find_canonical_link_tag_, &link_tag) &&
+           RE2::PartialMatch(link_tag, find_canonical_href_in_tag_,
+                             canonical_url);
+  }
+
+ private:
+  static RE2::Options MakeOptions() {
+    RE2::Options options;
+    options.set_case_sensitive(false);
+    options.set_dot_nl(true);
+    return options;
+  }
+
+  const RE2 get_html_tag_;
+  const RE2 detect_amp_;
+  const RE2 find_canonical_link_tag_;
+  const RE2 find_canonical_href_in_tag_;
+};
+
+// Scans |page| the way DeAmpURLLoader used to: the buffered body grows by a
+// read at a time up to kMaxBytesToCheck, and the expressions are rerun over
+// all of it after each read. Returns the number of bytes handed to them.
+size_t ScanWithRegexes(const RegexAmpScanner& scanner,
+                       base::StringPiece page,
+                       std::string* canonical_url) {
+  std::string buffered_body;
+  size_t bytes_scanned = 0;
+  bool found_amp = false;
+  while (buffered_body.size() < std::min(page.size(), kMaxBytesToCheck)) {
+    buffered_body.append(
+        page.substr(buffered_body.size(),
+                    std::min(kReadBufferSize,
+                             kMaxBytesToCheck - buffered_body.size())));
+    if (!found_amp) {
+      bytes_scanned += buffered_body.size();
+      if (!scanner.CheckIfAmpPage(buffered_body)) {
+        break;
+      }
+    }
+    found_amp = true;
+    bytes_scanned += buffered_body.size();
+    if (scanner.FindCanonicalAmpUrl(buffered_body, canonical_url)) {
+      break;
+    }
+  }
+  return bytes_scanned;
+}
+
+// Scans |page| the way DeAmpURLLoader does now. Returns the number of bytes
+// consumed before a decision was reached.
+size_t ScanWithDetector(base::StringPiece page, std::string* canonical_url) {
+  AmpDetector detector;
+  for (size_t offset = 0; offset < page.size(); offset += kReadBufferSize) {
+    if (detector.Write(page.substr(offset, kReadBufferSize)) !=
+        AmpDetector::Result::kNeedMoreData) {
+      break;
+    }
+  }
+  *canonical_url = detector.canonical_url();
+  return detector.bytes_scanned();
+}
+
+}  // namespace
+
+// Compares the incremental AmpDetector against rescanning the growing body
+// with the old expressions, over the AMP fixture and real non-AMP news pages.
+class AmpDetectorPerfTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    base::FilePath test_data_dir;
+    ASSERT_TRUE(base::PathService::Get(base::DIR_SOURCE_ROOT, &test_data_dir));
+    test_data_dir = test_data_dir.AppendASCII("brave/test/data");
+
+    ASSERT_TRUE(base::ReadFileToString(
+        test_data_dir.AppendASCII("de_amp/amp_article.html"), &amp_page_));
+
+    base::FileEnumerator enumerator(
+        test_data_dir.AppendASCII("speedreader/rewriter/pages/news_pages"),
+        false, base::FileEnumerator::DIRECTORIES);
+    for (base::FilePath dir = enumerator.Next(); !dir.empty();
+         dir = enumerator.Next()) {
+      std::string page;
+      ASSERT_TRUE(
+          base::ReadFileToString(dir.AppendASCII("original.html"), &page));
+      non_amp_pages_.push_back(std::move(page));
+    }
+    ASSERT_FALSE(non_amp_pages_.empty());
+  }
+
+ protected:
+  // Runs |scan| over |pages| and reports the average time and bytes scanned
+  // per page. |scan| returns the bytes scanned and sets the canonical URL,
+  // the last of which is returned.
+  template <typename ScanCallback>
+  std::string Run(const std::string& story,
+                  const std::vector<base::StringPiece>& pages,
+                  ScanCallback scan) {
+    size_t bytes_scanned = 0;
+    std::string canonical_url;
+    const base::ElapsedTimer timer;
+    for (int i = 0; i < kIterations; ++i) {
+      for (const base::StringPiece page : pages) {
+        canonical_url.clear();
+        bytes_scanned += scan(page, &canonical_url);
+      }
+    }
+    const base::TimeDelta elapsed = timer.Elapsed();
+    const size_t runs = kIterations * pages.size();
+
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+    reporter.RegisterImportantMetric(kMetricTimePerPage, "us");
+    reporter.RegisterImportantMetric(kMetricBytesScanned, "bytes");
+    reporter.AddResult(kMetricTimePerPage, elapsed / runs);
+    reporter.AddResult(kMetricBytesScanned, bytes_scanned / runs);
+    return canonical_url;
+  }
+
+  std::vector<base::StringPiece> non_amp_pages() const {
+    return {non_amp_pages_.begin(), non_amp_pages_.end()};
+  }
+
+  std::string amp_page_;
+  std::vector<std::string> non_amp_pages_;
+};
+
+TEST_F(AmpDetectorPerfTest, Detector) {
+  EXPECT_EQ(kCanonicalUrl,
+            Run("detector_amp_page", {amp_page_}, &ScanWithDetector));
+  Run("detector_non_amp_pages", non_amp_pages(), &ScanWithDetector);
+}
+
+TEST_F(AmpDetectorPerfTest, Regexes) {
+  const RegexAmpScanner scanner;
+  const auto scan = [&scanner](base::StringPiece page,
+                               std::string* canonical_url) {
+    return ScanWithRegexes(scanner, page, canonical_url);
+  };
+  EXPECT_EQ(kCanonicalUrl, Run("regexes_amp_page", {amp_page_}, scan));
+  Run("regexes_non_amp_pages", non_amp_pages(), scan);
+}
+
+}  // namespace de_amp
@@ -0,0 +1,172 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/de_amp/browser/amp_detector.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/strings/string_piece.h"
+#include "base/threading/thread_restrictions.h"
+#include "brave/components/constants/brave_paths.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace de_amp {
+
+namespace {
+
+// Matches the read size of DeAmpURLLoader.
+constexpr size_t kLoaderChunkSize = 65536;
+
+AmpDetector::Result WriteInChunks(AmpDetector& detector,
+                                  base::StringPiece body,
+                                  size_t chunk_size) {
+  for (size_t offset = 0; offset < body.size(); offset += chunk_size) {
+    if (detector.Write(body.substr(offset, chunk_size)) !=
+        AmpDetector::Result::kNeedMoreData) {
+      break;
+    }
+  }
+  return detector.result();
+}
+
+std::string ReadTestFile(const base::FilePath& path) {
+  std::string contents;
+  EXPECT_TRUE(base::ReadFileToString(path, &contents)) << path;
+  return contents;
+}
+
+base::FilePath GetTestDataDir() {
+  base::FilePath test_data_dir;
+  base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir);
+  return test_data_dir;
+}
+
+}  // namespace
+
+TEST(AmpDetectorTest, ResultDoesNotDependOnChunking) {
+  const std::string body =
+      "<!doctype html>"
+      "<html amp lang=\"en\">"
+      "<head>"
+      "<link rel=\"author\" href=\"https://xyz.com\"/>"
+      "<link rel=\"canonical\" href=\"https://abc.com/story\"/>"
+      "</head>"
+      "<body></body>"
+      "</html>";
+
+  for (size_t chunk_size : {1u, 2u, 5u, 17u, 1024u}) {
+    SCOPED_TRACE(chunk_size);
+    AmpDetector detector;
+    EXPECT_EQ(AmpDetector::Result::kCanonicalUrlFound,
+              WriteInChunks(detector, body, chunk_size));
+    EXPECT_TRUE(detector.is_amp());
+    EXPECT_EQ("https://abc.com/story", detector.canonical_url());
+  }
+}
+
+TEST(AmpDetectorTest, DecidesNotAmpAtHtmlTag) {
+  const std::string html_tag = "<!doctype html>\n<html lang=\"en\">";
+  const std::string body = html_tag + "<head><title>Not AMP</title></head>";
+
+  AmpDetector detector;
+  EXPECT_EQ(AmpDetector::Result::kNotAmp, detector.Write(body));
+  EXPECT_EQ(html_tag.size(), detector.bytes_scanned());
+
+  // Further chunks are ignored.
+  EXPECT_EQ(AmpDetector::Result::kNotAmp,
+            detector.Write("<link rel=canonical href=https://abc.com>"));
+  EXPECT_EQ(html_tag.size(), detector.bytes_scanned());
+}
+
+TEST(AmpDetectorTest, DecidesNotAmpWithoutHtmlTag) {
+  AmpDetector detector;
+  EXPECT_EQ(AmpDetector::Result::kNotAmp,
+            detector.Write("<!doctype html><head amp>"));
+}
+
+TEST(AmpDetectorTest, NeedsMoreDataUntilHtmlTagEnds) {
+  AmpDetector detector;
+  EXPECT_EQ(AmpDetector::Result::kNeedMoreData, detector.Write("<html amp"));
+  EXPECT_FALSE(detector.is_amp());
+  EXPECT_EQ(AmpDetector::Result::kNeedMoreData, detector.Write(">"));
+  EXPECT_TRUE(detector.is_amp());
+}
+
+TEST(AmpDetectorTest, AmpAttributeMustBeTrueOrEmpty) {
+  AmpDetector detector;
+  EXPECT_EQ(AmpDetector::Result::kNotAmp,
+            detector.Write("<html amp=\"false\">"));
+}
+
+TEST(AmpDetectorTest, StopsAtBody) {
+  AmpDetector detector;
+  EXPECT_EQ(
+      AmpDetector::Result::kNoCanonicalUrl,
+      detector.Write("<html amp><head></head><body>"
+                     "<link rel=\"canonical\" href=\"https://abc.com\"/>"));
+}
+
+TEST(AmpDetectorTest, IgnoresCommentsAndRawText) {
+  const std::string body =
+      "<!-- <html> -->"
+      "<html ⚡>"
+      "<head>"
+      "<!-- <link rel=\"canonical\" href=\"https://comment.com\"> -->"
+      "<title><link rel=canonical href=https://title.com></title>"
+      "<script>var s = '<link rel=\"canonical\" href=\"https://js.com\">';"
+      "</script>"
+      "<style>a::after { content: '<link rel=canonical href=x>'; }</style>"
+      "<link rel=\"preconnect canonical\" href=\"https://abc.com\">"
+      "</head>";
+
+  for (size_t chunk_size : {1u, 3u, 1024u}) {
+    SCOPED_TRACE(chunk_size);
+    AmpDetector detector;
+    EXPECT_EQ(AmpDetector::Result::kCanonicalUrlFound,
+              WriteInChunks(detector, body, chunk_size));
+    EXPECT_EQ("https://abc.com", detector.canonical_url());
+  }
+}
+
+// Scans the AMP fixture and a set of real non-AMP news pages the way
+// DeAmpURLLoader reads them.
+TEST(AmpDetectorTest, FixturePages) {
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  const base::FilePath test_data_dir = GetTestDataDir();
+
+  const std::string amp_page =
+      ReadTestFile(test_data_dir.AppendASCII("de_amp/amp_article.html"));
+  ASSERT_FALSE(amp_page.empty());
+  {
+    AmpDetector detector;
+    EXPECT_EQ(AmpDetector::Result::kCanonicalUrlFound,
+              WriteInChunks(detector, amp_page, kLoaderChunkSize));
+    EXPECT_EQ("https://news.example/2023/05/example-story.html",
+              detector.canonical_url());
+  }
+
+  std::vector<std::string> pages;
+  base::FileEnumerator enumerator(
+      test_data_dir.AppendASCII("speedreader/rewriter/pages/news_pages"),
+      false, base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath dir = enumerator.Next(); !dir.empty();
+       dir = enumerator.Next()) {
+    pages.push_back(ReadTestFile(dir.AppendASCII("original.html")));
+  }
+  ASSERT_FALSE(pages.empty());
+
+  for (const auto& page : pages) {
+    AmpDetector detector;
+    WriteInChunks(detector, page, kLoaderChunkSize);
+    EXPECT_FALSE(detector.is_amp());
+  }
+}
+
+}  // namespace de_amp
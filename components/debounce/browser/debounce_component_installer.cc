@@ -10,7 +10,6 @@
 
 #include "base/base_paths.h"
 #include "base/command_line.h"
-#include "base/containers/flat_set.h"
 #include "base/functional/bind.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
@@ -51,10 +50,10 @@ void DebounceComponentInstaller::OnDATFileDataReady(
     LOG(WARNING) << parsed_rules.error();
     return;
   }
-  rules_.clear();
-  host_cache_.clear();
+  // Clear the index first, as it points into |rules_|.
+  rule_index_.clear();
   rules_ = std::move(parsed_rules.value().first);
-  host_cache_ = parsed_rules.value().second;
+  rule_index_ = std::move(parsed_rules.value().second);
   for (Observer& observer : observers_)
     observer.OnRulesReady(this);
 }
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/base64url.h"
+#include "base/containers/flat_set.h"
 #include "base/json/json_reader.h"
 #include "base/strings/escape.h"
 #include "base/strings/stringprintf.h"
@@ -129,7 +130,7 @@ bool DebounceRule::IsSameETLDForDebounce(const GURL& url1, const GURL& url2) {
 
 // static
 base::expected<std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                         base::flat_set<std::string>>,
+                         DebounceRuleIndex>,
                std::string>
 DebounceRule::ParseRules(const std::string& contents) {
   if (contents.empty()) {
@@ -141,23 +142,64 @@ DebounceRule::ParseRules(const std::string& contents) {
   }
   std::vector<std::string> hosts;
   std::vector<std::unique_ptr<DebounceRule>> rules;
+  // The eTLD+1s each rule is indexed under. Rules with an include pattern
+  // that has no such host are left empty and indexed under every host.
+  std::vector<base::flat_set<std::string>> rule_hosts;
   base::JSONValueConverter<DebounceRule> converter;
   for (base::Value& it : root->GetList()) {
     std::unique_ptr<DebounceRule> rule = std::make_unique<DebounceRule>();
     if (!converter.Convert(it, rule.get()))
       continue;
+    if (rule->action_ == kDebounceRegexPath)
+      rule->param_regex_ = CompilePatternRegex(rule->param_);
+    std::vector<std::string> etldp1s;
+    bool matches_any_host = false;
     for (const URLPattern& pattern : rule->include_pattern_set()) {
-      if (!pattern.host().empty()) {
-        const std::string etldp1 =
-            DebounceRule::GetETLDForDebounce(pattern.host());
-        if (!etldp1.empty())
-          hosts.push_back(std::move(etldp1));
+      const std::string etldp1 =
+          pattern.host().empty()
+              ? std::string()
+              : DebounceRule::GetETLDForDebounce(pattern.host());
+      if (etldp1.empty()) {
+        matches_any_host = true;
+        continue;
       }
+      hosts.push_back(etldp1);
+      etldp1s.push_back(etldp1);
     }
+    if (matches_any_host)
+      etldp1s.clear();
+    rule_hosts.emplace_back(std::move(etldp1s));
     rules.push_back(std::move(rule));
   }
+
+  // As before, only URLs on one of |hosts| are considered at all. Each of
+  // them gets the rules that could match it, keeping the order of |rules| so
+  // that the first rule to apply still wins.
+  const base::flat_set<std::string> host_set(std::move(hosts));
+  std::vector<std::vector<const DebounceRule*>> host_rules(host_set.size());
+  for (size_t i = 0; i < rules.size(); ++i) {
+    if (rule_hosts[i].empty()) {
+      for (auto& candidates : host_rules)
+        candidates.push_back(rules[i].get());
+      continue;
+    }
+    for (const std::string& etldp1 : rule_hosts[i]) {
+      const auto host = host_set.find(etldp1);
+      DCHECK(host != host_set.end());
+      const size_t host_index = host - host_set.begin();
+      host_rules[host_index].push_back(rules[i].get());
+    }
+  }
+  std::vector<DebounceRuleIndex::value_type> index;
+  index.reserve(host_set.size());
+  auto candidates = host_rules.begin();
+  for (const std::string& host : host_set)
+    index.emplace_back(host, std::move(*candidates++));
+
   return std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                   base::flat_set<std::string>>(std::move(rules), hosts);
+                   DebounceRuleIndex>(
+      std::move(rules),
+      DebounceRuleIndex(base::sorted_unique, std::move(index)));
 }
 
 bool DebounceRule::CheckPrefForRule(const PrefService* prefs) const {
@@ -177,29 +219,37 @@ bool DebounceRule::CheckPrefForRule(const PrefService* prefs) const {
   return true;
 }
 
-bool DebounceRule::ValidateAndParsePatternRegex(
-    const std::string& pattern,
-    const std::string& path,
-    std::string* parsed_value) const {
+// static
+std::unique_ptr<re2::RE2> DebounceRule::CompilePatternRegex(
+    const std::string& pattern) {
   if (pattern.length() > kMaxLengthRegexPattern) {
     VLOG(1) << "Debounce regex pattern exceeds max length: "
             << kMaxLengthRegexPattern;
-    return false;
+    return nullptr;
   }
   re2::RE2::Options options;
   options.set_max_mem(kMaxMemoryPerRegexPattern);
-  const re2::RE2 pattern_regex(pattern, options);
+  auto pattern_regex = std::make_unique<re2::RE2>(pattern, options);
 
-  if (!pattern_regex.ok()) {
+  if (!pattern_regex->ok()) {
     VLOG(1) << "Debounce rule has param: " << pattern
             << " which is an invalid regex pattern";
-    return false;
+    return nullptr;
   }
-  if (pattern_regex.NumberOfCapturingGroups() < 1) {
+  if (pattern_regex->NumberOfCapturingGroups() < 1) {
     VLOG(1) << "Debounce rule has param: " << pattern
             << " which captures < 1 groups";
-    return false;
+    return nullptr;
   }
+  return pattern_regex;
+}
+
+bool DebounceRule::ValidateAndParsePatternRegex(
+    const std::string& path,
+    std::string* parsed_value) const {
+  if (!param_regex_)
+    return false;
+  const re2::RE2& pattern_regex = *param_regex_;
 
   // Get matching capture groups by applying regex to the path
   size_t number_of_capturing_groups =
@@ -258,7 +308,7 @@ bool DebounceRule::Apply(const GURL& original_url,
     // Important: Apply param regex to ONLY the path of original URL.
     auto path = original_url.path();
 
-    if (!ValidateAndParsePatternRegex(param_, path, &unescaped_value)) {
+    if (!ValidateAndParsePatternRegex(path, &unescaped_value)) {
       VLOG(1) << "Debounce regex parsing failed";
       return false;
     }
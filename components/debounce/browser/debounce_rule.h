@@ -11,7 +11,7 @@
 #include <utility>
 #include <vector>
 
-#include "base/containers/flat_set.h"
+#include "base/containers/flat_map.h"
 #include "base/json/json_value_converter.h"
 #include "base/strings/escape.h"
 #include "base/types/expected.h"
@@ -21,6 +21,10 @@
 
 class GURL;
 
+namespace re2 {
+class RE2;
+}  // namespace re2
+
 namespace debounce {
 
 enum DebounceAction {
@@ -36,6 +40,13 @@ enum DebouncePrependScheme {
   kDebounceSchemePrependHttps
 };
 
+class DebounceRule;
+
+// Maps an eTLD+1 to the rules that may apply to URLs on it, in the order the
+// rules appear in debounce.json.
+using DebounceRuleIndex =
+    base::flat_map<std::string, std::vector<const DebounceRule*>>;
+
 class DebounceRule {
  public:
   DebounceRule();
@@ -49,8 +60,10 @@ class DebounceRule {
                                   DebounceAction* field);
   static bool ParsePrependScheme(base::StringPiece value,
                                  DebouncePrependScheme* field);
+  // Parses debounce.json into rules and an index of them by eTLD+1. The index
+  // points into the returned rules.
   static base::expected<std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                                  base::flat_set<std::string>>,
+                                  DebounceRuleIndex>,
                         std::string>
   ParseRules(const std::string& contents);
   static const std::string GetETLDForDebounce(const std::string& host);
@@ -67,8 +80,9 @@ class DebounceRule {
 
  private:
   bool CheckPrefForRule(const PrefService* prefs) const;
-  bool ValidateAndParsePatternRegex(const std::string& pattern,
-                                    const std::string& path,
+  static std::unique_ptr<re2::RE2> CompilePatternRegex(
+      const std::string& pattern);
+  bool ValidateAndParsePatternRegex(const std::string& path,
                                     std::string* parsed_value) const;
   extensions::URLPatternSet include_pattern_set_;
   extensions::URLPatternSet exclude_pattern_set_;
@@ -76,6 +90,9 @@ class DebounceRule {
   DebouncePrependScheme prepend_scheme_;
   std::string param_;
   std::string pref_;
+  // Compiled from |param_| when the rules are parsed, for regex-path rules.
+  // Null if |param_| is not a valid pattern.
+  std::unique_ptr<re2::RE2> param_regex_;
 };
 
 }  // namespace debounce
@@ -0,0 +1,123 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/components/debounce/browser/debounce_rule.h"
+#include "brave/components/debounce/browser/test/debounce_rule_test_utils.h"
+#include "components/prefs/pref_registry_simple.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+namespace debounce {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "DebounceRules.";
+// Time to parse the rules and build the index, as the component installer
+// does when a new list arrives.
+constexpr char kMetricLoadTime[] = "load_time";
+constexpr char kMetricTimePerUrlLinear[] = "time_per_url_linear";
+constexpr char kMetricTimePerUrlIndexed[] = "time_per_url_indexed";
+
+constexpr size_t kCorpusSize = 20000;
+
+}  // namespace
+
+// Compares walking every rule with using the eTLD+1 index, over the rules
+// used by the debounce browser tests and growing synthetic rule lists.
+class DebounceRulePerfTest : public ::testing::Test {
+ public:
+  DebounceRulePerfTest() {
+    prefs_.registry()->RegisterBooleanPref("brave.de_amp.enabled", true);
+  }
+
+ protected:
+  void Run(const std::string& story,
+           const std::string& contents,
+           const std::vector<GURL>& urls) {
+    const base::ElapsedTimer load_timer;
+    auto parsed = DebounceRule::ParseRules(contents);
+    const base::TimeDelta load_time = load_timer.Elapsed();
+    ASSERT_TRUE(parsed.has_value());
+    const auto& rules = parsed.value().first;
+    const DebounceRuleIndex& index = parsed.value().second;
+
+    GURL final_url;
+    size_t linear_debounced = 0;
+    const base::ElapsedTimer linear_timer;
+    for (const GURL& url : urls) {
+      if (DebounceLinear(rules, index, &prefs_, url, &final_url)) {
+        linear_debounced++;
+      }
+    }
+    const base::TimeDelta linear_time = linear_timer.Elapsed();
+
+    size_t indexed_debounced = 0;
+    const base::ElapsedTimer indexed_timer;
+    for (const GURL& url : urls) {
+      if (DebounceIndexed(index, &prefs_, url, &final_url)) {
+        indexed_debounced++;
+      }
+    }
+    const base::TimeDelta indexed_time = indexed_timer.Elapsed();
+
+    EXPECT_EQ(linear_debounced, indexed_debounced);
+
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+    reporter.RegisterImportantMetric(kMetricLoadTime, "ms");
+    reporter.RegisterImportantMetric(kMetricTimePerUrlLinear, "us");
+    reporter.RegisterImportantMetric(kMetricTimePerUrlIndexed, "us");
+    reporter.AddResult(kMetricLoadTime, load_time);
+    reporter.AddResult(kMetricTimePerUrlLinear, linear_time / urls.size());
+    reporter.AddResult(kMetricTimePerUrlIndexed, indexed_time / urls.size());
+  }
+
+  TestingPrefServiceSimple prefs_;
+};
+
+TEST_F(DebounceRulePerfTest, TestRules) {
+  base::FilePath source_root;
+  ASSERT_TRUE(base::PathService::Get(base::DIR_SOURCE_ROOT, &source_root));
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(
+      source_root.AppendASCII("brave/test/data/debounce-data/1/debounce.json"),
+      &contents));
+
+  const char* test_urls[] = {
+      "http://simple.a.com/?url=https://brave.com/",
+      "http://base64.a.com/?url=aHR0cHM6Ly9icmF2ZS5jb20v",
+      "http://quad.d.com/?url=https://brave.com/",
+      "http://excluded.e.com/?url=https://brave.com/",
+      "http://www.blogspot.com/?url=https://brave.com/",
+      "https://brave.com/?url=https://example.com/",
+  };
+  std::vector<GURL> urls;
+  for (size_t i = 0; i < kCorpusSize; ++i) {
+    urls.emplace_back(test_urls[i % std::size(test_urls)]);
+  }
+
+  Run("test_rules", contents, urls);
+}
+
+TEST_F(DebounceRulePerfTest, SyntheticRules) {
+  for (size_t rule_count : {300u, 3000u, 9000u}) {
+    Run(base::NumberToString(rule_count) + "_rules", MakeRules(rule_count),
+        MakeURLCorpus(rule_count, kCorpusSize));
+  }
+}
+
+}  // namespace debounce
@@ -0,0 +1,103 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/debounce/browser/test/debounce_rule_test_utils.h"
+
+#include "base/strings/stringprintf.h"
+#include "components/prefs/pref_service.h"
+
+namespace debounce {
+
+std::string MakeRules(size_t count) {
+  std::string contents = "[";
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0)
+      contents += ",";
+    switch (i % 3) {
+      case 0:
+        contents += base::StringPrintf(
+            R"json({"include": ["*://*.site%zu.com/click?*"],
+                    "exclude": ["*://*.site%zu.com/click?*&nodebounce=*"],
+                    "action": "redirect", "param": "url"})json",
+            i, i);
+        break;
+      case 1:
+        contents += base::StringPrintf(
+            R"json({"include": ["*://t.site%zu.net/r?*"], "exclude": [],
+                    "action": "base64,redirect", "param": "target"})json",
+            i);
+        break;
+      case 2:
+        contents += base::StringPrintf(
+            R"json({"include": ["*://go.site%zu.org/links/*"], "exclude": [],
+                    "action": "regex-path", "prepend_scheme": "https",
+                    "pref": "brave.de_amp.enabled",
+                    "param": "^/links/[0-9]+/(.*)$"})json",
+            i);
+        break;
+    }
+  }
+  return contents + "]";
+}
+
+std::vector<GURL> MakeURLCorpus(size_t rule_count, size_t size) {
+  std::vector<GURL> urls;
+  urls.reserve(size);
+  for (size_t i = 0; urls.size() < size; ++i) {
+    // A site whose rule has the shape in MakeRules() that this URL needs.
+    const size_t site = (i * 7919) % (rule_count / 3) * 3 + i % 4;
+    switch (i % 4) {
+      case 0:
+        urls.emplace_back(base::StringPrintf(
+            "https://www.site%zu.com/click?url=https://brave.com/%zu", site,
+            i));
+        break;
+      case 1:
+        urls.emplace_back(base::StringPrintf(
+            "https://t.site%zu.net/r?target=aHR0cHM6Ly9icmF2ZS5jb20v", site));
+        break;
+      case 2:
+        urls.emplace_back(base::StringPrintf(
+            "https://go.site%zu.org/links/123/brave.com/%zu", site, i));
+        break;
+      case 3:
+        urls.emplace_back(base::StringPrintf(
+            "https://news.site%zu.com/article/%zu", site, i));
+        break;
+    }
+  }
+  return urls;
+}
+
+bool DebounceLinear(const std::vector<std::unique_ptr<DebounceRule>>& rules,
+                    const DebounceRuleIndex& index,
+                    const PrefService* prefs,
+                    const GURL& url,
+                    GURL* final_url) {
+  if (!index.contains(DebounceRule::GetETLDForDebounce(url.host())))
+    return false;
+  for (const std::unique_ptr<DebounceRule>& rule : rules) {
+    if (rule->Apply(url, final_url, prefs) && url != *final_url)
+      return true;
+  }
+  return false;
+}
+
+bool DebounceIndexed(const DebounceRuleIndex& index,
+                     const PrefService* prefs,
+                     const GURL& url,
+                     GURL* final_url) {
+  const auto candidates =
+      index.find(DebounceRule::GetETLDForDebounce(url.host()));
+  if (candidates == index.end())
+    return false;
+  for (const DebounceRule* rule : candidates->second) {
+    if (rule->Apply(url, final_url, prefs) && url != *final_url)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace debounce
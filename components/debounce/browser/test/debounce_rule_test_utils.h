@@ -0,0 +1,43 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_DEBOUNCE_BROWSER_TEST_DEBOUNCE_RULE_TEST_UTILS_H_
+#define BRAVE_COMPONENTS_DEBOUNCE_BROWSER_TEST_DEBOUNCE_RULE_TEST_UTILS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brave/components/debounce/browser/debounce_rule.h"
+#include "url/gurl.h"
+
+class PrefService;
+
+namespace debounce {
+
+// Rules in the shapes used by debounce.json, spread over |count| sites.
+std::string MakeRules(size_t count);
+
+// Tracking, non-tracking and unrelated URLs for the rules from MakeRules().
+// Three in four of them get debounced.
+std::vector<GURL> MakeURLCorpus(size_t rule_count, size_t size);
+
+// Debounces |url| by walking every rule, as DebounceService used to.
+bool DebounceLinear(const std::vector<std::unique_ptr<DebounceRule>>& rules,
+                    const DebounceRuleIndex& index,
+                    const PrefService* prefs,
+                    const GURL& url,
+                    GURL* final_url);
+
+// Debounces |url| using the candidate rules for its eTLD+1, as
+// DebounceService does.
+bool DebounceIndexed(const DebounceRuleIndex& index,
+                     const PrefService* prefs,
+                     const GURL& url,
+                     GURL* final_url);
+
+}  // namespace debounce
+
+#endif  // BRAVE_COMPONENTS_DEBOUNCE_BROWSER_TEST_DEBOUNCE_RULE_TEST_UTILS_H_
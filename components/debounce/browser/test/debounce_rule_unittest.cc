@@ -4,7 +4,17 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "brave/components/debounce/browser/debounce_rule.h"
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
 #include "base/json/json_reader.h"
+#include "base/path_service.h"
+#include "base/threading/thread_restrictions.h"
+#include "brave/components/constants/brave_paths.h"
+#include "brave/components/debounce/browser/test/debounce_rule_test_utils.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/testing_pref_service.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -445,4 +455,107 @@ TEST(DebounceRuleUnitTest, CatchMultiplePathsForSameInclude) {
   }
 }
 
+TEST(DebounceRuleUnitTest, IndexKeepsRuleOrder) {
+  const std::string contents = R"json(
+
+      [{
+          "include": [
+              "*://a.com/*"
+          ],
+          "exclude": [],
+          "action": "redirect",
+          "param": "url"
+      }, {
+          "include": [
+              "*://*/*"
+          ],
+          "exclude": [],
+          "action": "redirect",
+          "param": "next"
+      }, {
+          "include": [
+              "*://tracker.b.com/*",
+              "*://*.c.com/*"
+          ],
+          "exclude": [],
+          "action": "redirect",
+          "param": "url"
+      }]
+
+      )json";
+  auto parsed = DebounceRule::ParseRules(contents);
+  ASSERT_TRUE(parsed.has_value());
+  const auto& rules = parsed.value().first;
+  const DebounceRuleIndex& index = parsed.value().second;
+  ASSERT_EQ(3u, rules.size());
+
+  // Only hosts named by a rule are indexed, but rules matching any host are
+  // candidates on each of them.
+  ASSERT_EQ(3u, index.size());
+  EXPECT_EQ(std::vector<const DebounceRule*>({rules[0].get(), rules[1].get()}),
+            index.at("a.com"));
+  EXPECT_EQ(std::vector<const DebounceRule*>({rules[1].get(), rules[2].get()}),
+            index.at("b.com"));
+  EXPECT_EQ(std::vector<const DebounceRule*>({rules[1].get(), rules[2].get()}),
+            index.at("c.com"));
+  EXPECT_FALSE(index.contains("d.com"));
+}
+
+// Checks that using the index agrees with walking every rule, over the rules
+// used by the debounce browser tests and growing synthetic rule lists.
+TEST(DebounceRuleUnitTest, IndexedLookupMatchesLinearLookup) {
+  constexpr size_t kCorpusSize = 20000;
+  TestingPrefServiceSimple prefs;
+  prefs.registry()->RegisterBooleanPref("brave.de_amp.enabled", true);
+
+  base::FilePath test_data_dir;
+  base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir);
+  std::string test_rules;
+  {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    ASSERT_TRUE(base::ReadFileToString(
+        test_data_dir.AppendASCII("debounce-data/1/debounce.json"),
+        &test_rules));
+  }
+  const char* test_urls[] = {
+      "http://simple.a.com/?url=https://brave.com/",
+      "http://base64.a.com/?url=aHR0cHM6Ly9icmF2ZS5jb20v",
+      "http://quad.d.com/?url=https://brave.com/",
+      "http://excluded.e.com/?url=https://brave.com/",
+      "http://www.blogspot.com/?url=https://brave.com/",
+      "https://brave.com/?url=https://example.com/",
+  };
+
+  for (size_t rule_count : {0u, 300u, 3000u, 9000u}) {
+    auto parsed = DebounceRule::ParseRules(
+        rule_count ? MakeRules(rule_count) : test_rules);
+    ASSERT_TRUE(parsed.has_value());
+    const auto& rules = parsed.value().first;
+    const DebounceRuleIndex& index = parsed.value().second;
+    std::vector<GURL> urls;
+    if (rule_count) {
+      urls = MakeURLCorpus(rule_count, kCorpusSize);
+    } else {
+      for (size_t i = 0; i < kCorpusSize; ++i)
+        urls.emplace_back(test_urls[i % std::size(test_urls)]);
+    }
+
+    std::vector<GURL> linear_results(urls.size());
+    for (size_t i = 0; i < urls.size(); ++i) {
+      DebounceLinear(rules, index, &prefs, urls[i], &linear_results[i]);
+    }
+
+    size_t debounced = 0;
+    std::vector<GURL> indexed_results(urls.size());
+    for (size_t i = 0; i < urls.size(); ++i) {
+      if (DebounceIndexed(index, &prefs, urls[i], &indexed_results[i]))
+        debounced++;
+    }
+
+    EXPECT_EQ(linear_results, indexed_results);
+    if (rule_count)
+      EXPECT_EQ(kCorpusSize * 3 / 4, debounced);
+  }
+}
+
 }  // namespace debounce
@@ -599,4 +599,50 @@ TEST(JsonParser, ConvertAllNumbersToString) {
   }
 }
 
+TEST(JsonParser, ParseSolanaTokenAccountsByOwner) {
+  auto parse = [](const std::string& json,
+                  json::SolanaTokenAccountsByOwnerResponse& output) {
+    return json::parse_solana_token_accounts_by_owner(
+        rust::Slice<const uint8_t>(
+            reinterpret_cast<const uint8_t*>(json.data()), json.size()),
+        output);
+  };
+
+  json::SolanaTokenAccountsByOwnerResponse output = {};
+  EXPECT_TRUE(parse(R"({"jsonrpc":"2.0","id":1,"result":{
+      "context":{"slot":1},
+      "value":[{"pubkey":"key","account":{
+        "data":["SEVMTE8=","base64"],"executable":true,
+        "lamports":18446744073709551615,"owner":"owner","rentEpoch":2,
+        "space":165}}]}})",
+                    output));
+  EXPECT_FALSE(output.has_error);
+  ASSERT_EQ(output.accounts.size(), 1u);
+  EXPECT_EQ(output.accounts[0].lamports, UINT64_MAX);
+  EXPECT_EQ(std::string(output.accounts[0].owner), "owner");
+  EXPECT_EQ(std::string(output.accounts[0].data), "SEVMTE8=");
+  EXPECT_EQ(std::string(output.accounts[0].data_encoding), "base64");
+  EXPECT_TRUE(output.accounts[0].executable);
+  EXPECT_EQ(output.accounts[0].rent_epoch, 2u);
+
+  output = {};
+  EXPECT_TRUE(parse(R"({"jsonrpc":"2.0","id":1,
+                        "error":{"code":-32601,"message":"no method"}})",
+                    output));
+  EXPECT_TRUE(output.has_error);
+  EXPECT_EQ(output.error_code, -32601);
+  EXPECT_EQ(std::string(output.error_message), "no method");
+
+  for (const std::string& invalid_case :
+       {std::string(R"({"jsonrpc":"2.0","id":1})"),
+        std::string(R"({"jsonrpc":"2.0","id":1,"result":{"value":[{}]}})"),
+        std::string(R"({"jsonrpc":"2.0","id":1,"result":{"value":[
+            {"account":{"data":["","base64"],"executable":false,
+             "lamports":-1,"owner":"o","rentEpoch":1}}]}})"),
+        std::string(R"({"jsonrpc":"2.0","id":1,"result":{"value":[]}}x)")}) {
+    output = {};
+    EXPECT_FALSE(parse(invalid_case, output)) << invalid_case;
+  }
+}
+
 }  // namespace brave_wallet
@@ -1,5 +1,28 @@
+use serde::de::IgnoredAny;
+use serde::Deserialize;
+
 #[cxx::bridge(namespace = json)]
 mod ffi {
+    // A Solana account as found in getAccountInfo and getTokenAccountsByOwner
+    // responses.
+    pub struct SolanaAccount {
+        lamports: u64,
+        owner: String,
+        data: String,
+        data_encoding: String,
+        executable: bool,
+        rent_epoch: u64,
+    }
+
+    pub struct SolanaTokenAccountsByOwnerResponse {
+        accounts: Vec<SolanaAccount>,
+        // Set along with error_code and error_message when the response is a
+        // JSON-RPC error rather than a result.
+        has_error: bool,
+        error_code: i64,
+        error_message: String,
+    }
+
     extern "Rust" {
         fn convert_uint64_value_to_string(path: &str, json: &str, optional: bool) -> String;
         fn convert_int64_value_to_string(path: &str, json: &str, optional: bool) -> String;
@@ -12,6 +35,11 @@ mod ffi {
             json: &str,
         ) -> String;
         fn convert_all_numbers_to_string(json: &str) -> String;
+        fn is_json_rpc_result(json: &[u8]) -> bool;
+        fn parse_solana_token_accounts_by_owner(
+            json: &[u8],
+            output: &mut SolanaTokenAccountsByOwnerResponse,
+        ) -> bool;
     }
 }
 
@@ -275,3 +303,105 @@ pub fn convert_all_numbers_to_string(json: &str) -> String {
         })
         .unwrap_or_else(|_| "".into())
 }
+
+#[derive(Deserialize)]
+struct JsonRpcError {
+    code: i64,
+    message: Option<String>,
+}
+
+#[derive(Deserialize)]
+struct JsonRpcResponse<T> {
+    #[allow(dead_code)]
+    jsonrpc: IgnoredAny,
+    #[allow(dead_code)]
+    id: IgnoredAny,
+    result: Option<T>,
+    error: Option<JsonRpcError>,
+}
+
+#[derive(Deserialize)]
+#[serde(rename_all = "camelCase")]
+struct SolanaAccount {
+    lamports: u64,
+    owner: String,
+    data: (String, String),
+    executable: bool,
+    rent_epoch: u64,
+}
+
+#[derive(Deserialize)]
+struct SolanaKeyedAccount {
+    account: SolanaAccount,
+}
+
+#[derive(Deserialize)]
+struct SolanaTokenAccountsByOwnerResult {
+    value: Vec<SolanaKeyedAccount>,
+}
+
+/// Returns whether `json` is a JSON-RPC response with a result and without
+/// an error.
+///
+/// The result is skipped over as it is read, so this is cheap even for large
+/// responses.
+///
+/// # Arguments
+/// * `json` - The raw response body
+pub fn is_json_rpc_result(json: &[u8]) -> bool {
+    match serde_json::from_slice::<JsonRpcResponse<IgnoredAny>>(json) {
+        Ok(response) => response.result.is_some() && response.error.is_none(),
+        Err(_) => false,
+    }
+}
+
+/// Parses a getTokenAccountsByOwner JSON-RPC response straight into
+/// `output`, without building a tree of the whole response.
+///
+/// Only the fields of `output` are deserialized. Everything else, such as
+/// the context of the result or the pubkey of each account, is skipped
+/// over as it is read. Returns false when `json` is not a well-formed
+/// response, either with the expected result or with an error.
+///
+/// # Arguments
+/// * `json` - The raw response body
+/// * `output` - The accounts of the result, or the error of the response
+pub fn parse_solana_token_accounts_by_owner(
+    json: &[u8],
+    output: &mut ffi::SolanaTokenAccountsByOwnerResponse,
+) -> bool {
+    let response: JsonRpcResponse<SolanaTokenAccountsByOwnerResult> =
+        match serde_json::from_slice(json) {
+            Ok(response) => response,
+            Err(_) => return false,
+        };
+
+    if let Some(error) = response.error {
+        output.has_error = true;
+        output.error_code = error.code;
+        output.error_message = error.message.unwrap_or_default();
+        return true;
+    }
+
+    let result = match response.result {
+        Some(result) => result,
+        None => return false,
+    };
+    output.has_error = false;
+    output.accounts = result
+        .value
+        .into_iter()
+        .map(|keyed_account| {
+            let account = keyed_account.account;
+            ffi::SolanaAccount {
+                lamports: account.lamports,
+                owner: account.owner,
+                data: account.data.0,
+                data_encoding: account.data.1,
+                executable: account.executable,
+                rent_epoch: account.rent_epoch,
+            }
+        })
+        .collect();
+    true
+}
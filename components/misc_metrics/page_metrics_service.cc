@@ -29,6 +29,7 @@ constexpr base::TimeDelta kPagesLoadedReportInterval = base::Minutes(30);
 constexpr base::TimeDelta kDomainsLoadedReportInterval = base::Minutes(30);
 constexpr base::TimeDelta kPagesLoadedInitReportDelay = base::Seconds(30);
 constexpr base::TimeDelta kDomainsLoadedInitReportDelay = base::Seconds(30);
+constexpr base::TimeDelta kPagesLoadedCommitDelay = base::Minutes(1);
 
 }  // namespace
 
@@ -60,11 +61,17 @@ void PageMetricsService::RegisterPrefs(PrefRegistrySimple* registry) {
 
 void PageMetricsService::IncrementPagesLoadedCount() {
   VLOG(2) << "PageMetricsService: increment page load count";
+  GetPagesLoadedStorage()->AddDelta(1);
+}
+
+WeeklyStorage* PageMetricsService::GetPagesLoadedStorage() {
   if (pages_loaded_storage_ == nullptr) {
     pages_loaded_storage_ = std::make_unique<WeeklyStorage>(
         local_state_, kMiscMetricsPagesLoadedCount);
+    // Page loads are frequent, so avoid rewriting local state for each one.
+    pages_loaded_storage_->EnableWriteCoalescing(kPagesLoadedCommitDelay);
   }
-  pages_loaded_storage_->AddDelta(1);
+  return pages_loaded_storage_.get();
 }
 
 void PageMetricsService::ReportDomainsLoaded() {
@@ -81,11 +88,7 @@ void PageMetricsService::ReportDomainsLoaded() {
 void PageMetricsService::ReportPagesLoaded() {
   // Stores a global count in local state to
   // capture page loads across all profiles.
-  if (pages_loaded_storage_ == nullptr) {
-    pages_loaded_storage_ = std::make_unique<WeeklyStorage>(
-        local_state_, kMiscMetricsPagesLoadedCount);
-  }
-  uint64_t count = pages_loaded_storage_->GetPeriodSum();
+  uint64_t count = GetPagesLoadedStorage()->GetPeriodSum();
   p3a_utils::RecordToHistogramBucket(kPagesLoadedHistogramName,
                                      kPagesLoadedBuckets, count);
   VLOG(2) << "PageMetricsService: pages loaded report, count = " << count;
@@ -38,6 +38,8 @@ class PageMetricsService : public KeyedService {
   void IncrementPagesLoadedCount();
 
  private:
+  WeeklyStorage* GetPagesLoadedStorage();
+
   void ReportDomainsLoaded();
   void ReportPagesLoaded();
 
@@ -0,0 +1,73 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/query_filter/utils.h"
+
+namespace query_filter {
+
+namespace {
+
+// Returns the key of |kv_string| if it has both a key and a value. Leading,
+// repeated and trailing '=' are skipped, as splitting on '=' and dropping
+// empty pieces would.
+absl::optional<base::StringPiece> GetKey(base::StringPiece kv_string) {
+  const size_t key_start = kv_string.find_first_not_of('=');
+  if (key_start == base::StringPiece::npos) {
+    return absl::nullopt;
+  }
+  const size_t key_end = kv_string.find('=', key_start);
+  if (key_end == base::StringPiece::npos ||
+      kv_string.find_first_not_of('=', key_end) == base::StringPiece::npos) {
+    return absl::nullopt;
+  }
+  return kv_string.substr(key_start, key_end - key_start);
+}
+
+}  // namespace
+
+absl::optional<std::string> StripQueryParameters(
+    base::StringPiece query,
+    base::FunctionRef<bool(base::StringPiece key)> is_tracker) {
+  // We are using custom query string parsing code here. See
+  // https://github.com/brave/brave-core/pull/13726#discussion_r897712350
+  // for more information on why this approach was selected.
+  //
+  // Walk the query string by ampersands, skip tracking parameters and copy
+  // the remaining query parameters, untouched, into a new query string.
+  absl::optional<std::string> result;
+  size_t kept_count = 0;
+  size_t start = 0;
+  while (start <= query.size()) {
+    size_t end = query.find('&', start);
+    if (end == base::StringPiece::npos) {
+      end = query.size();
+    }
+    const base::StringPiece kv_string = query.substr(start, end - start);
+    const absl::optional<base::StringPiece> key = GetKey(kv_string);
+    if (key && is_tracker(*key)) {
+      if (!result) {
+        // Everything before this parameter is kept as is, without the '&'
+        // that separates it from this one.
+        result.emplace();
+        result->reserve(query.size());
+        if (start > 0) {
+          result->append(query.data(), start - 1);
+        }
+      }
+    } else {
+      if (result) {
+        if (kept_count > 0) {
+          result->push_back('&');
+        }
+        result->append(kv_string.data(), kv_string.size());
+      }
+      ++kept_count;
+    }
+    start = end + 1;
+  }
+  return result;
+}
+
+}  // namespace query_filter
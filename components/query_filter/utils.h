@@ -0,0 +1,27 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_QUERY_FILTER_UTILS_H_
+#define BRAVE_COMPONENTS_QUERY_FILTER_UTILS_H_
+
+#include <string>
+
+#include "base/functional/function_ref.h"
+#include "base/strings/string_piece.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace query_filter {
+
+// Removes the key=value parameters of |query| whose key |is_tracker| returns
+// true for, leaving all other parameters untouched and in order. The query is
+// walked once and only copied if something is removed. Returns absl::nullopt
+// if nothing was removed.
+absl::optional<std::string> StripQueryParameters(
+    base::StringPiece query,
+    base::FunctionRef<bool(base::StringPiece key)> is_tracker);
+
+}  // namespace query_filter
+
+#endif  // BRAVE_COMPONENTS_QUERY_FILTER_UTILS_H_
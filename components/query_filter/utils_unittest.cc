@@ -0,0 +1,41 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/query_filter/utils.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace query_filter {
+
+namespace {
+
+absl::optional<std::string> Strip(base::StringPiece query) {
+  return StripQueryParameters(query, [](base::StringPiece key) {
+    return key == "fbclid" || key == "second";
+  });
+}
+
+}  // namespace
+
+TEST(QueryFilterUtilsTest, StripQueryParameters) {
+  EXPECT_EQ(Strip("fbclid=11&param1=1&second=2"), "param1=1");
+  EXPECT_EQ(Strip("param1=1&fbclid=11"), "param1=1");
+  EXPECT_EQ(Strip("fbclid=11&fbclid2=ok&&param1=1&foo;bar=yes&second=2"),
+            "fbclid2=ok&&param1=1&foo;bar=yes");
+  EXPECT_EQ(Strip("fbclid=11&second=2"), "");
+  EXPECT_EQ(Strip("&fbclid=11&a=1&"), "&a=1&");
+  EXPECT_EQ(Strip("=fbclid=11&a=1"), "a=1");
+  EXPECT_EQ(Strip("fbclid==11&a=1"), "a=1");
+}
+
+TEST(QueryFilterUtilsTest, KeepsParametersWithoutValue) {
+  EXPECT_EQ(Strip("fbclid"), absl::nullopt);
+  EXPECT_EQ(Strip("fbclid="), absl::nullopt);
+  EXPECT_EQ(Strip("fbclid==&=second"), absl::nullopt);
+  EXPECT_EQ(Strip("param1=1"), absl::nullopt);
+  EXPECT_EQ(Strip(""), absl::nullopt);
+}
+
+}  // namespace query_filter
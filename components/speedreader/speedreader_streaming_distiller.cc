@@ -0,0 +1,95 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_streaming_distiller.h"
+
+#include <utility>
+
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/metrics/histogram_macros.h"
+#include "brave/components/speedreader/rust/ffi/speedreader.h"
+
+namespace speedreader {
+
+namespace {
+
+// TODO(brave-browser/issues/10372): would be better to pass explicit signal
+// back from rewriter to indicate if content was found
+constexpr size_t kMinDistilledLength = 1024;
+
+constexpr const char kCollectSwitch[] = "speedreader-collect-test-data";
+
+bool ShouldCollectTestData() {
+#if DCHECK_IS_ON()
+  return base::CommandLine::ForCurrentProcess()->HasSwitch(kCollectSwitch);
+#else
+  return false;
+#endif
+}
+
+void MaybeSaveDistilledDataForDebug(const GURL& url,
+                                    const std::string& data,
+                                    const std::string& stylesheet,
+                                    const std::string& transformed) {
+#if DCHECK_IS_ON()
+  if (!ShouldCollectTestData())
+    return;
+  const auto dir = base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+      kCollectSwitch);
+  base::CreateDirectory(dir);
+  base::WriteFile(dir.AppendASCII("page.url"), url.spec());
+  base::WriteFile(dir.AppendASCII("original.html"), data);
+  base::WriteFile(dir.AppendASCII("distilled.html"), transformed);
+  base::WriteFile(dir.AppendASCII("result.html"), stylesheet + transformed);
+#endif
+}
+
+}  // namespace
+
+StreamingDistiller::StreamingDistiller(std::unique_ptr<Rewriter> rewriter,
+                                       const GURL& url,
+                                       std::string stylesheet)
+    : rewriter_(std::move(rewriter)),
+      url_(url),
+      stylesheet_(std::move(stylesheet)),
+      keep_original_(ShouldCollectTestData()) {
+  DCHECK(rewriter_);
+}
+
+StreamingDistiller::~StreamingDistiller() = default;
+
+void StreamingDistiller::Write(std::string chunk) {
+  if (failed_) {
+    return;
+  }
+
+  if (rewriter_->Write(chunk.data(), chunk.size()) != 0) {
+    failed_ = true;
+    return;
+  }
+  if (keep_original_) {
+    original_ += chunk;
+  }
+}
+
+absl::optional<std::string> StreamingDistiller::End() {
+  // Only the work left once the whole body has arrived is measured, since
+  // that's what delays the page.
+  SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
+  if (failed_) {
+    return absl::nullopt;
+  }
+
+  rewriter_->End();
+  const std::string& transformed = rewriter_->GetOutput();
+  if (transformed.length() < kMinDistilledLength) {
+    return absl::nullopt;
+  }
+  MaybeSaveDistilledDataForDebug(url_, original_, stylesheet_, transformed);
+  return stylesheet_ + transformed;
+}
+
+}  // namespace speedreader
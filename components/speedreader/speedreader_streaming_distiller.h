@@ -0,0 +1,56 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_STREAMING_DISTILLER_H_
+#define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_STREAMING_DISTILLER_H_
+
+#include <memory>
+#include <string>
+
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+class Rewriter;
+
+// Feeds a response body to a |Rewriter| chunk by chunk as it arrives, so that
+// most of the parsing is done by the time the last chunk is received rather
+// than starting only then. Distilling can block for a while, so this is meant
+// to live on a thread pool sequence and be used through base::SequenceBound.
+class StreamingDistiller {
+ public:
+  StreamingDistiller(std::unique_ptr<Rewriter> rewriter,
+                     const GURL& url,
+                     std::string stylesheet);
+  ~StreamingDistiller();
+
+  StreamingDistiller(const StreamingDistiller&) = delete;
+  StreamingDistiller& operator=(const StreamingDistiller&) = delete;
+
+  // Writes the next chunk of the body. Chunks written after the rewriter has
+  // failed are ignored.
+  void Write(std::string chunk);
+
+  // Finishes distilling, returning the stylesheet followed by the distilled
+  // page, or absl::nullopt if the page is not readable and the original body
+  // should be used instead.
+  absl::optional<std::string> End();
+
+ private:
+  std::unique_ptr<Rewriter> rewriter_;
+  const GURL url_;
+  const std::string stylesheet_;
+  bool failed_ = false;
+
+  // Only kept if test data is being collected, see
+  // MaybeSaveDistilledDataForDebug().
+  bool keep_original_ = false;
+  std::string original_;
+};
+
+}  // namespace speedreader
+
+#endif  // BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_STREAMING_DISTILLER_H_
@@ -0,0 +1,189 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_streaming_distiller.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/process/process_metrics.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "SpeedreaderDistill.";
+// Time from the last byte of the body to the first byte of distilled output.
+// Distilled output is only available once the readability pass has seen the
+// whole document, so this is also the time to the whole output.
+constexpr char kMetricTimeToFirstByte[] = "time_to_first_byte";
+// Largest single buffer handed to the rewriter.
+constexpr char kMetricPeakInputBuffer[] = "peak_input_buffer";
+// Largest growth of the malloc heap over the baseline while distilling a page.
+constexpr char kMetricPeakHeapGrowth[] = "peak_heap_growth";
+
+// Matches the loader's read size.
+constexpr size_t kChunkSize = 32768;
+
+constexpr char kUrl[] = "https://test.com";
+constexpr char kStylesheet[] = "<style></style>";
+
+size_t GetMallocUsage() {
+  return base::ProcessMetrics::CreateCurrentProcessMetrics()->GetMallocUsage();
+}
+
+// Tracks the largest rewriter input and heap growth while distilling a page.
+class PeakTracker {
+ public:
+  PeakTracker() : baseline_(GetMallocUsage()) {}
+
+  void OnWrite(size_t size) {
+    peak_input_buffer_ = std::max(peak_input_buffer_, size);
+    Sample();
+  }
+
+  void Sample() {
+    const size_t usage = GetMallocUsage();
+    if (usage > baseline_) {
+      peak_heap_growth_ = std::max(peak_heap_growth_, usage - baseline_);
+    }
+  }
+
+  size_t peak_input_buffer() const { return peak_input_buffer_; }
+  size_t peak_heap_growth() const { return peak_heap_growth_; }
+
+ private:
+  const size_t baseline_;
+  size_t peak_input_buffer_ = 0;
+  size_t peak_heap_growth_ = 0;
+};
+
+struct Results {
+  base::TimeDelta time_to_first_byte;
+  size_t peak_input_buffer = 0;
+  size_t peak_heap_growth = 0;
+
+  void Add(base::TimeDelta page_time_to_first_byte,
+           const PeakTracker& tracker) {
+    time_to_first_byte += page_time_to_first_byte;
+    peak_input_buffer =
+        std::max(peak_input_buffer, tracker.peak_input_buffer());
+    peak_heap_growth = std::max(peak_heap_growth, tracker.peak_heap_growth());
+  }
+};
+
+}  // namespace
+
+// Compares distilling the news fixture pages as they stream in against
+// distilling each whole body after it has been received, which is what the
+// loader used to do.
+class SpeedreaderStreamingDistillerPerfTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    base::FilePath source_root;
+    ASSERT_TRUE(base::PathService::Get(base::DIR_SOURCE_ROOT, &source_root));
+    base::FileEnumerator enumerator(
+        source_root.AppendASCII(
+            "brave/test/data/speedreader/rewriter/pages/news_pages"),
+        false, base::FileEnumerator::DIRECTORIES);
+    base::FilePath domain;
+    while (!(domain = enumerator.Next()).empty()) {
+      std::string body;
+      ASSERT_TRUE(base::ReadFileToString(domain.AppendASCII("original.html"),
+                                         &body));
+      bodies_.push_back(std::move(body));
+    }
+    ASSERT_FALSE(bodies_.empty());
+  }
+
+ protected:
+  std::unique_ptr<Rewriter> MakeRewriter() {
+    auto rewriter = speedreader_.MakeRewriter(kUrl);
+    rewriter->SetMinOutLength(100);
+    return rewriter;
+  }
+
+  // Reports the time to first byte per page, and the peaks over all pages.
+  void Report(const std::string& story, const Results& results) {
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+    reporter.RegisterImportantMetric(kMetricTimeToFirstByte, "ms");
+    reporter.RegisterImportantMetric(kMetricPeakInputBuffer, "bytes");
+    reporter.RegisterImportantMetric(kMetricPeakHeapGrowth, "bytes");
+    reporter.AddResult(kMetricTimeToFirstByte,
+                       results.time_to_first_byte / bodies_.size());
+    reporter.AddResult(kMetricPeakInputBuffer, results.peak_input_buffer);
+    reporter.AddResult(kMetricPeakHeapGrowth, results.peak_heap_growth);
+  }
+
+  std::vector<std::string> bodies_;
+
+ private:
+  SpeedReader speedreader_;
+};
+
+TEST_F(SpeedreaderStreamingDistillerPerfTest, WholeBody) {
+  Results results;
+  for (const std::string& body : bodies_) {
+    PeakTracker tracker;
+    auto rewriter = MakeRewriter();
+
+    // The loader used to hand the rewriter a copy of the buffered body.
+    const base::ElapsedTimer timer;
+    const std::string copy = body;
+    rewriter->Write(copy.data(), copy.size());
+    tracker.OnWrite(copy.size());
+    rewriter->End();
+    const std::string distilled = kStylesheet + rewriter->GetOutput();
+    const base::TimeDelta elapsed = timer.Elapsed();
+    tracker.Sample();
+
+    results.Add(elapsed, tracker);
+  }
+
+  Report("whole_body", results);
+}
+
+TEST_F(SpeedreaderStreamingDistillerPerfTest, Streaming) {
+  Results results;
+  for (const std::string& body : bodies_) {
+    PeakTracker tracker;
+    StreamingDistiller distiller(MakeRewriter(), GURL(kUrl), kStylesheet);
+
+    for (size_t offset = 0; offset < body.size(); offset += kChunkSize) {
+      std::string chunk = body.substr(offset, kChunkSize);
+      const size_t chunk_size = chunk.size();
+      distiller.Write(std::move(chunk));
+      tracker.OnWrite(chunk_size);
+    }
+
+    const base::ElapsedTimer timer;
+    const absl::optional<std::string> distilled = distiller.End();
+    const base::TimeDelta elapsed = timer.Elapsed();
+    tracker.Sample();
+
+    // Each page is distilled or passed through, but the rewriter never holds
+    // more than one chunk of input at once.
+    EXPECT_LE(tracker.peak_input_buffer(), kChunkSize);
+    results.Add(elapsed, tracker);
+  }
+
+  Report("streaming", results);
+}
+
+}  // namespace speedreader
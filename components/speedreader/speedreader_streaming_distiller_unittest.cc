@@ -0,0 +1,107 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_streaming_distiller.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/threading/thread_restrictions.h"
+#include "brave/components/constants/brave_paths.h"
+#include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace speedreader {
+
+namespace {
+
+// Matches the loader's read size.
+constexpr size_t kChunkSize = 32768;
+
+constexpr char kUrl[] = "https://test.com";
+
+}  // namespace
+
+class SpeedreaderStreamingDistillerTest : public ::testing::Test {
+ public:
+  SpeedreaderStreamingDistillerTest() {
+    base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir_);
+    test_data_dir_ = test_data_dir_.AppendASCII("speedreader/rewriter");
+  }
+
+  std::unique_ptr<StreamingDistiller> MakeDistiller() {
+    auto rewriter = speedreader_.MakeRewriter(kUrl);
+    rewriter->SetMinOutLength(100);
+    return std::make_unique<StreamingDistiller>(std::move(rewriter), GURL(kUrl),
+                                                "<style></style>");
+  }
+
+  // Distills |body| the way the loader used to: all at once after the whole
+  // body was received.
+  std::string DistillWholeBody(const std::string& body) {
+    auto rewriter = speedreader_.MakeRewriter(kUrl);
+    rewriter->SetMinOutLength(100);
+    rewriter->Write(body.data(), body.size());
+    rewriter->End();
+    return rewriter->GetOutput();
+  }
+
+  const base::FilePath& test_data_dir() const { return test_data_dir_; }
+
+ private:
+  SpeedReader speedreader_;
+  base::FilePath test_data_dir_;
+};
+
+TEST_F(SpeedreaderStreamingDistillerTest, FallsBackIfNotReadable) {
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  std::string body;
+  ASSERT_TRUE(base::ReadFileToString(
+      test_data_dir().AppendASCII("too_small_output.html"), &body));
+
+  auto distiller = MakeDistiller();
+  distiller->Write(body);
+  EXPECT_FALSE(distiller->End());
+}
+
+// Streams every news page in chunks and checks that the result matches
+// distilling the whole body at once.
+TEST_F(SpeedreaderStreamingDistillerTest, MatchesWholeBodyDistilling) {
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  base::FileEnumerator enumerator(
+      test_data_dir().AppendASCII("pages/news_pages"), false,
+      base::FileEnumerator::DIRECTORIES);
+
+  base::FilePath domain;
+  while (!(domain = enumerator.Next()).empty()) {
+    SCOPED_TRACE(domain.BaseName());
+    std::string body;
+    ASSERT_TRUE(base::ReadFileToString(domain.AppendASCII("original.html"),
+                                       &body));
+
+    const std::string expected = DistillWholeBody(body);
+
+    auto distiller = MakeDistiller();
+    for (size_t offset = 0; offset < body.size(); offset += kChunkSize) {
+      distiller->Write(body.substr(offset, kChunkSize));
+    }
+    const absl::optional<std::string> distilled = distiller->End();
+
+    if (expected.size() < 1024) {
+      EXPECT_FALSE(distilled);
+    } else {
+      ASSERT_TRUE(distilled);
+      EXPECT_EQ("<style></style>" + expected, *distilled);
+    }
+  }
+}
+
+}  // namespace speedreader
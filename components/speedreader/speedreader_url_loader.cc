@@ -10,11 +10,8 @@
 #include <utility>
 
 #include "base/check.h"
-#include "base/command_line.h"
-#include "base/files/file_util.h"
 #include "base/functional/bind.h"
 #include "base/memory/weak_ptr.h"
-#include "base/metrics/histogram_macros.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
 #include "brave/components/body_sniffer/body_sniffer_throttle.h"
@@ -31,24 +28,6 @@ namespace {
 
 constexpr uint32_t kReadBufferSize = 32768;
 
-void MaybeSaveDistilledDataForDebug(const GURL& url,
-                                    const std::string& data,
-                                    const std::string& stylesheet,
-                                    const std::string& transformed) {
-#if DCHECK_IS_ON()
-  constexpr const char kCollectSwitch[] = "speedreader-collect-test-data";
-  if (!base::CommandLine::ForCurrentProcess()->HasSwitch(kCollectSwitch))
-    return;
-  const auto dir = base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
-      kCollectSwitch);
-  base::CreateDirectory(dir);
-  base::WriteFile(dir.AppendASCII("page.url"), url.spec());
-  base::WriteFile(dir.AppendASCII("original.html"), data);
-  base::WriteFile(dir.AppendASCII("distilled.html"), transformed);
-  base::WriteFile(dir.AppendASCII("result.html"), stylesheet + transformed);
-#endif
-}
-
 }  // namespace
 
 // static
@@ -96,91 +75,77 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
       delegate_(delegate),
       response_url_(response_url),
       rewriter_service_(rewriter_service),
-      speedreader_service_(speedreader_service) {}
+      speedreader_service_(speedreader_service) {
+  if (rewriter_service_ && speedreader_service_) {
+    distiller_ = base::SequenceBound<StreamingDistiller>(
+        base::ThreadPool::CreateSequencedTaskRunner(
+            {base::TaskPriority::USER_BLOCKING, base::MayBlock()}),
+        rewriter_service_->MakeRewriter(
+            response_url_, speedreader_service_->GetThemeName(),
+            speedreader_service_->GetFontFamilyName(),
+            speedreader_service_->GetFontSizeName(),
+            speedreader_service_->GetContentStyleName()),
+        response_url_, rewriter_service_->GetContentStylesheet());
+  }
+}
 
 SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
 
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   DCHECK_EQ(State::kLoading, state_);
 
-  if (!BodySnifferURLLoader::CheckBufferedBody(kReadBufferSize)) {
+  base::StringPiece new_data;
+  if (!BodySnifferURLLoader::CheckBufferedBody(kReadBufferSize, &new_data)) {
     return;
   }
 
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
+  // The whole body is still kept in case the page turns out not to be
+  // readable, but distilling proceeds on the distiller's sequence as the body
+  // arrives.
+  if (distiller_) {
+    distiller_.AsyncCall(&StreamingDistiller::Write)
+        .WithArgs(std::string(new_data));
+  }
 
   body_consumer_watcher_.ArmOrNotify();
 }
 
 void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
   DCHECK_EQ(State::kSending, state_);
-  if (bytes_remaining_in_buffer_ > 0) {
+  if (buffered_body_.HasUnsentData()) {
     SendBufferedBodyToClient();
   } else {
     CompleteSending();
   }
 }
 
-void SpeedReaderURLLoader::CompleteLoading(std::string body) {
+void SpeedReaderURLLoader::CompleteLoading(
+    body_sniffer::BodySnifferBuffer body) {
   DCHECK_EQ(State::kLoading, state_);
-  if (!throttle_ || !rewriter_service_) {
+  if (!throttle_ || !distiller_) {
     Abort();
     return;
   }
 
   VLOG(2) << __func__ << " buffered body size = " << body.size();
-  bytes_remaining_in_buffer_ = body.size();
-
-  if (bytes_remaining_in_buffer_ > 0) {
-    // Offload heavy distilling to another thread.
-    base::ThreadPool::PostTaskAndReplyWithResult(
-        FROM_HERE, {base::TaskPriority::USER_BLOCKING, base::MayBlock()},
-        base::BindOnce(
-            [](const GURL& response_url, std::string data,
-               std::unique_ptr<Rewriter> rewriter,
-               const std::string& stylesheet) -> auto{
-              SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
-              int written = rewriter->Write(data.c_str(), data.length());
-              // Error occurred
-              if (written != 0) {
-                return data;
-              }
-
-              rewriter->End();
-              const std::string& transformed = rewriter->GetOutput();
-
-              // TODO(brave-browser/issues/10372): would be better to pass
-              // explicit signal back from rewriter to indicate if content was
-              // found
-              if (transformed.length() < 1024) {
-                return data;
-              }
-              MaybeSaveDistilledDataForDebug(response_url, data, stylesheet,
-                                             transformed);
-              return stylesheet + transformed;
-            },
-            response_url_, std::move(body),
-            rewriter_service_->MakeRewriter(
-                response_url_, speedreader_service_->GetThemeName(),
-                speedreader_service_->GetFontFamilyName(),
-                speedreader_service_->GetFontSizeName(),
-                speedreader_service_->GetContentStyleName()),
-            rewriter_service_->GetContentStylesheet()),
-        base::BindOnce(
-            [](base::WeakPtr<SpeedReaderURLLoader> self, std::string result) {
-              if (self) {
-                self->BodySnifferURLLoader::CompleteLoading(std::move(result));
-              }
-            },
-            weak_factory_.GetWeakPtr()));
+
+  if (!body.empty()) {
+    distiller_.AsyncCall(&StreamingDistiller::End)
+        .Then(base::BindOnce(&SpeedReaderURLLoader::OnDistilled,
+                             weak_factory_.GetWeakPtr(), std::move(body)));
     return;
   }
   BodySnifferURLLoader::CompleteLoading(std::move(body));
 }
 
+void SpeedReaderURLLoader::OnDistilled(body_sniffer::BodySnifferBuffer body,
+                                       absl::optional<std::string> distilled) {
+  distiller_.Reset();
+  BodySnifferURLLoader::CompleteLoading(
+      distilled ? body_sniffer::BodySnifferBuffer(std::move(*distilled))
+                : std::move(body));
+}
+
 void SpeedReaderURLLoader::OnCompleteSending() {
   // TODO(keur, iefremov): This API could probably be improved with an enum
   // indicating distill success, distill fail, load from cache.
@@ -13,10 +13,13 @@
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/task/single_thread_task_runner.h"
+#include "base/threading/sequence_bound.h"
 #include "brave/components/body_sniffer/body_sniffer_url_loader.h"
+#include "brave/components/speedreader/speedreader_streaming_distiller.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 
 namespace body_sniffer {
@@ -41,9 +44,10 @@ class SpeedreaderThrottleDelegate;
 //               finished (= OnComplete() is called). When body is provided, the
 //               state is changed to kLoading. Otherwise the state goes to
 //               kCompleted.
-// kLoading: Receives the body from the source loader and distills the page.
-//            The received body is kept in this loader until distilling
-//            is finished. When all body has been received and distilling is
+// kLoading: Receives the body from the source loader and streams it to the
+//            distiller as it arrives. The received body is also kept in this
+//            loader until distilling is finished, in case the page is not
+//            readable. When all body has been received and distilling is
 //            done, this loader will dispatch queued messages like
 //            OnStartLoadingResponseBody() to the destination
 //            loader client, and then the state is changed to kSending.
@@ -83,7 +87,9 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
   void OnBodyReadable(MojoResult) override;
   void OnBodyWritable(MojoResult) override;
 
-  void CompleteLoading(std::string body) override;
+  void CompleteLoading(body_sniffer::BodySnifferBuffer body) override;
+  void OnDistilled(body_sniffer::BodySnifferBuffer body,
+                   absl::optional<std::string> distilled);
   void OnCompleteSending() override;
   base::WeakPtr<SpeedreaderThrottleDelegate> delegate_;
 
@@ -93,6 +99,9 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
   raw_ptr<SpeedreaderRewriterService> rewriter_service_ = nullptr;
   raw_ptr<SpeedreaderService> speedreader_service_ = nullptr;
 
+  // Receives the body as it is read, and is reset once distilling is done.
+  base::SequenceBound<StreamingDistiller> distiller_;
+
   base::WeakPtrFactory<SpeedReaderURLLoader> weak_factory_{this};
 };
 
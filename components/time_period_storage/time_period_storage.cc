@@ -23,6 +23,7 @@ TimePeriodStorage::TimePeriodStorage(PrefService* prefs,
       pref_name_(pref_name),
       period_days_(period_days) {
   DCHECK(pref_name);
+  daily_values_.reserve(period_days_ + 1);
   if (prefs) {
     Load();
   }
@@ -38,15 +39,33 @@ TimePeriodStorage::TimePeriodStorage(PrefService* prefs,
       period_days_(period_days) {
   DCHECK(prefs);
   DCHECK(pref_name);
+  daily_values_.reserve(period_days_ + 1);
   Load();
 }
 
-TimePeriodStorage::~TimePeriodStorage() = default;
+TimePeriodStorage::~TimePeriodStorage() {
+  CommitPendingWrite();
+}
+
+void TimePeriodStorage::EnableWriteCoalescing(base::TimeDelta commit_delay) {
+  DCHECK(prefs_);
+  coalesce_writes_ = true;
+  commit_delay_ = commit_delay;
+}
+
+void TimePeriodStorage::CommitPendingWrite() {
+  if (!has_pending_write_) {
+    return;
+  }
+  commit_timer_.Stop();
+  has_pending_write_ = false;
+  Save();
+}
 
 void TimePeriodStorage::AddDelta(uint64_t delta) {
   FilterToPeriod();
   daily_values_.front().value += delta;
-  Save();
+  OnValuesChanged();
 }
 
 void TimePeriodStorage::SubDelta(uint64_t delta) {
@@ -59,7 +78,7 @@ void TimePeriodStorage::SubDelta(uint64_t delta) {
     daily_value.value -= day_delta;
     delta -= day_delta;
   }
-  Save();
+  OnValuesChanged();
 }
 
 void TimePeriodStorage::ReplaceTodaysValueIfGreater(uint64_t value) {
@@ -68,14 +87,14 @@ void TimePeriodStorage::ReplaceTodaysValueIfGreater(uint64_t value) {
   if (today.value < value) {
     today.value = value;
   }
-  Save();
+  OnValuesChanged();
 }
 
 void TimePeriodStorage::ReplaceIfGreaterForDate(const base::Time& date,
                                                 uint64_t value) {
   FilterToPeriod();
   base::Time date_mn = date.LocalMidnight();
-  std::list<DailyValue>::iterator day_insert_it = base::ranges::find_if(
+  auto day_insert_it = base::ranges::find_if(
       daily_values_,
       [date_mn](const DailyValue& val) { return val.day <= date_mn; });
   if (day_insert_it != daily_values_.end() && day_insert_it->day == date_mn) {
@@ -85,8 +104,11 @@ void TimePeriodStorage::ReplaceIfGreaterForDate(const base::Time& date,
     }
   } else {
     daily_values_.insert(day_insert_it, {date_mn, value});
+    if (daily_values_.size() > period_days_) {
+      daily_values_.pop_back();
+    }
   }
-  Save();
+  OnValuesChanged();
 }
 
 uint64_t TimePeriodStorage::GetPeriodSumInTimeRange(
@@ -114,23 +136,13 @@ uint64_t TimePeriodStorage::GetPeriodSum() const {
 uint64_t TimePeriodStorage::GetHighestValueInPeriod() const {
   // We record only value for last N days.
   const base::Time n_days_ago = clock_->Now() - base::Days(period_days_);
-  std::list<DailyValue> in_period_daily_values(daily_values_.size());
-  auto copied_it =
-      std::copy_if(daily_values_.begin(), daily_values_.end(),
-                   in_period_daily_values.begin(),
-                   [n_days_ago](auto i) { return i.day > n_days_ago; });
-  in_period_daily_values.resize(
-      std::distance(in_period_daily_values.begin(), copied_it));
-
-  auto highest_it = std::max_element(in_period_daily_values.begin(),
-                                     in_period_daily_values.end(),
-                                     [](const auto& left, const auto& right) {
-                                       return left.value < right.value;
-                                     });
-  if (highest_it == in_period_daily_values.end()) {
-    return 0;
+  uint64_t highest_value = 0;
+  for (const DailyValue& daily_value : daily_values_) {
+    if (daily_value.day > n_days_ago) {
+      highest_value = std::max(highest_value, daily_value.value);
+    }
   }
-  return highest_it->value;
+  return highest_value;
 }
 
 bool TimePeriodStorage::IsOnePeriodPassed() const {
@@ -176,13 +188,25 @@ void TimePeriodStorage::Load() {
   }
 }
 
+void TimePeriodStorage::OnValuesChanged() {
+  if (!coalesce_writes_) {
+    Save();
+    return;
+  }
+
+  has_pending_write_ = true;
+  if (!commit_timer_.IsRunning()) {
+    commit_timer_.Start(FROM_HERE, commit_delay_, this,
+                        &TimePeriodStorage::CommitPendingWrite);
+  }
+}
+
 void TimePeriodStorage::Save() {
   DCHECK(!daily_values_.empty());
   DCHECK_LE(daily_values_.size(), period_days_);
 
   base::Value::List list;
-  // TODO(iefremov): Optimize if needed.
-  list.clear();
+  list.reserve(daily_values_.size());
   for (const auto& u : daily_values_) {
     base::Value::Dict value;
     value.Set("day", u.day.ToDoubleT());
@@ -6,10 +6,11 @@
 #ifndef BRAVE_COMPONENTS_TIME_PERIOD_STORAGE_TIME_PERIOD_STORAGE_H_
 #define BRAVE_COMPONENTS_TIME_PERIOD_STORAGE_TIME_PERIOD_STORAGE_H_
 
-#include <list>
 #include <memory>
 
+#include "base/containers/circular_deque.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 
 namespace base {
 class Clock;
@@ -36,6 +37,13 @@ class TimePeriodStorage {
   TimePeriodStorage(const TimePeriodStorage&) = delete;
   TimePeriodStorage& operator=(const TimePeriodStorage&) = delete;
 
+  // Keeps changes in memory and writes them to prefs at most once per
+  // |commit_delay|, as well as on |CommitPendingWrite| and destruction. Meant
+  // for counters that are updated on every page load or request; |prefs| must
+  // outlive this object.
+  void EnableWriteCoalescing(base::TimeDelta commit_delay);
+  void CommitPendingWrite();
+
   void AddDelta(uint64_t delta);
   void SubDelta(uint64_t delta);
   void ReplaceTodaysValueIfGreater(uint64_t value);
@@ -56,13 +64,22 @@ class TimePeriodStorage {
   };
   void FilterToPeriod();
   void Load();
+  void OnValuesChanged();
   void Save();
 
   PrefService* prefs_ = nullptr;
   const char* pref_name_ = nullptr;
   size_t period_days_;
 
-  std::list<DailyValue> daily_values_;
+  // Most recent day first. Holds at most |period_days_| values, plus one while
+  // a day is being added, so it never grows past the capacity reserved on
+  // construction.
+  base::circular_deque<DailyValue> daily_values_;
+
+  bool coalesce_writes_ = false;
+  base::TimeDelta commit_delay_;
+  bool has_pending_write_ = false;
+  base::OneShotTimer commit_timer_;
 };
 
 #endif  // BRAVE_COMPONENTS_TIME_PERIOD_STORAGE_TIME_PERIOD_STORAGE_H_
@@ -0,0 +1,82 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/time_period_storage/time_period_storage.h"
+
+#include <cstdint>
+#include <string>
+
+#include "base/functional/bind.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/pref_registry_simple.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace {
+
+constexpr char kPrefName[] = "brave.weekly_test";
+
+constexpr char kMetricPrefix[] = "TimePeriodStorage.";
+constexpr char kMetricTimePerEvent[] = "time_per_event";
+constexpr char kMetricPrefWrites[] = "pref_writes";
+
+// About as many counter updates as a heavy browsing session makes in an hour.
+constexpr int kEvents = 100'000;
+
+}  // namespace
+
+class TimePeriodStoragePerfTest : public ::testing::Test {
+ public:
+  TimePeriodStoragePerfTest() {
+    pref_service_.registry()->RegisterListPref(kPrefName);
+    pref_change_registrar_.Init(&pref_service_);
+    pref_change_registrar_.Add(
+        kPrefName, base::BindRepeating(
+                       [](int* pref_writes) { (*pref_writes)++; },
+                       &pref_writes_));
+  }
+
+ protected:
+  // Adds |kEvents| deltas to a weekly counter and reports the time taken per
+  // event, including the final commit, and the number of pref writes.
+  void RunAddDelta(const std::string& story, bool coalesce_writes) {
+    TimePeriodStorage state(&pref_service_, kPrefName, 7);
+    if (coalesce_writes) {
+      state.EnableWriteCoalescing(base::Seconds(30));
+    }
+
+    const base::ElapsedTimer timer;
+    for (int i = 0; i < kEvents; i++) {
+      state.AddDelta(1);
+    }
+    state.CommitPendingWrite();
+    const base::TimeDelta elapsed = timer.Elapsed();
+
+    EXPECT_EQ(static_cast<uint64_t>(kEvents), state.GetPeriodSum());
+
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+    reporter.RegisterImportantMetric(kMetricTimePerEvent, "us");
+    reporter.RegisterImportantMetric(kMetricPrefWrites, "count");
+    reporter.AddResult(kMetricTimePerEvent, elapsed / kEvents);
+    reporter.AddResult(kMetricPrefWrites, static_cast<size_t>(pref_writes_));
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  TestingPrefServiceSimple pref_service_;
+  PrefChangeRegistrar pref_change_registrar_;
+  int pref_writes_ = 0;
+};
+
+TEST_F(TimePeriodStoragePerfTest, AddDelta) {
+  RunAddDelta("write_through", /*coalesce_writes=*/false);
+}
+
+TEST_F(TimePeriodStoragePerfTest, AddDeltaWithWriteCoalescing) {
+  RunAddDelta("coalesced", /*coalesce_writes=*/true);
+}
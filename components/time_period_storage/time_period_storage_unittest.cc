@@ -8,14 +8,18 @@
 #include <memory>
 #include <utility>
 
+#include "base/functional/bind.h"
 #include "base/memory/raw_ptr.h"
 #include "base/test/simple_test_clock.h"
+#include "base/test/task_environment.h"
 #include "base/time/time.h"
+#include "components/prefs/pref_change_registrar.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/testing_pref_service.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 constexpr char kPrefName[] = "brave.weekly_test";
+constexpr base::TimeDelta kCommitDelay = base::Seconds(30);
 
 class TimePeriodStorageTest : public ::testing::Test {
  public:
@@ -31,6 +35,8 @@ class TimePeriodStorageTest : public ::testing::Test {
   }
 
  protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
   raw_ptr<base::SimpleTestClock> clock_ = nullptr;
   TestingPrefServiceSimple pref_service_;
   std::unique_ptr<TimePeriodStorage> state_;
@@ -284,3 +290,86 @@ TEST_F(TimePeriodStorageTest, ReplaceIfGreaterForDate) {
   state_->ReplaceIfGreaterForDate(clock_->Now() - base::Days(31), 10);
   EXPECT_EQ(state_->GetPeriodSum(), 11U);
 }
+
+TEST_F(TimePeriodStorageTest, CoalescesWrites) {
+  InitStorage(7);
+  state_->EnableWriteCoalescing(kCommitDelay);
+
+  state_->AddDelta(1000);
+  state_->AddDelta(2000);
+  state_->SubDelta(500);
+  EXPECT_EQ(state_->GetPeriodSum(), 2500U);
+  EXPECT_TRUE(pref_service_.GetList(kPrefName).empty());
+
+  task_environment_.FastForwardBy(kCommitDelay);
+  EXPECT_EQ(pref_service_.GetList(kPrefName).size(), 1U);
+
+  state_->AddDelta(500);
+  EXPECT_EQ(state_->GetPeriodSum(), 3000U);
+  state_->CommitPendingWrite();
+
+  auto clock = std::make_unique<base::SimpleTestClock>();
+  clock->SetNow(clock_->Now());
+  TimePeriodStorage loaded_state(&pref_service_, kPrefName, 7,
+                                 std::move(clock));
+  EXPECT_EQ(loaded_state.GetPeriodSum(), 3000U);
+}
+
+TEST_F(TimePeriodStorageTest, CommitsPendingWriteOnDestruction) {
+  {
+    auto clock = std::make_unique<base::SimpleTestClock>();
+    clock->SetNow(clock_->Now());
+    TimePeriodStorage state(&pref_service_, kPrefName, 7, std::move(clock));
+    state.EnableWriteCoalescing(kCommitDelay);
+    state.AddDelta(1000);
+  }
+
+  auto clock = std::make_unique<base::SimpleTestClock>();
+  clock->SetNow(clock_->Now());
+  TimePeriodStorage loaded_state(&pref_service_, kPrefName, 7,
+                                 std::move(clock));
+  EXPECT_EQ(loaded_state.GetPeriodSum(), 1000U);
+}
+
+// Simulates heavy browsing, with a counter updated every 10ms for ten minutes,
+// and checks how many pref writes that causes with and without write
+// coalescing.
+TEST_F(TimePeriodStorageTest, CoalescingLimitsPrefWrites) {
+  constexpr base::TimeDelta kEventInterval = base::Milliseconds(10);
+  constexpr int kMinutes = 10;
+  constexpr int kEvents = kMinutes * (base::Minutes(1) / kEventInterval);
+
+  int pref_writes = 0;
+  PrefChangeRegistrar pref_change_registrar;
+  pref_change_registrar.Init(&pref_service_);
+  pref_change_registrar.Add(
+      kPrefName,
+      base::BindRepeating([](int* pref_writes) { (*pref_writes)++; },
+                          &pref_writes));
+
+  for (const bool coalesce_writes : {false, true}) {
+    pref_service_.ClearPref(kPrefName);
+    pref_writes = 0;
+    auto clock = std::make_unique<base::SimpleTestClock>();
+    clock->SetNow(base::Time::Now());
+    base::SimpleTestClock* const test_clock = clock.get();
+    TimePeriodStorage state(&pref_service_, kPrefName, 7, std::move(clock));
+    if (coalesce_writes) {
+      state.EnableWriteCoalescing(kCommitDelay);
+    }
+
+    for (int i = 0; i < kEvents; i++) {
+      state.AddDelta(1);
+      test_clock->Advance(kEventInterval);
+      task_environment_.FastForwardBy(kEventInterval);
+    }
+    state.CommitPendingWrite();
+
+    EXPECT_EQ(state.GetPeriodSum(), static_cast<uint64_t>(kEvents));
+    if (coalesce_writes) {
+      EXPECT_LE(pref_writes, kMinutes * (base::Minutes(1) / kCommitDelay) + 1);
+    } else {
+      EXPECT_EQ(pref_writes, kEvents);
+    }
+  }
+}
@@ -6,14 +6,16 @@
 #include "brave/components/url_sanitizer/browser/url_sanitizer_service.h"
 
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "base/containers/contains.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
-#include "base/strings/string_split.h"
-#include "base/strings/string_util.h"
+#include "base/ranges/algorithm.h"
 #include "base/task/thread_pool.h"
 #include "base/values.h"
+#include "brave/components/query_filter/utils.h"
 #include "extensions/common/url_pattern.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
@@ -111,67 +113,113 @@ void URLSanitizerService::Initialize(const std::string& json) {
 
 void URLSanitizerService::UpdateMatchers(
     base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> mappings) {
+  host_index_.clear();
+  any_host_matchers_.clear();
   matchers_ = std::move(mappings);
+
+  std::vector<std::pair<std::string, const MatchItem*>> host_matchers;
+  for (const auto& matcher : matchers_) {
+    if (base::ranges::any_of(matcher->include, [](const URLPattern& pattern) {
+          return pattern.host().empty();
+        })) {
+      any_host_matchers_.push_back(matcher.get());
+      continue;
+    }
+    for (const URLPattern& pattern : matcher->include) {
+      host_matchers.emplace_back(pattern.host(), matcher.get());
+    }
+  }
+  base::ranges::sort(host_matchers);
+  host_matchers.erase(base::ranges::unique(host_matchers),
+                      host_matchers.end());
+  std::vector<std::pair<std::string, std::vector<const MatchItem*>>> index;
+  for (auto& [host, matcher] : host_matchers) {
+    if (index.empty() || index.back().first != host) {
+      index.emplace_back(std::move(host), std::vector<const MatchItem*>());
+    }
+    index.back().second.push_back(matcher);
+  }
+  host_index_ = base::flat_map<std::string, std::vector<const MatchItem*>>(
+      base::sorted_unique, std::move(index));
+
   if (initialization_callback_for_testing_)
     std::move(initialization_callback_for_testing_).Run();
 }
 
+std::vector<const URLSanitizerService::MatchItem*>
+URLSanitizerService::GetCandidateMatchers(const GURL& url) const {
+  std::vector<const MatchItem*> candidates = any_host_matchers_;
+  // Patterns may match subdomains of their host, so look up the URL's host
+  // and each of its parent domains.
+  base::StringPiece host = url.host_piece();
+  while (!host.empty()) {
+    const auto it = host_index_.find(host);
+    if (it != host_index_.end()) {
+      for (const MatchItem* matcher : it->second) {
+        if (!base::Contains(candidates, matcher)) {
+          candidates.push_back(matcher);
+        }
+      }
+    }
+    const size_t dot = host.find('.');
+    host = dot == base::StringPiece::npos ? base::StringPiece()
+                                          : host.substr(dot + 1);
+  }
+  return candidates;
+}
+
 GURL URLSanitizerService::SanitizeURL(const GURL& initial_url) {
-  if (matchers_.empty() || !initial_url.SchemeIsHTTPOrHTTPS())
+  if (matchers_.empty() || !initial_url.SchemeIsHTTPOrHTTPS() ||
+      !initial_url.has_query())
     return initial_url;
-  GURL url = initial_url;
-  for (const auto& it : matchers_) {
-    if (!it->include.MatchesURL(url) || it->exclude.MatchesURL(url))
+
+  // Gather the parameters of every matching rule, then rewrite the query
+  // once.
+  std::vector<const base::flat_set<std::string>*> params;
+  for (const MatchItem* matcher : GetCandidateMatchers(initial_url)) {
+    if (!matcher->include.MatchesURL(initial_url) ||
+        matcher->exclude.MatchesURL(initial_url))
       continue;
-    auto sanitized_query = StripQueryParameter(url.query(), it->params);
-    GURL::Replacements replacements;
-    if (!sanitized_query.empty()) {
-      replacements.SetQueryStr(sanitized_query);
-    } else {
-      replacements.ClearQuery();
-    }
-    url = url.ReplaceComponents(replacements);
+    params.push_back(&matcher->params);
+  }
+  if (params.empty())
+    return initial_url;
+
+  const auto sanitized_query = query_filter::StripQueryParameters(
+      initial_url.query_piece(), [&params](base::StringPiece key) {
+        for (const auto* matcher_params : params) {
+          if (matcher_params->contains(key))
+            return true;
+        }
+        return false;
+      });
+  if (!sanitized_query)
+    return initial_url;
+
+  GURL::Replacements replacements;
+  if (!sanitized_query->empty()) {
+    replacements.SetQueryStr(*sanitized_query);
+  } else {
+    replacements.ClearQuery();
   }
-  return url;
+  return initial_url.ReplaceComponents(replacements);
 }
 
 void URLSanitizerService::OnRulesReady(const std::string& json_content) {
   Initialize(json_content);
 }
 
-// FIXME: merge with
-// browser/net/brave_site_hacks_network_delegate_helper.cc::StripQueryParameter()
 // Remove tracking query parameters from a GURL, leaving all
 // other parts untouched.
 std::string URLSanitizerService::StripQueryParameter(
     const std::string& query,
     const base::flat_set<std::string>& trackers) {
-  // We are using custom query string parsing code here. See
-  // https://github.com/brave/brave-core/pull/13726#discussion_r897712350
-  // for more information on why this approach was selected.
-  //
-  // Split query string by ampersands, remove tracking parameters,
-  // then join the remaining query parameters, untouched, back into
-  // a single query string.
-  const std::vector<std::string> input_kv_strings =
-      SplitString(query, "&", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
-  std::vector<std::string> output_kv_strings;
-  int disallowed_count = 0;
-  for (const std::string& kv_string : input_kv_strings) {
-    const std::vector<std::string> pieces = SplitString(
-        kv_string, "=", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-    const std::string& key = pieces.empty() ? std::string() : pieces[0];
-    if (pieces.size() >= 2 && trackers.count(key) == 1) {
-      ++disallowed_count;
-    } else {
-      output_kv_strings.push_back(kv_string);
-    }
-  }
-  if (disallowed_count > 0) {
-    return base::JoinString(output_kv_strings, "&");
-  } else {
-    return query;
-  }
+  return query_filter::StripQueryParameters(
+             query,
+             [&trackers](base::StringPiece key) {
+               return trackers.contains(key);
+             })
+      .value_or(query);
 }
 
 }  // namespace brave
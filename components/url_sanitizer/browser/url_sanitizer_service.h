@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
@@ -59,7 +60,14 @@ class URLSanitizerService : public KeyedService,
                                   const base::flat_set<std::string>& trackers);
 
  private:
+  // Returns the matchers whose include patterns may match |url|.
+  std::vector<const MatchItem*> GetCandidateMatchers(const GURL& url) const;
+
   base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> matchers_;
+  // |matchers_| keyed by the hosts of their include patterns. Matchers with a
+  // pattern for any host are kept in |any_host_matchers_| instead.
+  base::flat_map<std::string, std::vector<const MatchItem*>> host_index_;
+  std::vector<const MatchItem*> any_host_matchers_;
   base::OnceClosure initialization_callback_for_testing_;
   base::WeakPtrFactory<URLSanitizerService> weak_factory_{this};
 };
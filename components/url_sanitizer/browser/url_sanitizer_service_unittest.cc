@@ -154,4 +154,22 @@ TEST_F(URLSanitizerServiceUnitTest, ClearURLS) {
             GURL("ws://localhost:8080/?utm_source=web"));
 }
 
+TEST_F(URLSanitizerServiceUnitTest, OnlyMatchingHostsAreSanitized) {
+  WaitInitialization(kTestPatterns);
+
+  // Parameters of every rule that matches are removed in one go.
+  EXPECT_EQ(SanitizeURL(GURL("https://mobile.twitter.com/"
+                             "?t=1&utm_content=2&brave_testing1=3")),
+            GURL("https://mobile.twitter.com/?brave_testing1=3"));
+  EXPECT_EQ(SanitizeURL(GURL("https://dev-pages.bravesoftware.com/clean-urls/"
+                             "?t=1&utm_content=2&brave_testing1=3")),
+            GURL("https://dev-pages.bravesoftware.com/clean-urls/?t=1"));
+  // Rules are not applied to other hosts that share a suffix.
+  EXPECT_EQ(SanitizeURL(GURL("https://nottwitter.com/?t=1&utm_content=2")),
+            GURL("https://nottwitter.com/?t=1"));
+  EXPECT_EQ(SanitizeURL(GURL("https://bravesoftware.com/clean-urls/"
+                             "?brave_testing1=3")),
+            GURL("https://bravesoftware.com/clean-urls/?brave_testing1=3"));
+}
+
 }  // namespace brave
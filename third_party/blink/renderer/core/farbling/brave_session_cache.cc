@@ -35,6 +35,7 @@
 #include "third_party/blink/renderer/platform/wtf/casting.h"
 #include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
 #include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/boringssl/src/include/openssl/siphash.h"
 #include "url/url_constants.h"
 
 namespace {
@@ -53,6 +54,12 @@ namespace brave {
 const char kBraveSessionToken[] = "brave_session_token";
 const char BraveSessionCache::kSupplementName[] = "BraveSessionCache";
 const int kFarbledUserAgentMaxExtraSpaces = 5;
+// Canvases with at least this many bytes of pixels are keyed by a fast digest
+// of their contents when kBraveFastCanvasFarbling is enabled. Smaller ones,
+// which covers typical fingerprinting canvases, are keyed as before.
+const size_t kFastCanvasKeyMinBytes = 256 * 256 * 4;
+// Signed with the domain key to derive the key for content digests.
+const char kContentDigestKeyLabel[] = "content-digest";
 
 // acceptable letters for generating random strings
 const char kLettersForRandomStrings[] =
@@ -195,6 +202,11 @@ BraveSessionCache::BraveSessionCache(ExecutionContext& context)
   CHECK(h.Init(reinterpret_cast<const unsigned char*>(&session_key_),
                sizeof session_key_));
   CHECK(h.Sign(domain, domain_key_, sizeof domain_key_));
+  crypto::HMAC digest_hmac(crypto::HMAC::SHA256);
+  CHECK(digest_hmac.Init(domain_key_, sizeof domain_key_));
+  CHECK(digest_hmac.Sign(kContentDigestKeyLabel,
+                         reinterpret_cast<unsigned char*>(digest_key_),
+                         sizeof digest_key_));
   const uint64_t* fudge = reinterpret_cast<const uint64_t*>(domain_key_);
   double fudge_factor = 0.99 + ((*fudge / maxUInt64AsDouble) / 100);
   uint64_t seed = *reinterpret_cast<uint64_t*>(domain_key_);
@@ -229,6 +241,45 @@ void BraveSessionCache::FarbleAudioChannel(float* dst, size_t count) {
     audio_farbling_helper_->FarbleAudioChannel(dst, count);
 }
 
+void BraveSessionCache::FarbleAudioBufferChannel(
+    blink::DOMFloat32Array* channel) {
+  if (!audio_farbling_helper_ || !channel || channel->length() == 0) {
+    return;
+  }
+  // Farbling again would compound the fudge factor on every read, but the
+  // channel may have been written since (by script, or by the audio graph for
+  // buffers it reuses), in which case the new samples need farbling.
+  if (IsFarbledAudioChannel(*channel)) {
+    return;
+  }
+  audio_farbling_helper_->FarbleAudioChannel(channel->Data(),
+                                             channel->length());
+  farbled_audio_channels_.Set(channel, AudioChannelDigest(*channel));
+}
+
+void BraveSessionCache::FarbleAudioBufferChannelCopy(
+    blink::DOMFloat32Array* channel,
+    float* dst,
+    size_t count) {
+  if (channel && IsFarbledAudioChannel(*channel)) {
+    return;
+  }
+  FarbleAudioChannel(dst, count);
+}
+
+bool BraveSessionCache::IsFarbledAudioChannel(
+    blink::DOMFloat32Array& channel) const {
+  auto it = farbled_audio_channels_.find(&channel);
+  return it != farbled_audio_channels_.end() &&
+         it->value == AudioChannelDigest(channel);
+}
+
+uint64_t BraveSessionCache::AudioChannelDigest(
+    const blink::DOMFloat32Array& channel) const {
+  return SIPHASH_24(digest_key_, static_cast<const uint8_t*>(channel.Data()),
+                    channel.ByteLength());
+}
+
 void BraveSessionCache::PerturbPixels(const unsigned char* data, size_t size) {
   if (!farbling_enabled_ || farbling_level_ == BraveFarblingLevel::OFF)
     return;
@@ -255,8 +306,22 @@ void BraveSessionCache::PerturbPixelsInternal(const unsigned char* data,
   CHECK(h.Init(reinterpret_cast<const unsigned char*>(&session_plus_domain_key),
                sizeof session_plus_domain_key));
   uint8_t canvas_key[32];
-  CHECK(h.Sign(base::StringPiece(reinterpret_cast<const char*>(pixels), size),
-               canvas_key, sizeof canvas_key));
+  if (size >= kFastCanvasKeyMinBytes &&
+      base::FeatureList::IsEnabled(
+          blink::features::kBraveFastCanvasFarbling)) {
+    // Running SHA-256 over every pixel dominates the cost of reading back
+    // large canvases. The perturbation only needs to depend on the contents,
+    // so sign a SipHash digest of them instead. SipHash is keyed with a key
+    // derived from the domain key, so pages can't predict or deliberately
+    // collide digests.
+    const uint64_t digest[2] = {SIPHASH_24(digest_key_, pixels, size), size};
+    CHECK(h.Sign(base::StringPiece(reinterpret_cast<const char*>(digest),
+                                   sizeof digest),
+                 canvas_key, sizeof canvas_key));
+  } else {
+    CHECK(h.Sign(base::StringPiece(reinterpret_cast<const char*>(pixels), size),
+                 canvas_key, sizeof canvas_key));
+  }
   uint64_t v = *reinterpret_cast<uint64_t*>(canvas_key);
   uint64_t pixel_index;
   // choose which channel (R, G, or B) to perturb
@@ -278,6 +343,11 @@ void BraveSessionCache::PerturbPixelsInternal(const unsigned char* data,
   }
 }
 
+void BraveSessionCache::Trace(blink::Visitor* visitor) const {
+  visitor->Trace(farbled_audio_channels_);
+  Supplement<ExecutionContext>::Trace(visitor);
+}
+
 WTF::String BraveSessionCache::GenerateRandomString(std::string seed,
                                                     wtf_size_t length) {
   uint8_t key[32];
@@ -15,6 +15,8 @@
 #include "third_party/blink/renderer/core/core_export.h"
 #include "third_party/blink/renderer/core/execution_context/execution_context.h"
 #include "third_party/blink/renderer/core/frame/dom_window.h"
+#include "third_party/blink/renderer/core/typed_arrays/dom_typed_array.h"
+#include "third_party/blink/renderer/platform/heap/collection_support/heap_hash_map.h"
 #include "third_party/blink/renderer/platform/wtf/hash_map.h"
 #include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
 
@@ -76,6 +78,15 @@ class CORE_EXPORT BraveSessionCache final
 
   BraveFarblingLevel GetBraveFarblingLevel() { return farbling_level_; }
   void FarbleAudioChannel(float* dst, size_t count);
+  // Farbles a channel of an AudioBuffer in place. A channel is farbled again
+  // only if its samples have changed since it was last farbled, however many
+  // times its data is read.
+  void FarbleAudioBufferChannel(blink::DOMFloat32Array* channel);
+  // Farbles |count| samples copied from |channel| into |dst|, unless the
+  // channel itself has already been farbled in place and not written since.
+  void FarbleAudioBufferChannelCopy(blink::DOMFloat32Array* channel,
+                                    float* dst,
+                                    size_t count);
   void PerturbPixels(const unsigned char* data, size_t size);
   WTF::String GenerateRandomString(std::string seed, wtf_size_t length);
   WTF::String FarbledUserAgent(WTF::String real_user_agent);
@@ -90,15 +101,27 @@ class CORE_EXPORT BraveSessionCache final
     return audio_farbling_helper_;
   }
 
+  void Trace(blink::Visitor* visitor) const override;
+
  private:
   bool farbling_enabled_;
   uint64_t session_key_;
   uint8_t domain_key_[32];
+  // Key for SipHash digests of page content. It is derived from
+  // |domain_key_| rather than taken from it, since all of |domain_key_| is
+  // used elsewhere, e.g. as the HMAC key in GenerateRandomString().
+  uint64_t digest_key_[2];
   WTF::HashMap<FarbleKey, int> farbled_integers_;
   BraveFarblingLevel farbling_level_;
   absl::optional<blink::BraveAudioFarblingHelper> audio_farbling_helper_;
+  // AudioBuffer channels that have been farbled in place, mapped to a digest
+  // of their samples right after farbling.
+  blink::HeapHashMap<blink::WeakMember<blink::DOMFloat32Array>, uint64_t>
+      farbled_audio_channels_;
 
   void PerturbPixelsInternal(const unsigned char* data, size_t size);
+  bool IsFarbledAudioChannel(blink::DOMFloat32Array& channel) const;
+  uint64_t AudioChannelDigest(const blink::DOMFloat32Array& channel) const;
 };
 
 }  // namespace brave
@@ -7,6 +7,8 @@
 
 #include <limits.h>
 
+#include <algorithm>
+
 #include "third_party/blink/renderer/platform/audio/audio_utilities.h"
 
 namespace blink {
@@ -15,10 +17,29 @@ namespace {
 constexpr uint64_t zero = 0;
 constexpr double maxUInt64AsDouble = static_cast<double>(UINT64_MAX);
 
+// The feedback ORs into the top bits rather than XORing, so the sequence is
+// not linear over GF(2) and can't be jumped ahead; it has to be stepped.
 inline uint64_t lfsr_next(uint64_t v) {
   return ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
 }
 
+// Fills |dst| with the maximum farbling noise stream for |seed|.
+void FillLfsrNoise(uint64_t seed, float* dst, size_t count) {
+  uint64_t v = seed;
+  for (size_t i = 0; i < count; i++) {
+    v = lfsr_next(v);
+    dst[i] = (v / maxUInt64AsDouble) / 10;
+  }
+}
+
+// Multiplies |count| samples by |scale|. The product is computed in double
+// precision so farbled samples stay bit-identical to earlier releases.
+void ScaleSamples(const float* src, float* dst, size_t count, double scale) {
+  for (size_t i = 0; i < count; i++) {
+    dst[i] = src[i] * scale;
+  }
+}
+
 }  // namespace
 
 BraveAudioFarblingHelper::BraveAudioFarblingHelper(double fudge_factor,
@@ -31,15 +52,9 @@ BraveAudioFarblingHelper::~BraveAudioFarblingHelper() = default;
 void BraveAudioFarblingHelper::FarbleAudioChannel(float* dst,
                                                   size_t count) const {
   if (max_) {
-    uint64_t v = seed_;
-    for (size_t i = 0; i < count; i++) {
-      v = lfsr_next(v);
-      dst[i] = (v / maxUInt64AsDouble) / 10;
-    }
+    FillLfsrNoise(seed_, dst, count);
   } else {
-    for (size_t i = 0; i < count; i++) {
-      dst[i] = dst[i] * fudge_factor_;
-    }
+    ScaleSamples(dst, dst, count, fudge_factor_);
   }
 }
 
@@ -52,21 +67,21 @@ void BraveAudioFarblingHelper::FarbleFloatTimeDomainData(
     unsigned fft_size,
     unsigned input_buffer_size) const {
   if (max_) {
-    uint64_t v = seed_;
-    for (size_t i = 0; i < len; ++i) {
-      v = lfsr_next(v);
-      float value = (v / maxUInt64AsDouble) / 10;
-      destination[i] = value;
-    }
+    FillLfsrNoise(seed_, destination, len);
   } else {
-    for (size_t i = 0; i < len; ++i) {
-      // Buffer access is protected due to modulo operation.
-      float value =
-          fudge_factor_ *
-          input_buffer[(i + write_index - fft_size + input_buffer_size) %
-                       input_buffer_size];
-
-      destination[i] = value;
+    // The last |fft_size| samples of the circular input buffer, which wrap
+    // around its end at most once as fft_size <= input_buffer_size. Scaling
+    // each contiguous run avoids a modulo per sample.
+    size_t read_index =
+        (write_index + input_buffer_size - fft_size) % input_buffer_size;
+    size_t written = 0;
+    while (written < len) {
+      const size_t run =
+          std::min(len - written, input_buffer_size - read_index);
+      ScaleSamples(input_buffer + read_index, destination + written, run,
+                   fudge_factor_);
+      written += run;
+      read_index = 0;
     }
   }
 }